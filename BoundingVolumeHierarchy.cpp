@@ -0,0 +1,563 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <thread>
+
+#include "BoundingVolumeHierarchy.hpp"
+
+Aabb Aabb::fromCenter(const glm::vec3& center, const glm::vec3& half_extent)
+{
+  return Aabb{center - half_extent, center + half_extent};
+}
+
+void Aabb::grow(const glm::vec3& point)
+{
+  min_corner = glm::min(min_corner, point);
+  max_corner = glm::max(max_corner, point);
+}
+
+void Aabb::grow(const Aabb& box)
+{
+  min_corner = glm::min(min_corner, box.min_corner);
+  max_corner = glm::max(max_corner, box.max_corner);
+}
+
+glm::vec3 Aabb::getCenter() const
+{
+  return 0.5f * (min_corner + max_corner);
+}
+
+float Aabb::getHalfArea() const
+{
+  // an empty box has min > max
+  if (min_corner.x > max_corner.x)
+  {
+    return 0.0f;
+  }
+  const glm::vec3 size{max_corner - min_corner};
+  return size.x * size.y + size.y * size.z + size.z * size.x;
+}
+
+bool Aabb::overlaps(const Aabb& box) const
+{
+  return min_corner.x <= box.max_corner.x && box.min_corner.x <= max_corner.x
+    && min_corner.y <= box.max_corner.y && box.min_corner.y <= max_corner.y
+    && min_corner.z <= box.max_corner.z && box.min_corner.z <= max_corner.z;
+}
+
+namespace {
+
+constexpr int n_bins{16};
+// the split is searched with the SAH up to this depth, then the objects
+// are split in halves: the tree is at most max_sah_depth + log2(n) deep
+constexpr unsigned int max_sah_depth{32};
+// stack of the queries, larger than the deepest tree (2^32 objects)
+constexpr std::size_t max_stack_size{max_sah_depth + 33};
+// a thread is not worth it for a small subtree
+constexpr std::uint32_t min_parallel_objects{4096};
+
+Aabb getNodeBox(const BvhNode& node)
+{
+  return Aabb{node.min_corner, node.max_corner};
+}
+
+void setNodeBox(BvhNode& node, const Aabb& box)
+{
+  node.min_corner = box.min_corner;
+  node.max_corner = box.max_corner;
+}
+
+// Position of the box relative to the frustum
+enum class FrustumTest {
+  Outside,
+  Intersecting,
+  Inside
+};
+
+FrustumTest testBox(const Frustum& frustum, const glm::vec3& min_corner, const glm::vec3& max_corner)
+{
+  const glm::vec3 center{0.5f * (min_corner + max_corner)};
+  const glm::vec3 extent{0.5f * (max_corner - min_corner)};
+  FrustumTest result{FrustumTest::Inside};
+  for (const auto& plane : frustum.planes)
+  {
+    const float distance{glm::dot(glm::vec3(plane), center) + plane.w};
+    const float radius{glm::dot(glm::abs(glm::vec3(plane)), extent)};
+    if (distance < -radius)
+    {
+      return FrustumTest::Outside;
+    }
+    if (distance < radius)
+    {
+      result = FrustumTest::Intersecting;
+    }
+  }
+  return result;
+}
+
+// Distance along the ray where it enters the box (0 if it starts inside),
+// or a negative value if it misses it before max_distance (slab test)
+float intersectRay(const glm::vec3& origin, const glm::vec3& inverse_direction, float max_distance, const glm::vec3& min_corner, const glm::vec3& max_corner)
+{
+  const glm::vec3 t_min{(min_corner - origin) * inverse_direction};
+  const glm::vec3 t_max{(max_corner - origin) * inverse_direction};
+  const glm::vec3 t_near{glm::min(t_min, t_max)};
+  const glm::vec3 t_far{glm::max(t_min, t_max)};
+  const float t_enter{std::max(std::max(t_near.x, t_near.y), std::max(t_near.z, 0.0f))};
+  const float t_exit{std::min(std::min(t_far.x, t_far.y), std::min(t_far.z, max_distance))};
+  return t_enter <= t_exit ? t_enter : -1.0f;
+}
+
+}
+
+BoundingVolumeHierarchy::BoundingVolumeHierarchy(std::size_t max_leaf_objects) :
+  max_leaf_objects_{std::max<std::size_t>(max_leaf_objects, 1)}
+{
+}
+
+void BoundingVolumeHierarchy::build(const std::vector<Aabb>& box_list, unsigned int n_threads)
+{
+  node_list_.clear();
+  object_id_list_.resize(box_list.size());
+  leaf_box_list_.resize(box_list.size());
+  if (box_list.empty())
+  {
+    return;
+  }
+
+  std::vector<BuildObject> build_object_list(box_list.size());
+  for (std::size_t i = 0; i < box_list.size(); i++)
+  {
+    build_object_list[i] = BuildObject{box_list[i], box_list[i].getCenter(), static_cast<std::uint32_t>(i)};
+  }
+
+  if (n_threads == 0)
+  {
+    n_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  // each level of parallel_depth doubles the number of threads
+  unsigned int parallel_depth{0};
+  while ((1u << parallel_depth) < n_threads)
+  {
+    parallel_depth++;
+  }
+
+  // a binary tree with leaves of at least 1 object has less than 2n nodes
+  node_list_.reserve(2 * box_list.size() / max_leaf_objects_ + 1);
+  buildNode_(node_list_, build_object_list, 0, static_cast<std::uint32_t>(box_list.size()), 0, parallel_depth);
+
+  // the objects are now in the order of the leaves
+  for (std::size_t i = 0; i < build_object_list.size(); i++)
+  {
+    object_id_list_[i] = build_object_list[i].id;
+  }
+  // only the leaves know the boxes of the objects, refit computes
+  // the boxes of all the nodes from them
+  refit(box_list);
+}
+
+std::uint32_t BoundingVolumeHierarchy::makeLeaf_(std::vector<BvhNode>& node_list, std::uint32_t first, std::uint32_t n_objects)
+{
+  BvhNode leaf{};
+  leaf.first = first;
+  leaf.n_objects = n_objects;
+  node_list.push_back(leaf);
+  return static_cast<std::uint32_t>(node_list.size() - 1);
+}
+
+std::uint32_t BoundingVolumeHierarchy::buildNode_(
+  std::vector<BvhNode>& node_list,
+  std::vector<BuildObject>& build_object_list,
+  std::uint32_t first,
+  std::uint32_t n_objects,
+  unsigned int depth,
+  unsigned int parallel_depth
+)
+{
+  if (n_objects <= max_leaf_objects_)
+  {
+    return makeLeaf_(node_list, first, n_objects);
+  }
+
+  BuildObject* const objects{build_object_list.data() + first};
+
+  Aabb centroid_box{};
+  for (std::uint32_t i = 0; i < n_objects; i++)
+  {
+    centroid_box.grow(objects[i].centroid);
+  }
+  const glm::vec3 centroid_size{centroid_box.max_corner - centroid_box.min_corner};
+
+  std::uint32_t n_left{0};
+  if (depth < max_sah_depth)
+  {
+    // the objects go to the bins by their centroid, on the 3 axes at once,
+    // and each bin grows with the boxes of its objects
+    std::array<std::array<Aabb, n_bins>, 3> bin_box_list{};
+    std::array<std::array<std::uint32_t, n_bins>, 3> bin_count_list{};
+    glm::vec3 bin_scale{0.0f};
+    for (int axis = 0; axis < 3; axis++)
+    {
+      if (centroid_size[axis] > 0.0f)
+      {
+        bin_scale[axis] = n_bins / centroid_size[axis];
+      }
+    }
+    auto binOf{[&](const glm::vec3& centroid, int axis) {
+      const int bin{static_cast<int>((centroid[axis] - centroid_box.min_corner[axis]) * bin_scale[axis])};
+      return std::min(bin, n_bins - 1);
+    }};
+
+    for (std::uint32_t i = 0; i < n_objects; i++)
+    {
+      for (int axis = 0; axis < 3; axis++)
+      {
+        const int bin{binOf(objects[i].centroid, axis)};
+        bin_box_list[axis][bin].grow(objects[i].box);
+        bin_count_list[axis][bin]++;
+      }
+    }
+
+    // cost of the split after each bin: sweep from the right to get
+    // the right sides, then from the left
+    float best_cost{std::numeric_limits<float>::max()};
+    int best_axis{-1};
+    int best_bin{0};
+    for (int axis = 0; axis < 3; axis++)
+    {
+      if (centroid_size[axis] <= 0.0f)
+      {
+        continue;
+      }
+
+      std::array<float, n_bins> right_cost{};
+      Aabb right_box{};
+      std::uint32_t n_right{0};
+      for (int bin = n_bins - 1; bin > 0; bin--)
+      {
+        right_box.grow(bin_box_list[axis][bin]);
+        n_right += bin_count_list[axis][bin];
+        right_cost[bin - 1] = n_right * right_box.getHalfArea();
+      }
+
+      Aabb left_box{};
+      std::uint32_t n_left_objects{0};
+      for (int bin = 0; bin < n_bins - 1; bin++)
+      {
+        left_box.grow(bin_box_list[axis][bin]);
+        n_left_objects += bin_count_list[axis][bin];
+        if (n_left_objects == 0 || n_left_objects == n_objects)
+        {
+          continue;
+        }
+        const float cost{n_left_objects * left_box.getHalfArea() + right_cost[bin]};
+        if (cost < best_cost)
+        {
+          best_cost = cost;
+          best_axis = axis;
+          best_bin = bin;
+        }
+      }
+    }
+
+    if (best_axis >= 0)
+    {
+      BuildObject* const middle{std::partition(objects, objects + n_objects, [&](const BuildObject& object) {
+        return binOf(object.centroid, best_axis) <= best_bin;
+      })};
+      n_left = static_cast<std::uint32_t>(middle - objects);
+    }
+  }
+
+  // too deep for the SAH, or all the centroids at the same place:
+  // split in 2 halves along the largest axis
+  if (n_left == 0)
+  {
+    int axis{0};
+    if (centroid_size.y > centroid_size[axis])
+    {
+      axis = 1;
+    }
+    if (centroid_size.z > centroid_size[axis])
+    {
+      axis = 2;
+    }
+    n_left = n_objects / 2;
+    std::nth_element(objects, objects + n_left, objects + n_objects, [&](const BuildObject& a, const BuildObject& b) {
+      return a.centroid[axis] < b.centroid[axis];
+    });
+  }
+
+  // depth first: the node, its left subtree, then its right subtree
+  node_list.push_back(BvhNode{});
+  const std::uint32_t node{static_cast<std::uint32_t>(node_list.size() - 1)};
+
+  std::uint32_t right_child{0};
+  if (depth < parallel_depth && n_objects >= min_parallel_objects)
+  {
+    // the 2 subtrees work on separate ranges of build_object_list: the right
+    // one is built by another thread in its own node list, then appended
+    std::vector<BvhNode> right_node_list{};
+    std::thread right_thread{[&]() {
+      buildNode_(right_node_list, build_object_list, first + n_left, n_objects - n_left, depth + 1, parallel_depth);
+    }};
+    buildNode_(node_list, build_object_list, first, n_left, depth + 1, parallel_depth);
+    right_thread.join();
+
+    right_child = static_cast<std::uint32_t>(node_list.size());
+    for (BvhNode right_node : right_node_list)
+    {
+      // indices of the right children are now relative to node_list
+      if (!right_node.isLeaf())
+      {
+        right_node.first += right_child;
+      }
+      node_list.push_back(right_node);
+    }
+  }
+  else
+  {
+    buildNode_(node_list, build_object_list, first, n_left, depth + 1, parallel_depth);
+    right_child = buildNode_(node_list, build_object_list, first + n_left, n_objects - n_left, depth + 1, parallel_depth);
+  }
+
+  node_list[node].first = right_child;
+  node_list[node].n_objects = 0;
+  return node;
+}
+
+void BoundingVolumeHierarchy::refit(const std::vector<Aabb>& box_list)
+{
+  for (std::size_t i = 0; i < object_id_list_.size(); i++)
+  {
+    leaf_box_list_[i] = box_list[object_id_list_[i]];
+  }
+
+  // children are always after their parent: going backward,
+  // the boxes of the children are known when their parent is reached
+  for (std::size_t i = node_list_.size(); i-- > 0;)
+  {
+    BvhNode& node{node_list_[i]};
+    Aabb box{};
+    if (node.isLeaf())
+    {
+      for (std::uint32_t j = 0; j < node.n_objects; j++)
+      {
+        box.grow(leaf_box_list_[node.first + j]);
+      }
+    }
+    else
+    {
+      box = getNodeBox(node_list_[i + 1]);
+      box.grow(getNodeBox(node_list_[node.first]));
+    }
+    setNodeBox(node, box);
+  }
+}
+
+std::size_t BoundingVolumeHierarchy::queryFrustum(const Frustum& frustum, std::vector<std::uint32_t>& visible_ids) const
+{
+  visible_ids.clear();
+  if (node_list_.empty())
+  {
+    return 0;
+  }
+
+  // a node fully inside the frustum has all its objects visible:
+  // its subtree is walked without any test
+  struct StackEntry {
+    std::uint32_t node;
+    bool inside;
+  };
+  std::array<StackEntry, max_stack_size> stack;
+  std::size_t stack_size{0};
+  stack[stack_size++] = StackEntry{0, false};
+  std::size_t n_visited{0};
+
+  while (stack_size > 0)
+  {
+    const StackEntry entry{stack[--stack_size]};
+    const BvhNode& node{node_list_[entry.node]};
+    n_visited++;
+
+    bool inside{entry.inside};
+    if (!inside)
+    {
+      const FrustumTest test{testBox(frustum, node.min_corner, node.max_corner)};
+      if (test == FrustumTest::Outside)
+      {
+        continue;
+      }
+      inside = test == FrustumTest::Inside;
+    }
+
+    if (node.isLeaf())
+    {
+      for (std::uint32_t i = node.first; i < node.first + node.n_objects; i++)
+      {
+        const Aabb& box{leaf_box_list_[i]};
+        if (inside || testBox(frustum, box.min_corner, box.max_corner) != FrustumTest::Outside)
+        {
+          visible_ids.push_back(object_id_list_[i]);
+        }
+      }
+    }
+    else
+    {
+      stack[stack_size++] = StackEntry{node.first, inside};
+      stack[stack_size++] = StackEntry{entry.node + 1, inside};
+    }
+  }
+
+  return n_visited;
+}
+
+RayHit BoundingVolumeHierarchy::queryRay(const Ray& ray) const
+{
+  RayHit hit{};
+  if (node_list_.empty())
+  {
+    return hit;
+  }
+
+  // a zero component gives an infinite inverse, the slab test still works
+  const glm::vec3 inverse_direction{1.0f / ray.direction};
+  hit.distance = ray.max_distance;
+
+  // nodes with the distance where the ray enters them: a node farther
+  // than the closest hit found so far can not hold a closer one
+  struct StackEntry {
+    std::uint32_t node;
+    float distance;
+  };
+  std::array<StackEntry, max_stack_size> stack;
+  std::size_t stack_size{0};
+
+  const float root_distance{intersectRay(ray.origin, inverse_direction, hit.distance, node_list_[0].min_corner, node_list_[0].max_corner)};
+  if (root_distance < 0.0f)
+  {
+    return hit;
+  }
+  stack[stack_size++] = StackEntry{0, root_distance};
+
+  while (stack_size > 0)
+  {
+    const StackEntry entry{stack[--stack_size]};
+    if (entry.distance > hit.distance)
+    {
+      continue;
+    }
+    const BvhNode& node{node_list_[entry.node]};
+
+    if (node.isLeaf())
+    {
+      for (std::uint32_t i = node.first; i < node.first + node.n_objects; i++)
+      {
+        const Aabb& box{leaf_box_list_[i]};
+        const float distance{intersectRay(ray.origin, inverse_direction, hit.distance, box.min_corner, box.max_corner)};
+        if (distance >= 0.0f && (!hit.isHit() || distance < hit.distance))
+        {
+          hit.id = object_id_list_[i];
+          hit.distance = distance;
+        }
+      }
+      continue;
+    }
+
+    // the nearest child is pushed last, to be visited first
+    StackEntry left{entry.node + 1, 0.0f};
+    StackEntry right{node.first, 0.0f};
+    left.distance = intersectRay(ray.origin, inverse_direction, hit.distance, node_list_[left.node].min_corner, node_list_[left.node].max_corner);
+    right.distance = intersectRay(ray.origin, inverse_direction, hit.distance, node_list_[right.node].min_corner, node_list_[right.node].max_corner);
+    if (left.distance > right.distance)
+    {
+      std::swap(left, right);
+    }
+    if (right.distance >= 0.0f)
+    {
+      stack[stack_size++] = right;
+    }
+    if (left.distance >= 0.0f)
+    {
+      stack[stack_size++] = left;
+    }
+  }
+
+  if (!hit.isHit())
+  {
+    hit.distance = std::numeric_limits<float>::max();
+  }
+  return hit;
+}
+
+std::size_t BoundingVolumeHierarchy::queryOverlap(const Aabb& box, std::vector<std::uint32_t>& overlap_ids) const
+{
+  overlap_ids.clear();
+  if (node_list_.empty())
+  {
+    return 0;
+  }
+
+  std::array<std::uint32_t, max_stack_size> stack;
+  std::size_t stack_size{0};
+  stack[stack_size++] = 0;
+  std::size_t n_visited{0};
+
+  while (stack_size > 0)
+  {
+    const std::uint32_t node_index{stack[--stack_size]};
+    const BvhNode& node{node_list_[node_index]};
+    n_visited++;
+    if (!box.overlaps(getNodeBox(node)))
+    {
+      continue;
+    }
+
+    if (node.isLeaf())
+    {
+      for (std::uint32_t i = node.first; i < node.first + node.n_objects; i++)
+      {
+        if (box.overlaps(leaf_box_list_[i]))
+        {
+          overlap_ids.push_back(object_id_list_[i]);
+        }
+      }
+    }
+    else
+    {
+      stack[stack_size++] = node.first;
+      stack[stack_size++] = node_index + 1;
+    }
+  }
+
+  return n_visited;
+}
+
+float BoundingVolumeHierarchy::getCost() const
+{
+  if (node_list_.empty())
+  {
+    return 0.0f;
+  }
+
+  // probability to visit a node: area of its box / area of the root box
+  // an inner node costs one box test, a leaf one test per object
+  double cost{0.0};
+  for (const BvhNode& node : node_list_)
+  {
+    const double area{getNodeBox(node).getHalfArea()};
+    cost += node.isLeaf() ? area * node.n_objects : area;
+  }
+  const double root_area{getNodeBox(node_list_[0]).getHalfArea()};
+  return root_area > 0.0 ? static_cast<float>(cost / root_area) : 0.0f;
+}
+
+std::size_t BoundingVolumeHierarchy::getNodeCount() const
+{
+  return node_list_.size();
+}
+
+const std::vector<BvhNode>& BoundingVolumeHierarchy::getNodes() const
+{
+  return node_list_;
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "Frustum.hpp"
+
+// Axis aligned bounding box
+struct Aabb final {
+  glm::vec3 min_corner{std::numeric_limits<float>::max()};
+  glm::vec3 max_corner{-std::numeric_limits<float>::max()};
+
+  // Box of an object centered on position, like the cubes of the examples
+  // (half_extent 0.5 for a unit cube, sqrt(3) / 2 if it can rotate)
+  static Aabb fromCenter(const glm::vec3& center, const glm::vec3& half_extent);
+
+  void grow(const glm::vec3& point);
+  void grow(const Aabb& box);
+  glm::vec3 getCenter() const;
+  // half of the surface area, which is all the SAH needs
+  float getHalfArea() const;
+  bool overlaps(const Aabb& box) const;
+};
+
+struct Ray final {
+  glm::vec3 origin;
+  // does not need to be normalized, distances are in units of direction
+  glm::vec3 direction;
+  float max_distance{std::numeric_limits<float>::max()};
+};
+
+struct RayHit final {
+  static constexpr std::uint32_t no_object{std::numeric_limits<std::uint32_t>::max()};
+  std::uint32_t id{no_object};
+  float distance{std::numeric_limits<float>::max()};
+
+  bool isHit() const { return id != no_object; }
+};
+
+// Node of the flattened tree, 32 bytes: 2 nodes per cache line
+// The nodes are stored depth first, so the left child of an inner node
+// is the next node, only the index of the right child is stored
+struct BvhNode final {
+  glm::vec3 min_corner;
+  // inner node: index of the right child
+  // leaf: index of its first object in the object id list
+  std::uint32_t first;
+  glm::vec3 max_corner;
+  // 0 for an inner node
+  std::uint32_t n_objects;
+
+  bool isLeaf() const { return n_objects != 0; }
+};
+
+/**
+ * Bounding volume hierarchy over the boxes of the objects of a scene,
+ * to find the ones in the frustum, hit by a ray (picking) or overlapping
+ * a box without testing all of them
+ *
+ * std::vector<Aabb> box_list{};
+ * for (const auto& position : cube_position_list) {
+ *   box_list.push_back(Aabb::fromCenter(position, glm::vec3(0.5f)));
+ * }
+ * BoundingVolumeHierarchy bvh{};
+ * bvh.build(box_list);
+ * bvh.queryFrustum(camera.getFrustum(), visible_ids);
+ *
+ * The tree is split with the Surface Area Heuristic (SAH): the cost of a split
+ * is the number of objects of each side weighted by the probability to visit
+ * it, the area of its box. The best split is searched on 16 bins per axis
+ *
+ * When the objects move, refit() only computes the boxes of the nodes again,
+ * the tree stays the same: it is much faster than build() but the tree gets
+ * worse as the objects go away from where they were, getCost() tells when
+ * it is time to build it again
+ */
+class BoundingVolumeHierarchy final {
+private:
+  std::vector<BvhNode> node_list_;
+  // ids of the objects, the ones of a leaf are contiguous
+  std::vector<std::uint32_t> object_id_list_;
+  // boxes of the objects in the order of object_id_list_, so the objects
+  // of a leaf are read from one block of memory
+  std::vector<Aabb> leaf_box_list_;
+  std::size_t max_leaf_objects_;
+
+  // An object while the tree is built: its box and centroid are moved
+  // with its id, so the splits read contiguous memory
+  struct BuildObject {
+    Aabb box;
+    glm::vec3 centroid;
+    std::uint32_t id;
+  };
+
+  // Build the subtree of the objects build_object_list[first, first + n_objects)
+  // at the end of node_list, returns the index of its root
+  // The first subtrees are built by other threads when depth < parallel_depth
+  // Deeper than max_sah_depth the objects are split in 2 halves, so the depth of
+  // the tree is bounded whatever the scene (the queries use a fixed stack)
+  std::uint32_t buildNode_(
+    std::vector<BvhNode>& node_list,
+    std::vector<BuildObject>& build_object_list,
+    std::uint32_t first,
+    std::uint32_t n_objects,
+    unsigned int depth,
+    unsigned int parallel_depth
+  );
+  std::uint32_t makeLeaf_(std::vector<BvhNode>& node_list, std::uint32_t first, std::uint32_t n_objects);
+public:
+  explicit BoundingVolumeHierarchy(std::size_t max_leaf_objects = 4);
+
+  // Build the tree over the boxes of the objects (their id is their index)
+  // n_threads 0 uses all the cores
+  void build(const std::vector<Aabb>& box_list, unsigned int n_threads = 0);
+  // The objects moved (same number of objects, same ids): compute the boxes
+  // of the nodes again, the tree is kept
+  void refit(const std::vector<Aabb>& box_list);
+
+  // Ids of the objects whose box intersects the frustum (conservative, like
+  // cullBoxes), visible_ids is cleared first. Returns the number of nodes
+  // visited, to compare with the number of objects
+  std::size_t queryFrustum(const Frustum& frustum, std::vector<std::uint32_t>& visible_ids) const;
+  // Closest object whose box is hit by the ray
+  RayHit queryRay(const Ray& ray) const;
+  // Ids of the objects whose box overlaps box, overlap_ids is cleared first
+  // Returns the number of nodes visited
+  std::size_t queryOverlap(const Aabb& box, std::vector<std::uint32_t>& overlap_ids) const;
+
+  // SAH cost of the tree: expected number of nodes and objects tested
+  // by a random ray, relative to the box of the root
+  float getCost() const;
+  std::size_t getNodeCount() const;
+  const std::vector<BvhNode>& getNodes() const;
+};
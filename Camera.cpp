@@ -1,3 +1,5 @@
+#include <cmath>
+
 #include "glm/gtc/matrix_transform.hpp"
 
 #include "Camera.hpp"
@@ -7,6 +9,7 @@ Camera::Camera() :
     position_{glm::vec3(0.0f, 0.0f,  3.0f)},
     front_{glm::vec3(0.0f, 0.0f, -1.0f)},
     up_{glm::vec3(0.0f, 1.0f,  0.0f)},
+    right_{glm::normalize(glm::cross(front_, up_))},
     first_mouse_event_{false},
     pitch_{0.},
     // camera points toward negative z-axis, so 90 clockwise
@@ -19,6 +22,14 @@ Camera::Camera() :
     last_mouse_y_{300.},
     speed_coeff_{2.5f}
 {
+    setPerspective(45.0f, 800.0f / 600.0f, 0.1f, 100.0f);
+}
+
+void Camera::markDirty_()
+{
+    view_dirty_ = true;
+    view_projection_dirty_ = true;
+    version_++;
 }
 
 void Camera::updateOrientation(double mouse_x_pos, double mouse_y_pos)
@@ -35,6 +46,12 @@ void Camera::updateOrientation(double mouse_x_pos, double mouse_y_pos)
     last_mouse_x_ = mouse_x_pos;
     last_mouse_y_ = mouse_y_pos;
 
+    // the mouse did not move (first event, ...): nothing to compute
+    if (x_offset == 0.0f && y_offset == 0.0f)
+    {
+        return;
+    }
+
     x_offset *= sensitivity_;
     y_offset *= sensitivity_;
 
@@ -49,11 +66,51 @@ void Camera::updateOrientation(double mouse_x_pos, double mouse_y_pos)
     if(pitch_ < -89.0f)
         pitch_ = -89.0f;
 
+    updateVectors_();
+}
+
+void Camera::setPose(const glm::vec3& position, float yaw_degrees, float pitch_degrees)
+{
+    // same limits as with the mouse
+    pitch_degrees = glm::clamp(pitch_degrees, -89.0f, 89.0f);
+
+    // the camera did not move: keep the matrices (and the version)
+    if (position == position_ && yaw_degrees == yaw_ && pitch_degrees == pitch_)
+    {
+        return;
+    }
+
+    position_ = position;
+    yaw_ = yaw_degrees;
+    pitch_ = pitch_degrees;
+    updateVectors_();
+}
+
+float Camera::getYaw() const
+{
+    return yaw_;
+}
+
+float Camera::getPitch() const
+{
+    return pitch_;
+}
+
+void Camera::updateVectors_()
+{
+    // each sin and cos once
+    const float cos_yaw{std::cos(glm::radians(yaw_))};
+    const float sin_yaw{std::sin(glm::radians(yaw_))};
+    const float cos_pitch{std::cos(glm::radians(pitch_))};
+    const float sin_pitch{std::sin(glm::radians(pitch_))};
+
     glm::vec3 direction;
-    direction.x = cos(glm::radians(yaw_)) * cos(glm::radians(pitch_));
-    direction.y = sin(glm::radians(pitch_));
-    direction.z = sin(glm::radians(yaw_)) * cos(glm::radians(pitch_));
+    direction.x = cos_yaw * cos_pitch;
+    direction.y = sin_pitch;
+    direction.z = sin_yaw * cos_pitch;
     front_ = glm::normalize(direction);
+    right_ = glm::normalize(glm::cross(front_, up_));
+    markDirty_();
 }
 
 // Change the global variable camera_pos
@@ -64,6 +121,11 @@ void Camera::updatePosition(Movement camera_movement, float delta_time)
     // ensure the speed is the same regardless of the frame rate
     const float camera_speed = speed_coeff_ * delta_time;
 
+    if (camera_speed == 0.0f)
+    {
+        return;
+    }
+
     if (camera_movement == Movement::Front)
     {
         position_ += camera_speed * front_;
@@ -74,24 +136,64 @@ void Camera::updatePosition(Movement camera_movement, float delta_time)
     }
     if (camera_movement == Movement::Left)
     {
-        position_ -= glm::normalize(glm::cross(front_, up_)) * camera_speed;
+        position_ -= right_ * camera_speed;
     }
     if (camera_movement == Movement::Right)
     {
-        position_ += glm::normalize(glm::cross(front_, up_)) * camera_speed;
+        position_ += right_ * camera_speed;
     }
+
+    markDirty_();
+}
+
+void Camera::setPerspective(float fov_y_degrees, float aspect_ratio, float near_distance, float far_distance)
+{
+    // glm::perspective creates a 'frustrum' that define visible space
+    projection_matrix_ = glm::perspective(glm::radians(fov_y_degrees), aspect_ratio, near_distance, far_distance);
+    // the view did not change, only the projection
+    view_projection_dirty_ = true;
+    version_++;
 }
 
 const glm::mat4& Camera::getUpdatedViewMatrix() {
-    view_matrix_ = glm::lookAt(
-        position_, // eye
-        position_ + front_, // center
-        up_ // up
-    );
+    if (view_dirty_)
+    {
+        view_matrix_ = glm::lookAt(
+            position_, // eye
+            position_ + front_, // center
+            up_ // up
+        );
+        view_dirty_ = false;
+    }
 
     return view_matrix_;
 }
 
+const glm::mat4& Camera::getProjectionMatrix() const {
+    return projection_matrix_;
+}
+
+const glm::mat4& Camera::getViewProjectionMatrix() {
+    if (view_projection_dirty_)
+    {
+        view_projection_matrix_ = projection_matrix_ * getUpdatedViewMatrix();
+        frustum_ = extractFrustum(view_projection_matrix_);
+        view_projection_dirty_ = false;
+    }
+
+    return view_projection_matrix_;
+}
+
+const Frustum& Camera::getFrustum() {
+    // the frustum is extracted with the view projection matrix
+    getViewProjectionMatrix();
+    return frustum_;
+}
+
 const glm::vec3& Camera::getPosition() const {
     return position_;
 }
+
+std::uint64_t Camera::getVersion() const {
+    return version_;
+}
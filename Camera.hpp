@@ -1,8 +1,12 @@
 #pragma once
 
+#include <cstdint>
+
 #include "GLFW/glfw3.h"
 #include "glm/glm.hpp"
 
+#include "Frustum.hpp"
+
 class Camera
 {
 private:
@@ -10,6 +14,8 @@ private:
     glm::vec3 position_;
     glm::vec3 front_;
     glm::vec3 up_;
+    // normalize(cross(front_, up_)), updated with front_
+    glm::vec3 right_;
     bool first_mouse_event_;
     float yaw_;
     float pitch_;
@@ -20,6 +26,16 @@ private:
     // View matrix
     // transform from world coordinate to 'camera' coordinates
     glm::mat4 view_matrix_{};
+    glm::mat4 projection_matrix_{};
+    glm::mat4 view_projection_matrix_{};
+    Frustum frustum_{};
+    // The matrices are only computed again when the camera moved
+    bool view_dirty_{true};
+    bool view_projection_dirty_{true};
+    std::uint64_t version_{1};
+    void markDirty_();
+    // front_ and right_ from yaw_ and pitch_
+    void updateVectors_();
 public:
     Camera();
     enum Movement {
@@ -30,7 +46,24 @@ public:
     };
     void updatePosition(Movement camera_movement, float delta_time);
     void updateOrientation(double mouse_x_pos, double mouse_y_pos);
+    // Place the camera directly (scripted paths, benchmarks)
+    // yaw and pitch in degrees, as updated by the mouse
+    void setPose(const glm::vec3& position, float yaw_degrees, float pitch_degrees);
+    float getYaw() const;
+    float getPitch() const;
+    // Projection used by getProjectionMatrix, getViewProjectionMatrix and getFrustum
+    // (45 degrees, 800 / 600, 0.1, 100 by default)
+    void setPerspective(float fov_y_degrees, float aspect_ratio, float near_distance, float far_distance);
     // Update the LookAt with position, orientation, ... and return it
+    // (only computed again if the camera moved since the last call)
     const glm::mat4& getUpdatedViewMatrix();
+    const glm::mat4& getProjectionMatrix() const;
+    const glm::mat4& getViewProjectionMatrix();
+    // Frustum planes in world coordinates, for culling
+    const Frustum& getFrustum();
     const glm::vec3& getPosition() const;
+    // Incremented each time the view or the projection changes:
+    // keep the version of the last upload, and skip the upload
+    // (of a uniform buffer, ...) while it is the same
+    std::uint64_t getVersion() const;
 };
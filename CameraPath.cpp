@@ -0,0 +1,88 @@
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "CameraPath.hpp"
+
+namespace {
+
+// Catmull-Rom spline between p1 and p2 (t in [0, 1]),
+// p0 and p3 give the tangents at p1 and p2
+glm::vec3 catmullRom(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3, float t)
+{
+  const float t2{t * t};
+  const float t3{t2 * t};
+  return 0.5f * (
+    2.0f * p1
+    + (p2 - p0) * t
+    + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2
+    + (3.0f * p1 - p0 - 3.0f * p2 + p3) * t3
+  );
+}
+
+}
+
+CameraPath::CameraPath(std::vector<CameraKeyframe> keyframe_list, bool is_loop) :
+  keyframe_list_{std::move(keyframe_list)},
+  is_loop_{is_loop}
+{
+}
+
+bool CameraPath::isEmpty() const
+{
+  return keyframe_list_.empty();
+}
+
+float CameraPath::getDuration() const
+{
+  return keyframe_list_.empty() ? 0.0f : keyframe_list_.back().time;
+}
+
+CameraKeyframe CameraPath::getPose(float time) const
+{
+  if (keyframe_list_.size() < 2)
+  {
+    return keyframe_list_.empty() ? CameraKeyframe{time, glm::vec3(0.0f), -90.0f, 0.0f} : keyframe_list_.front();
+  }
+
+  const float duration{getDuration()};
+  if (is_loop_ && duration > 0.0f)
+  {
+    time = std::fmod(time, duration);
+  }
+  time = std::clamp(time, 0.0f, duration);
+
+  // keyframe_list_[i] <= time < keyframe_list_[i + 1]
+  auto next{std::upper_bound(
+    keyframe_list_.begin() + 1, keyframe_list_.end() - 1, time,
+    [](float value, const CameraKeyframe& keyframe) { return value < keyframe.time; }
+  )};
+  const std::size_t i{static_cast<std::size_t>(next - keyframe_list_.begin()) - 1};
+
+  const CameraKeyframe& k1{keyframe_list_[i]};
+  const CameraKeyframe& k2{keyframe_list_[i + 1]};
+  // at both ends, the missing neighbour is the end itself
+  const CameraKeyframe& k0{keyframe_list_[i > 0 ? i - 1 : i]};
+  const CameraKeyframe& k3{keyframe_list_[std::min(i + 2, keyframe_list_.size() - 1)]};
+
+  const float segment_duration{k2.time - k1.time};
+  const float t{segment_duration > 0.0f ? (time - k1.time) / segment_duration : 0.0f};
+
+  return CameraKeyframe{
+    time,
+    catmullRom(k0.position, k1.position, k2.position, k3.position, t),
+    k1.yaw + (k2.yaw - k1.yaw) * t,
+    k1.pitch + (k2.pitch - k1.pitch) * t
+  };
+}
+
+void CameraPath::apply(float time, Camera& camera) const
+{
+  if (keyframe_list_.empty())
+  {
+    return;
+  }
+
+  const CameraKeyframe pose{getPose(time)};
+  camera.setPose(pose.position, pose.yaw, pose.pitch);
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "Camera.hpp"
+
+// Where the camera is at a given time of a path
+// yaw and pitch in degrees, like Camera::setPose
+struct CameraKeyframe final {
+  float time;
+  glm::vec3 position;
+  float yaw;
+  float pitch;
+};
+
+/**
+ * Scripted camera movement, to replay exactly the same frames in each run
+ * (benchmarks, screenshots) instead of moving with the keyboard and the mouse
+ *
+ * CameraPath path{{
+ *   {0.0f, glm::vec3(0.0f, 0.0f, 3.0f), -90.0f, 0.0f},
+ *   {4.0f, glm::vec3(3.0f, 1.0f, 0.0f), -150.0f, -10.0f},
+ *   ...
+ * }};
+ * path.apply(time, camera);
+ *
+ * The positions follow a Catmull-Rom spline through the keyframes, so the
+ * camera does not turn abruptly at each of them, and the angles are
+ * interpolated linearly
+ * A looping path starts again from the first keyframe after the last one:
+ * for a smooth loop, the last keyframe should be the first one again
+ */
+class CameraPath final {
+private:
+  std::vector<CameraKeyframe> keyframe_list_;
+  bool is_loop_;
+public:
+  // keyframes sorted by time, the first one at time 0
+  explicit CameraPath(std::vector<CameraKeyframe> keyframe_list = {}, bool is_loop = true);
+
+  bool isEmpty() const;
+  // time of the last keyframe, in seconds
+  float getDuration() const;
+  CameraKeyframe getPose(float time) const;
+  // Place the camera where it is at this time (nothing if the path is empty)
+  void apply(float time, Camera& camera) const;
+};
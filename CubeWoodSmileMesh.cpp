@@ -4,13 +4,14 @@
 #include "glad/glad.h"
 
 #include "CubeWoodSmileMesh.hpp"
+#include "MeshOptimizer.hpp"
 
 
 CubeWoodSmileMesh::CubeWoodSmileMesh()
 {
     // TODO: singleton ?
     // vertices in normalized device coordinates (visible region of OpenGL)
-    // We don't use EBO here, because of the texture coordinates (see world_coo2 result in this case)
+    // The texture coordinates differ on each face (see world_coo2 result with a naive EBO)
     std::vector<float> vertices{
         // positions          // texture coords
         -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
@@ -56,54 +57,14 @@ CubeWoodSmileMesh::CubeWoodSmileMesh()
         -0.5f,  0.5f, -0.5f,  0.0f, 1.0f
     };
 
-    Nvertices_ = vertices.size();
-
-    // Vertex Array Object
-    // It will allow to store VBO and Vertex Attribute that
-    // we will consequently declare
-    // in Core OpenGL, VAO are mandatory
-    std::cout << VAO_id_ << std::endl;
-    glGenVertexArrays(1, &VAO_id_);
-    std::cout << VAO_id_ << std::endl;
-
-    // once we bind it, all subsequent VBO and attributes
-    // will be store on the VAO referenced by this id
-    glBindVertexArray(VAO_id_);
-
-    // Vertex Buffer Object
-    // will set up a memory on the graphic card
-    // VBO will store its buffer id
-    unsigned int VBO;
-    glGenBuffers(1, &VBO);  
-    // sGL_ARRAY_BUFFER is the type for a vertex buffer object
-    glBindBuffer(GL_ARRAY_BUFFER, VBO); 
-    // copy the vertex data into buffer memory for the currently
-    // bound buffer (VBO)
-    // the 4th parameters tells how we want the graphic card to manage the data
-    // GL_STATIC_DRAW means the data is set up once and could be used many times
-    // (so a memory region where read is fast could be good)
-    // another example is GL_DYNAMIC_DRAW, which means thata data can change a lot
-    // so it should be stored in a memory region where write (and read for usage) is fast
-    // TODO: size dangerous if refactored: a wrong size will prevent any display
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
-
-    // Now we have to have to tell OpenGL how to interpret the raw data
-    // vertices
-    glVertexAttribPointer(
-        0, // location of the vertex attribute, will be used in vertex shader with layout (location = 0)
-        3, // vertex attribue is a vec3, 3 elements
-        GL_FLOAT, // element of the vec3 is float
-        GL_FALSE, // don't normalize data
-        5 * sizeof(float), // size of a stride is 8 float elements
-        (void*)0 // offset is 0
-    );
-
-    // vertex attributes are disabled by default, so enable the one we created
-    glEnableVertexAttribArray(0);
-
-    // textures
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+    // The corners of a face are welded in an index buffer, the corners
+    // shared by two faces are kept apart as their texture coordinates differ
+    IndexedMesh mesh{weldVertices(vertices, 5)};
+    optimizeVertexCache(mesh);
+    optimizeVertexFetch(mesh);
+
+    // positions in location 0, texture coordinates in location 1
+    vertex_array_ = VertexArray::create<VertexLayout<AttribFloat3, AttribFloat2>>(mesh.vertices, mesh.indices);
 
     texture_list_.reserve(2);
     // TODO: harcoded relative path
@@ -115,14 +76,11 @@ CubeWoodSmileMesh::CubeWoodSmileMesh()
     texture_list_[0].bind();
     glActiveTexture(GL_TEXTURE1);
     texture_list_[1].bind();
-
-    // unbind VAO by binding to the default one
-    glBindVertexArray(0);
 }
 
 
 void CubeWoodSmileMesh::draw(ShaderProgram& shader_program) {
-    glBindVertexArray(VAO_id_);
+    vertex_array_.bind();
 
     // activate the shader (TODO: most probably already used)
     shader_program.use();
@@ -132,9 +90,5 @@ void CubeWoodSmileMesh::draw(ShaderProgram& shader_program) {
     shader_program.setInt("our_texture2", 1);
 
     // render the cube
-    glDrawArrays(
-        GL_TRIANGLES,  // we want to draw triangles
-        0,
-        Nvertices_  // we want this number of vertices in total
-    );
+    vertex_array_.draw();
 }
\ No newline at end of file
@@ -0,0 +1,203 @@
+#include <iostream>
+
+#include "DrawBatcher.hpp"
+
+DrawBatcher::DrawBatcher(GLuint first_instance_location) : first_instance_location_{first_instance_location}
+{
+}
+
+bool DrawBatcher::isMultiDrawIndirectSupported()
+{
+  // a non zero base_instance in the commands needs GL_ARB_base_instance
+  return GLAD_GL_ARB_multi_draw_indirect && GLAD_GL_ARB_base_instance;
+}
+
+std::size_t DrawBatcher::addMesh(const IndexedMesh& mesh)
+{
+  if (built_)
+  {
+    std::cout << "ERROR::DRAW_BATCHER::MESH_ADDED_AFTER_BUILD" << std::endl;
+    return invalid_mesh_id;
+  }
+
+  if (mesh.vertex_stride != Layout::source_stride)
+  {
+    std::cout << "ERROR::DRAW_BATCHER::WRONG_VERTEX_STRIDE " << mesh.vertex_stride << std::endl;
+    return invalid_mesh_id;
+  }
+
+  // the indices of the mesh are kept as they are, base_vertex
+  // is added to them by the draw
+  MeshRange_ range{};
+  range.first_index = static_cast<GLuint>(index_list_.size());
+  range.n_indices = static_cast<GLuint>(mesh.indices.size());
+  range.base_vertex = static_cast<GLint>(vertex_list_.size() / Layout::source_stride);
+
+  vertex_list_.insert(vertex_list_.end(), mesh.vertices.begin(), mesh.vertices.end());
+  index_list_.insert(index_list_.end(), mesh.indices.begin(), mesh.indices.end());
+  mesh_list_.push_back(range);
+  queued_instances_.emplace_back();
+
+  return mesh_list_.size() - 1;
+}
+
+void DrawBatcher::build()
+{
+  use_indirect_ = isMultiDrawIndirectSupported();
+
+  glGenVertexArrays(1, &vao_id_);
+  glBindVertexArray(vao_id_);
+
+  const std::vector<unsigned char> vertex_data{Layout::pack(vertex_list_, VertexStorage::Interleaved)};
+  glGenBuffers(1, &vbo_id_);
+  glBindBuffer(GL_ARRAY_BUFFER, vbo_id_);
+  glBufferData(GL_ARRAY_BUFFER, vertex_data.size(), vertex_data.data(), GL_STATIC_DRAW);
+  Layout::setup(VertexStorage::Interleaved);
+
+  glGenBuffers(1, &ebo_id_);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_id_);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_list_.size() * sizeof(unsigned int), index_list_.data(), GL_STATIC_DRAW);
+
+  glGenBuffers(1, &instance_vbo_id_);
+  glBindBuffer(GL_ARRAY_BUFFER, instance_vbo_id_);
+  setupInstanceAttributes(first_instance_location_);
+
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  if (use_indirect_)
+  {
+    glGenBuffers(1, &indirect_buffer_id_);
+  }
+
+  // the data is in GPU memory now
+  vertex_list_.clear();
+  vertex_list_.shrink_to_fit();
+  index_list_.clear();
+  index_list_.shrink_to_fit();
+  built_ = true;
+}
+
+void DrawBatcher::draw(std::size_t mesh_id, const glm::mat4& model_matrix)
+{
+  // Normal matrix: the inverse transpose of the upper 3x3 of the model
+  draw(mesh_id, InstanceTransform{model_matrix, glm::transpose(glm::inverse(glm::mat3(model_matrix)))});
+}
+
+void DrawBatcher::draw(std::size_t mesh_id, const InstanceTransform& transform)
+{
+  // invalid_mesh_id included
+  if (mesh_id >= queued_instances_.size())
+  {
+    std::cout << "ERROR::DRAW_BATCHER::UNKNOWN_MESH " << mesh_id << std::endl;
+    return;
+  }
+
+  queued_instances_[mesh_id].push_back(transform);
+}
+
+void DrawBatcher::uploadFrameData_()
+{
+  // Orphan the previous storage, the draws of the last frame may still read it
+  glBindBuffer(GL_ARRAY_BUFFER, instance_vbo_id_);
+  if (instance_list_.size() > instance_capacity_)
+  {
+    instance_capacity_ = instance_list_.size();
+  }
+  glBufferData(GL_ARRAY_BUFFER, instance_capacity_ * sizeof(InstanceTransform), NULL, GL_STREAM_DRAW);
+  glBufferSubData(GL_ARRAY_BUFFER, 0, instance_list_.size() * sizeof(InstanceTransform), instance_list_.data());
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  if (use_indirect_)
+  {
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirect_buffer_id_);
+    if (command_list_.size() > command_capacity_)
+    {
+      command_capacity_ = command_list_.size();
+    }
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, command_capacity_ * sizeof(DrawElementsIndirectCommand), NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, command_list_.size() * sizeof(DrawElementsIndirectCommand), command_list_.data());
+  }
+}
+
+void DrawBatcher::flush()
+{
+  stats_ = DrawBatcherStats{};
+  if (!built_)
+  {
+    std::cout << "ERROR::DRAW_BATCHER::FLUSH_BEFORE_BUILD" << std::endl;
+    return;
+  }
+
+  // one command per mesh, its objects are consecutive in the instance buffer
+  instance_list_.clear();
+  command_list_.clear();
+  for (std::size_t mesh_id = 0; mesh_id < mesh_list_.size(); mesh_id++)
+  {
+    auto& queue{queued_instances_[mesh_id]};
+    if (queue.empty())
+    {
+      continue;
+    }
+
+    const MeshRange_& range{mesh_list_[mesh_id]};
+    command_list_.push_back(DrawElementsIndirectCommand{
+      range.n_indices,
+      static_cast<GLuint>(queue.size()),
+      range.first_index,
+      range.base_vertex,
+      static_cast<GLuint>(instance_list_.size())
+    });
+    instance_list_.insert(instance_list_.end(), queue.begin(), queue.end());
+    queue.clear();
+  }
+
+  stats_.draws = instance_list_.size();
+  stats_.commands = command_list_.size();
+  if (command_list_.empty())
+  {
+    return;
+  }
+
+  uploadFrameData_();
+
+  glBindVertexArray(vao_id_);
+
+  if (use_indirect_)
+  {
+    // the commands are read from the bound GL_DRAW_INDIRECT_BUFFER
+    glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(command_list_.size()), 0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    stats_.gl_calls = 1;
+  }
+  else
+  {
+    glBindBuffer(GL_ARRAY_BUFFER, instance_vbo_id_);
+    for (const auto& command : command_list_)
+    {
+      const void* first_index{reinterpret_cast<void*>(command.first_index * sizeof(unsigned int))};
+      if (GLAD_GL_ARB_base_instance)
+      {
+        glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, command.count, GL_UNSIGNED_INT, first_index,
+          command.instance_count, command.base_vertex, command.base_instance);
+      }
+      else
+      {
+        // OpenGL 3.3: the instance attributes start at instance 0,
+        // so they are moved to the first transform of the command
+        setupInstanceAttributes(first_instance_location_, command.base_instance);
+        glDrawElementsInstancedBaseVertex(GL_TRIANGLES, command.count, GL_UNSIGNED_INT, first_index,
+          command.instance_count, command.base_vertex);
+      }
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    stats_.gl_calls = command_list_.size();
+  }
+
+  glBindVertexArray(0);
+}
+
+DrawBatcherStats DrawBatcher::getStats() const
+{
+  return stats_;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "glad/glad.h"
+#include "glm/glm.hpp"
+
+#include "GLExtensions.hpp"
+#include "InstancedMesh.hpp"
+#include "MeshOptimizer.hpp"
+#include "VertexLayout.hpp"
+
+// One draw of the indirect buffer, the layout is fixed by OpenGL
+// (the same parameters as glDrawElementsInstancedBaseVertexBaseInstance)
+struct DrawElementsIndirectCommand final {
+  GLuint count;           // number of indices of the mesh
+  GLuint instance_count;  // number of objects drawn with this mesh
+  GLuint first_index;     // first index of the mesh in the shared index buffer
+  GLint base_vertex;      // first vertex of the mesh in the shared vertex buffer
+  GLuint base_instance;   // first InstanceTransform of these objects
+};
+
+static_assert(sizeof(DrawElementsIndirectCommand) == 20, "DrawElementsIndirectCommand is 5 tightly packed integers");
+
+// Counters of the last flush
+struct DrawBatcherStats {
+  std::size_t draws{0};     // objects drawn
+  std::size_t commands{0};  // indirect commands (one per mesh used)
+  std::size_t gl_calls{0};  // glDraw* calls issued
+};
+
+/**
+ * Renderer for many objects using different meshes, without a
+ * glBindVertexArray and a glDrawArrays per object:
+ *
+ * - all the meshes share one VAO, one vertex buffer and one index buffer
+ *   (each mesh is a range of them)
+ * - the objects queued with draw() are grouped by mesh, their
+ *   InstanceTransform are written in one instance buffer
+ * - each mesh becomes one DrawElementsIndirectCommand, its base_instance
+ *   pointing to the transforms of its objects (read as instance attributes,
+ *   see shaders/lighting_map_instanced_vtx.glsl)
+ * - everything is submitted with a single glMultiDrawElementsIndirect
+ *
+ * Without GL_ARB_multi_draw_indirect and GL_ARB_base_instance (OpenGL 4.3)
+ * the commands are issued one by one, moving the instance attributes to
+ * the base instance of each command, which still makes one call per mesh
+ * instead of one per object
+ */
+class DrawBatcher final {
+public:
+  // 8 floats per vertex packed to 20 bytes: position, normal, texture coordinates
+  using Layout = VertexLayout<AttribFloat3, AttribSnorm10, AttribHalf2>;
+  // returned by addMesh when the mesh is refused
+  static constexpr std::size_t invalid_mesh_id{static_cast<std::size_t>(-1)};
+private:
+  struct MeshRange_ {
+    GLuint first_index;
+    GLuint n_indices;
+    GLint base_vertex;
+  };
+
+  GLuint first_instance_location_;
+  bool use_indirect_{false};
+  bool built_{false};
+
+  // the meshes, until build() uploads them
+  std::vector<float> vertex_list_;
+  std::vector<unsigned int> index_list_;
+  std::vector<MeshRange_> mesh_list_;
+
+  // objects queued for the next flush, per mesh
+  std::vector<std::vector<InstanceTransform>> queued_instances_;
+  std::vector<InstanceTransform> instance_list_;
+  std::vector<DrawElementsIndirectCommand> command_list_;
+
+  GLuint vao_id_{0};
+  GLuint vbo_id_{0};
+  GLuint ebo_id_{0};
+  GLuint instance_vbo_id_{0};
+  GLuint indirect_buffer_id_{0};
+  std::size_t instance_capacity_{0};
+  std::size_t command_capacity_{0};
+
+  DrawBatcherStats stats_{};
+
+  void uploadFrameData_();
+public:
+  // first_instance_location: location of a_model_matrix in the shaders
+  explicit DrawBatcher(GLuint first_instance_location = 3);
+  // Needs loadGLExtensions() to have been called, else the commands
+  // are always issued one by one
+  static bool isMultiDrawIndirectSupported();
+  // Add a mesh (8 floats per vertex) to the shared buffers, returns its id
+  // (invalid_mesh_id after build() or with another vertex stride)
+  std::size_t addMesh(const IndexedMesh& mesh);
+  // Upload the meshes, after the last addMesh
+  void build();
+  // Queue an object for the next flush (an unknown mesh id is an error, nothing is queued)
+  void draw(std::size_t mesh_id, const glm::mat4& model_matrix);
+  void draw(std::size_t mesh_id, const InstanceTransform& transform);
+  // Draw all the queued objects with the program in use, then empty the queue
+  void flush();
+  DrawBatcherStats getStats() const;
+};
@@ -0,0 +1,321 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+
+#include "DrawQueue.hpp"
+
+namespace {
+
+constexpr unsigned depth_shift{0};
+constexpr unsigned mesh_shift{depth_shift + draw_key_depth_bits};
+constexpr unsigned material_shift{mesh_shift + draw_key_mesh_bits};
+constexpr unsigned program_shift{material_shift + draw_key_material_bits};
+constexpr unsigned pass_shift{program_shift + draw_key_program_bits};
+
+constexpr std::uint64_t getMask(unsigned n_bits)
+{
+  return (std::uint64_t{1} << n_bits) - 1;
+}
+
+std::uint32_t getField(std::uint64_t key, unsigned shift, unsigned n_bits)
+{
+  return static_cast<std::uint32_t>((key >> shift) & getMask(n_bits));
+}
+
+// An id too large for its field would be masked into another one
+// (DrawQueue::invalid_id included), and a NaN depth has no place in the order
+bool isDrawValid(std::uint32_t pass, std::uint32_t program, std::uint32_t material, std::uint32_t mesh, float depth)
+{
+  if (pass > getMask(draw_key_pass_bits)
+    || program > getMask(draw_key_program_bits)
+    || material > getMask(draw_key_material_bits)
+    || mesh > getMask(draw_key_mesh_bits))
+  {
+    std::cout << "ERROR::DRAW_QUEUE::ID_OUT_OF_KEY_FIELD" << std::endl;
+    return false;
+  }
+  if (std::isnan(depth))
+  {
+    std::cout << "ERROR::DRAW_QUEUE::NAN_DEPTH" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+}
+
+std::uint64_t makeDrawKey(std::uint32_t pass, std::uint32_t program, std::uint32_t material, std::uint32_t mesh, float depth)
+{
+  // written so that a NaN gives 0: converting it to an integer is undefined
+  const float clamped_depth{depth > 0.0f ? std::min(depth, 1.0f) : 0.0f};
+  const std::uint64_t depth_field{static_cast<std::uint64_t>(clamped_depth * getMask(draw_key_depth_bits))};
+
+  return (static_cast<std::uint64_t>(pass) & getMask(draw_key_pass_bits)) << pass_shift
+    | (static_cast<std::uint64_t>(program) & getMask(draw_key_program_bits)) << program_shift
+    | (static_cast<std::uint64_t>(material) & getMask(draw_key_material_bits)) << material_shift
+    | (static_cast<std::uint64_t>(mesh) & getMask(draw_key_mesh_bits)) << mesh_shift
+    | depth_field << depth_shift;
+}
+
+void DrawCommandBuffer::record(std::uint32_t pass, std::uint32_t program, std::uint32_t material, std::uint32_t mesh, float depth, const glm::mat4& model_matrix)
+{
+  if (!isDrawValid(pass, program, material, mesh, depth))
+  {
+    return;
+  }
+  packet_list_.push_back(DrawPacket{makeDrawKey(pass, program, material, mesh, depth), model_matrix});
+}
+
+void DrawCommandBuffer::record(const DrawPacket& packet)
+{
+  packet_list_.push_back(packet);
+}
+
+void DrawCommandBuffer::clear()
+{
+  packet_list_.clear();
+}
+
+std::size_t DrawCommandBuffer::size() const
+{
+  return packet_list_.size();
+}
+
+const std::vector<DrawPacket>& DrawCommandBuffer::getPackets() const
+{
+  return packet_list_;
+}
+
+std::size_t DrawQueueStats::getStateChanges() const
+{
+  return program_changes + texture_binds + mesh_changes;
+}
+
+std::uint32_t DrawQueue::addProgram(ShaderProgram& program)
+{
+  if (program_list_.size() > getMask(draw_key_program_bits))
+  {
+    std::cout << "ERROR::DRAW_QUEUE::TOO_MANY_PROGRAMS" << std::endl;
+    return invalid_id;
+  }
+  program_list_.push_back(Program_{
+    &program,
+    program.getUniform<glm::mat4>("model_matrix"),
+    program.getUniform<glm::mat3>("normal_matrix")
+  });
+  return static_cast<std::uint32_t>(program_list_.size() - 1);
+}
+
+std::uint32_t DrawQueue::addMaterial(const DrawMaterial& material)
+{
+  if (material_list_.size() > getMask(draw_key_material_bits))
+  {
+    std::cout << "ERROR::DRAW_QUEUE::TOO_MANY_MATERIALS" << std::endl;
+    return invalid_id;
+  }
+  material_list_.push_back(material);
+  return static_cast<std::uint32_t>(material_list_.size() - 1);
+}
+
+std::uint32_t DrawQueue::addMesh(const VertexArray& vertex_array)
+{
+  if (mesh_list_.size() > getMask(draw_key_mesh_bits))
+  {
+    std::cout << "ERROR::DRAW_QUEUE::TOO_MANY_MESHES" << std::endl;
+    return invalid_id;
+  }
+  mesh_list_.push_back(vertex_array);
+  return static_cast<std::uint32_t>(mesh_list_.size() - 1);
+}
+
+void DrawQueue::setPassCallback(std::function<void(std::uint32_t)> pass_callback)
+{
+  pass_callback_ = std::move(pass_callback);
+}
+
+void DrawQueue::reserve(std::size_t n_draws)
+{
+  packet_list_.reserve(n_draws);
+  sort_list_.reserve(n_draws);
+  sort_scratch_.reserve(n_draws);
+}
+
+void DrawQueue::submit(std::uint32_t pass, std::uint32_t program, std::uint32_t material, std::uint32_t mesh, float depth, const glm::mat4& model_matrix)
+{
+  if (!isDrawValid(pass, program, material, mesh, depth))
+  {
+    return;
+  }
+  submit(DrawPacket{makeDrawKey(pass, program, material, mesh, depth), model_matrix});
+}
+
+void DrawQueue::submit(const DrawPacket& packet)
+{
+  sort_list_.push_back(SortEntry_{packet.key, static_cast<std::uint32_t>(packet_list_.size())});
+  packet_list_.push_back(packet);
+  is_sorted_ = false;
+}
+
+void DrawQueue::submit(const DrawCommandBuffer& command_buffer)
+{
+  const auto& packet_list{command_buffer.getPackets()};
+  std::uint32_t packet_index{static_cast<std::uint32_t>(packet_list_.size())};
+  packet_list_.insert(packet_list_.end(), packet_list.begin(), packet_list.end());
+  for (const auto& packet : packet_list)
+  {
+    sort_list_.push_back(SortEntry_{packet.key, packet_index++});
+  }
+  is_sorted_ = false;
+}
+
+std::size_t DrawQueue::size() const
+{
+  return packet_list_.size();
+}
+
+void DrawQueue::sort()
+{
+  // empty: nothing to sort (and no first key to compare with below)
+  if (is_sorted_ || sort_list_.empty())
+  {
+    return;
+  }
+
+  // LSD radix sort: stable sorts by each byte of the key, from the least
+  // significant one, with the histograms of the 8 bytes counted at once
+  const std::size_t n_entries{sort_list_.size()};
+  std::array<std::array<std::size_t, 256>, 8> histogram_list{};
+  for (const auto& entry : sort_list_)
+  {
+    for (unsigned byte = 0; byte < 8; byte++)
+    {
+      histogram_list[byte][(entry.key >> (8 * byte)) & 0xff]++;
+    }
+  }
+
+  sort_scratch_.resize(n_entries);
+  for (unsigned byte = 0; byte < 8; byte++)
+  {
+    auto& histogram{histogram_list[byte]};
+    // all the keys have the same byte (unused program bits, ...): nothing to move
+    if (histogram[(sort_list_.front().key >> (8 * byte)) & 0xff] == n_entries)
+    {
+      continue;
+    }
+
+    // where the entries of each byte value start
+    std::size_t offset{0};
+    for (auto& count : histogram)
+    {
+      const std::size_t n{count};
+      count = offset;
+      offset += n;
+    }
+    for (const auto& entry : sort_list_)
+    {
+      sort_scratch_[histogram[(entry.key >> (8 * byte)) & 0xff]++] = entry;
+    }
+    sort_list_.swap(sort_scratch_);
+  }
+
+  is_sorted_ = true;
+}
+
+void DrawQueue::flush(Order order)
+{
+  stats_ = DrawQueueStats{};
+  if (packet_list_.empty())
+  {
+    return;
+  }
+  if (order == Order::Sorted)
+  {
+    sort();
+  }
+
+  // the state left by the previous draws is unknown: the first draw binds all
+  std::uint32_t current_pass{0};
+  std::uint32_t current_program{0};
+  std::uint32_t current_material{0};
+  std::uint32_t current_mesh{0};
+  std::vector<GLuint> bound_texture_list{};
+  bool is_first{true};
+  const Program_* program{nullptr};
+
+  for (std::size_t i = 0; i < packet_list_.size(); i++)
+  {
+    const DrawPacket& packet{packet_list_[order == Order::Sorted ? sort_list_[i].packet_index : i]};
+    const std::uint32_t pass{getField(packet.key, pass_shift, draw_key_pass_bits)};
+    const std::uint32_t program_index{getField(packet.key, program_shift, draw_key_program_bits)};
+    const std::uint32_t material{getField(packet.key, material_shift, draw_key_material_bits)};
+    const std::uint32_t mesh{getField(packet.key, mesh_shift, draw_key_mesh_bits)};
+
+    // a key may come from makeDrawKey with ids which were never added
+    if (program_index >= program_list_.size() || material >= material_list_.size() || mesh >= mesh_list_.size())
+    {
+      std::cout << "ERROR::DRAW_QUEUE::UNKNOWN_ID" << std::endl;
+      continue;
+    }
+
+    if (pass_callback_ && (is_first || pass != current_pass))
+    {
+      pass_callback_(pass);
+    }
+    if (is_first || program_index != current_program)
+    {
+      program = &program_list_[program_index];
+      program->program->use();
+      stats_.program_changes++;
+    }
+    if (is_first || material != current_material)
+    {
+      // only the units whose texture changes are bound again
+      const auto& texture_id_list{material_list_[material].texture_id_list};
+      bound_texture_list.resize(std::max(bound_texture_list.size(), texture_id_list.size()), 0);
+      for (std::size_t unit = 0; unit < texture_id_list.size(); unit++)
+      {
+        if (bound_texture_list[unit] != texture_id_list[unit])
+        {
+          glActiveTexture(GL_TEXTURE0 + unit);
+          glBindTexture(GL_TEXTURE_2D, texture_id_list[unit]);
+          bound_texture_list[unit] = texture_id_list[unit];
+          stats_.texture_binds++;
+        }
+      }
+      stats_.material_changes++;
+    }
+    if (is_first || mesh != current_mesh)
+    {
+      mesh_list_[mesh].bind();
+      stats_.mesh_changes++;
+    }
+    current_pass = pass;
+    current_program = program_index;
+    current_material = material;
+    current_mesh = mesh;
+    is_first = false;
+
+    program->program->set(program->model_matrix_uniform, packet.model_matrix);
+    if (program->normal_matrix_uniform.isValid())
+    {
+      program->program->set(program->normal_matrix_uniform, glm::transpose(glm::inverse(glm::mat3(packet.model_matrix))));
+    }
+    mesh_list_[mesh].draw();
+    stats_.draws++;
+  }
+
+  clear();
+}
+
+void DrawQueue::clear()
+{
+  packet_list_.clear();
+  sort_list_.clear();
+  is_sorted_ = false;
+}
+
+DrawQueueStats DrawQueue::getStats() const
+{
+  return stats_;
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "glad/glad.h"
+#include "glm/glm.hpp"
+
+#include "ShaderProgram.hpp"
+#include "UniformRef.hpp"
+#include "VertexArray.hpp"
+
+// Bits of each field of a draw key, from the most significant:
+// the draws are sorted by pass, then program, material, mesh and depth
+constexpr unsigned draw_key_pass_bits{4};
+constexpr unsigned draw_key_program_bits{8};
+constexpr unsigned draw_key_material_bits{16};
+constexpr unsigned draw_key_mesh_bits{12};
+constexpr unsigned draw_key_depth_bits{24};
+static_assert(
+  draw_key_pass_bits + draw_key_program_bits + draw_key_material_bits + draw_key_mesh_bits + draw_key_depth_bits == 64,
+  "a draw key is 64 bits"
+);
+
+// depth: 0 (near) to 1 (far), the least significant field: it only orders
+// the draws with the same pass, program, material and mesh, front to back
+// (1 - depth for back to front). A transparent pass drawn back to front as
+// a whole needs all its draws in one program, material and mesh
+std::uint64_t makeDrawKey(std::uint32_t pass, std::uint32_t program, std::uint32_t material, std::uint32_t mesh, float depth);
+
+// A draw, as recorded: everything about the state is in the key
+struct DrawPacket final {
+  std::uint64_t key;
+  glm::mat4 model_matrix;
+};
+
+// Packets recorded by one thread, for the DrawQueue of the render thread
+// (DrawQueue::submit(buffer)): any thread can record, only the render
+// thread has a GL context to draw. Each thread has its own buffer, on its
+// own cache line, and its memory is kept from a frame to the next
+class alignas(64) DrawCommandBuffer final {
+private:
+  std::vector<DrawPacket> packet_list_;
+public:
+  void record(std::uint32_t pass, std::uint32_t program, std::uint32_t material, std::uint32_t mesh, float depth, const glm::mat4& model_matrix);
+  void record(const DrawPacket& packet);
+  void clear();
+  std::size_t size() const;
+  const std::vector<DrawPacket>& getPackets() const;
+};
+
+// Textures bound on the units 0, 1, ... by the draws of a material
+struct DrawMaterial final {
+  std::vector<GLuint> texture_id_list;
+};
+
+// Counters of the last flush
+struct DrawQueueStats {
+  std::size_t draws{0};
+  std::size_t program_changes{0};
+  std::size_t material_changes{0};
+  std::size_t texture_binds{0};   // glBindTexture, only the units which change
+  std::size_t mesh_changes{0};    // glBindVertexArray
+  std::size_t getStateChanges() const;
+};
+
+/**
+ * Draw queue: instead of drawing the objects in the order of the scene
+ * (and switching program, textures and VAO between objects), each draw is
+ * recorded as a packet with a 64-bit key
+ *
+ *   pass (4) | program (8) | material (16) | mesh (12) | depth (24)
+ *
+ * and flush() sorts the packets by key, then draws them: all the draws of
+ * a program follow each other, inside them those of a material, and so on,
+ * so each state only changes when its field of the key changes
+ *
+ * The sort is a radix sort (8 bits per pass, the passes where all the keys
+ * have the same byte are skipped): linear in the number of draws, where
+ * std::sort would compare the keys n log n times
+ *
+ * DrawQueue queue{};
+ * auto program{queue.addProgram(shader)};     // model_matrix and normal_matrix uniforms
+ * auto material{queue.addMaterial({{diffuse_id, specular_id}})};
+ * auto mesh{queue.addMesh(cube_vertex_array)};
+ * queue.submit(0, program, material, mesh, depth, model_matrix);  // per object
+ * queue.flush();
+ */
+class DrawQueue final {
+public:
+  enum class Order {
+    // the order of submit(), to compare
+    Submission,
+    Sorted
+  };
+  // returned by the add functions when their field of the key is full
+  static constexpr std::uint32_t invalid_id{static_cast<std::uint32_t>(-1)};
+private:
+  struct Program_ {
+    ShaderProgram* program;
+    UniformRef<glm::mat4> model_matrix_uniform;
+    UniformRef<glm::mat3> normal_matrix_uniform;
+  };
+  struct SortEntry_ {
+    std::uint64_t key;
+    std::uint32_t packet_index;
+  };
+
+  std::vector<Program_> program_list_;
+  std::vector<DrawMaterial> material_list_;
+  std::vector<VertexArray> mesh_list_;
+
+  std::vector<DrawPacket> packet_list_;
+  // the keys and where their packets are, sorted by flush()
+  std::vector<SortEntry_> sort_list_;
+  std::vector<SortEntry_> sort_scratch_;
+
+  bool is_sorted_{false};
+
+  std::function<void(std::uint32_t)> pass_callback_{};
+  DrawQueueStats stats_{};
+public:
+  // The ids to give to submit(), or invalid_id (and an error) when there
+  // are already as many as their field of the key can tell apart
+  // submit() refuses an id too large for its field and a NaN depth, flush()
+  // skips the packets whose ids were not added
+  // The program needs a mat4 model_matrix uniform, normal_matrix (mat3) is optional
+  std::uint32_t addProgram(ShaderProgram& program);
+  std::uint32_t addMaterial(const DrawMaterial& material);
+  std::uint32_t addMesh(const VertexArray& vertex_array);
+  // Called by flush() before the first draw of each pass (blending, ...)
+  void setPassCallback(std::function<void(std::uint32_t)> pass_callback);
+
+  void reserve(std::size_t n_draws);
+  void submit(std::uint32_t pass, std::uint32_t program, std::uint32_t material, std::uint32_t mesh, float depth, const glm::mat4& model_matrix);
+  void submit(const DrawPacket& packet);
+  // All the packets of a buffer, recorded by another thread
+  void submit(const DrawCommandBuffer& command_buffer);
+  std::size_t size() const;
+
+  // Sort the packets by key (flush does it when needed)
+  void sort();
+  // Draw the packets, sorted or not, then empty the queue
+  void flush(Order order = Order::Sorted);
+  // Empty the queue without drawing
+  void clear();
+  DrawQueueStats getStats() const;
+};
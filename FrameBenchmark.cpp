@@ -0,0 +1,339 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <utility>
+
+#include "FrameBenchmark.hpp"
+
+namespace {
+
+// the renderer string may contain anything
+std::string escapeJson(const std::string& text)
+{
+  std::string escaped{};
+  for (char c : text)
+  {
+    if (c == '"' || c == '\\')
+    {
+      escaped += '\\';
+    }
+    escaped += c;
+  }
+  return escaped;
+}
+
+// one measure (member of the records) of all the frames
+template <typename Record, typename Member>
+std::vector<double> collect(const std::vector<Record>& record_list, Member Record::* member)
+{
+  std::vector<double> value_list{};
+  value_list.reserve(record_list.size());
+  for (const auto& record : record_list)
+  {
+    value_list.push_back(static_cast<double>(record.*member));
+  }
+  return value_list;
+}
+
+// the frames without a measure (negative value) are left out of the statistics
+std::vector<double> withoutMissing(std::vector<double> value_list)
+{
+  value_list.erase(std::remove_if(value_list.begin(), value_list.end(), [](double value) { return value < 0.0; }), value_list.end());
+  return value_list;
+}
+
+void printStatistics(const char* name, const FrameStatistics& statistics, const char* unit)
+{
+  std::cout << "  " << name << ": " << statistics.p50 << unit << " p50, "
+    << statistics.p95 << unit << " p95, " << statistics.p99 << unit << " p99 (mean "
+    << statistics.mean << ", min " << statistics.min << ", max " << statistics.max << ")" << std::endl;
+}
+
+void writeStatistics(std::ofstream& file, const char* name, const FrameStatistics& statistics)
+{
+  file << "  \"" << name << "\": {\"mean\": " << statistics.mean
+    << ", \"min\": " << statistics.min << ", \"max\": " << statistics.max
+    << ", \"p50\": " << statistics.p50 << ", \"p95\": " << statistics.p95
+    << ", \"p99\": " << statistics.p99 << "},\n";
+}
+
+}
+
+FrameBenchmarkOptions FrameBenchmarkOptions::fromCommandLine(int argc, char* argv[], const std::string& scene_name)
+{
+  FrameBenchmarkOptions options{};
+  options.scene_name = scene_name;
+
+  for (int i = 1; i + 1 < argc; i++)
+  {
+    if (std::strcmp(argv[i], "--benchmark") == 0)
+    {
+      options.n_frames = std::strtoul(argv[++i], nullptr, 10);
+    }
+    else if (std::strcmp(argv[i], "--benchmark-warmup") == 0)
+    {
+      options.n_warmup_frames = std::strtoul(argv[++i], nullptr, 10);
+    }
+    else if (std::strcmp(argv[i], "--benchmark-output") == 0)
+    {
+      options.output_path = argv[++i];
+    }
+  }
+
+  return options;
+}
+
+FrameStatistics FrameStatistics::compute(std::vector<double> value_list)
+{
+  FrameStatistics statistics{};
+  if (value_list.empty())
+  {
+    return statistics;
+  }
+
+  std::sort(value_list.begin(), value_list.end());
+  const std::size_t n_values{value_list.size()};
+  // smallest value with at least percent % of the values below or equal
+  auto percentile = [&](double percent) {
+    const auto rank{static_cast<std::size_t>(std::ceil(percent / 100.0 * n_values))};
+    return value_list[std::clamp<std::size_t>(rank, 1, n_values) - 1];
+  };
+
+  statistics.mean = std::accumulate(value_list.begin(), value_list.end(), 0.0) / n_values;
+  statistics.min = value_list.front();
+  statistics.max = value_list.back();
+  statistics.p50 = percentile(50.0);
+  statistics.p95 = percentile(95.0);
+  statistics.p99 = percentile(99.0);
+  return statistics;
+}
+
+FrameBenchmark::FrameBenchmark(const FrameBenchmarkOptions& options, const CameraPath& camera_path) :
+  options_{options},
+  camera_path_{camera_path}
+{
+  query_record_list_.fill(no_frame_);
+  if (isEnabled())
+  {
+    record_list_.reserve(options_.n_frames);
+    glGenQueries(N_queries_, query_id_list_.data());
+  }
+}
+
+FrameBenchmark::~FrameBenchmark()
+{
+  if (isEnabled())
+  {
+    glDeleteQueries(N_queries_, query_id_list_.data());
+  }
+}
+
+bool FrameBenchmark::isEnabled() const
+{
+  return options_.n_frames > 0;
+}
+
+bool FrameBenchmark::isFinished() const
+{
+  return isEnabled() && frame_index_ >= options_.n_warmup_frames + options_.n_frames;
+}
+
+float FrameBenchmark::getTime() const
+{
+  return frame_index_ * options_.time_step;
+}
+
+float FrameBenchmark::getTimeStep() const
+{
+  return options_.time_step;
+}
+
+bool FrameBenchmark::isMeasured_() const
+{
+  return frame_index_ >= options_.n_warmup_frames;
+}
+
+void FrameBenchmark::readQuery_(std::size_t query_index, bool wait)
+{
+  // issued N_queries_ frames ago: the result is usually there, but
+  // GL_QUERY_RESULT would stall the frame until the GPU catches up
+  GLint is_available{GL_TRUE};
+  if (!wait)
+  {
+    glGetQueryObjectiv(query_id_list_[query_index], GL_QUERY_RESULT_AVAILABLE, &is_available);
+  }
+  if (is_available == GL_TRUE)
+  {
+    GLuint64 elapsed_time{0};
+    glGetQueryObjectui64v(query_id_list_[query_index], GL_QUERY_RESULT, &elapsed_time);
+    record_list_[query_record_list_[query_index]].gpu_time = elapsed_time / 1e6;
+  }
+  // else the query is reused anyway, the frame keeps no GPU time
+  query_record_list_[query_index] = no_frame_;
+}
+
+void FrameBenchmark::beginFrame(Camera& camera)
+{
+  if (!isEnabled())
+  {
+    return;
+  }
+
+  camera_path_.apply(getTime(), camera);
+  current_record_ = FrameRecord_{};
+  frame_begin_time_ = std::chrono::steady_clock::now();
+  // without warm up, the first frame time starts here
+  if (frame_index_ == 0)
+  {
+    last_frame_end_time_ = frame_begin_time_;
+  }
+
+  if (isMeasured_())
+  {
+    // the query used 4 frames ago is reused for this one
+    const std::size_t query_index{record_list_.size() % N_queries_};
+    if (query_record_list_[query_index] != no_frame_)
+    {
+      readQuery_(query_index, false);
+    }
+    glBeginQuery(GL_TIME_ELAPSED, query_id_list_[query_index]);
+    query_record_list_[query_index] = record_list_.size();
+  }
+}
+
+void FrameBenchmark::countDraws(std::size_t n_draws)
+{
+  current_record_.draw_calls += n_draws;
+}
+
+void FrameBenchmark::countStateChanges(std::size_t n_state_changes)
+{
+  current_record_.state_changes += n_state_changes;
+}
+
+void FrameBenchmark::endFrame(const ShaderStateStats& shader_stats)
+{
+  if (!isEnabled() || isFinished())
+  {
+    return;
+  }
+
+  const auto frame_end_time{std::chrono::steady_clock::now()};
+
+  if (isMeasured_())
+  {
+    glEndQuery(GL_TIME_ELAPSED);
+
+    std::chrono::duration<double, std::milli> cpu_duration{frame_end_time - frame_begin_time_};
+    std::chrono::duration<double, std::milli> frame_duration{frame_end_time - last_frame_end_time_};
+    current_record_.cpu_time = cpu_duration.count();
+    current_record_.frame_time = frame_duration.count();
+    // a program change is a state change too
+    current_record_.state_changes += shader_stats.use_calls;
+    current_record_.uniform_uploads = shader_stats.uniform_calls;
+    record_list_.push_back(current_record_);
+  }
+
+  last_frame_end_time_ = frame_end_time;
+  frame_index_++;
+}
+
+void FrameBenchmark::report()
+{
+  if (!isEnabled() || is_reported_)
+  {
+    return;
+  }
+  is_reported_ = true;
+
+  // the measure is over: the last frames can wait for their results
+  for (std::size_t i = 0; i < N_queries_; i++)
+  {
+    if (query_record_list_[i] != no_frame_)
+    {
+      readQuery_(i, true);
+    }
+  }
+
+  const auto* renderer{reinterpret_cast<const char*>(glGetString(GL_RENDERER))};
+  std::cout << "Benchmark " << options_.scene_name << ": " << record_list_.size() << " frames after "
+    << options_.n_warmup_frames << " warm up frames, " << (renderer != nullptr ? renderer : "unknown renderer") << std::endl;
+  if (record_list_.empty())
+  {
+    return;
+  }
+
+  printStatistics("frame", FrameStatistics::compute(collect(record_list_, &FrameRecord_::frame_time)), " ms");
+  printStatistics("CPU", FrameStatistics::compute(collect(record_list_, &FrameRecord_::cpu_time)), " ms");
+  const std::vector<double> gpu_time_list{collect(record_list_, &FrameRecord_::gpu_time)};
+  const std::vector<double> measured_gpu_time_list{withoutMissing(gpu_time_list)};
+  printStatistics("GPU", FrameStatistics::compute(measured_gpu_time_list), " ms");
+  if (measured_gpu_time_list.size() < gpu_time_list.size())
+  {
+    std::cout << "  GPU: " << gpu_time_list.size() - measured_gpu_time_list.size() << " frames without a result in time" << std::endl;
+  }
+  printStatistics("draw calls", FrameStatistics::compute(collect(record_list_, &FrameRecord_::draw_calls)), "");
+  printStatistics("state changes", FrameStatistics::compute(collect(record_list_, &FrameRecord_::state_changes)), "");
+  printStatistics("uniform uploads", FrameStatistics::compute(collect(record_list_, &FrameRecord_::uniform_uploads)), "");
+
+  if (!options_.output_path.empty())
+  {
+    writeJson_(renderer != nullptr ? renderer : "");
+  }
+}
+
+void FrameBenchmark::writeJson_(const std::string& renderer) const
+{
+  std::ofstream file{options_.output_path};
+  if (!file)
+  {
+    std::cout << "ERROR::FRAME_BENCHMARK::FILE_NOT_WRITTEN " << options_.output_path << std::endl;
+    return;
+  }
+
+  const std::vector<std::pair<const char*, std::vector<double>>> measure_list{
+    {"frame_ms", collect(record_list_, &FrameRecord_::frame_time)},
+    {"cpu_ms", collect(record_list_, &FrameRecord_::cpu_time)},
+    {"gpu_ms", collect(record_list_, &FrameRecord_::gpu_time)},
+    {"draw_calls", collect(record_list_, &FrameRecord_::draw_calls)},
+    {"state_changes", collect(record_list_, &FrameRecord_::state_changes)},
+    {"uniform_uploads", collect(record_list_, &FrameRecord_::uniform_uploads)}
+  };
+
+  file << "{\n";
+  file << "  \"scene\": \"" << escapeJson(options_.scene_name) << "\",\n";
+  file << "  \"renderer\": \"" << escapeJson(renderer) << "\",\n";
+  file << "  \"frames\": " << record_list_.size() << ",\n";
+  file << "  \"warmup_frames\": " << options_.n_warmup_frames << ",\n";
+  file << "  \"time_step\": " << options_.time_step << ",\n";
+  for (const auto& [name, value_list] : measure_list)
+  {
+    writeStatistics(file, name, FrameStatistics::compute(withoutMissing(value_list)));
+  }
+  // every frame, to compare two runs in detail
+  file << "  \"per_frame\": {\n";
+  for (std::size_t i = 0; i < measure_list.size(); i++)
+  {
+    file << "    \"" << measure_list[i].first << "\": [";
+    const auto& value_list{measure_list[i].second};
+    for (std::size_t j = 0; j < value_list.size(); j++)
+    {
+      file << (j > 0 ? ", " : "");
+      if (value_list[j] < 0.0)
+      {
+        file << "null";
+      }
+      else
+      {
+        file << value_list[j];
+      }
+    }
+    file << "]" << (i + 1 < measure_list.size() ? "," : "") << "\n";
+  }
+  file << "  }\n";
+  file << "}\n";
+}
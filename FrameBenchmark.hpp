@@ -0,0 +1,125 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "glad/glad.h"
+
+#include "Camera.hpp"
+#include "CameraPath.hpp"
+#include "ShaderProgram.hpp"
+
+// How a demo is benchmarked
+struct FrameBenchmarkOptions final {
+  // name of the demo in the report
+  std::string scene_name{"scene"};
+  // 0: no benchmark, the demo is interactive
+  std::size_t n_frames{0};
+  // frames rendered before the measures: uploads, program builds, caches, ...
+  std::size_t n_warmup_frames{30};
+  // time between two frames on the camera path (and for the animations),
+  // whatever the real frame rate, so each run renders the same frames
+  float time_step{1.0f / 60.0f};
+  // the report is also written in this JSON file, if any
+  std::string output_path{};
+
+  // --benchmark N [--benchmark-warmup N] [--benchmark-output report.json]
+  static FrameBenchmarkOptions fromCommandLine(int argc, char* argv[], const std::string& scene_name);
+};
+
+// Distribution of a measure over the frames of a benchmark
+struct FrameStatistics final {
+  double mean{0.0};
+  double min{0.0};
+  double max{0.0};
+  double p50{0.0};
+  double p95{0.0};
+  double p99{0.0};
+
+  // nearest rank percentiles
+  static FrameStatistics compute(std::vector<double> value_list);
+};
+
+/**
+ * Benchmark mode of a demo: the camera follows a scripted path at a fixed
+ * time step, for a fixed number of frames, and each frame is measured
+ *
+ * - frame: time between the end of two frames, what the user sees
+ * - CPU: time spent by the render loop to submit the frame, from
+ *   beginFrame to endFrame (without the buffer swap)
+ * - GPU: GL_TIME_ELAPSED query around the frame. The results are read
+ *   a few frames later, if they are available, so the measure never
+ *   waits for the GPU (a frame whose result is late has no GPU time)
+ * - draw calls and state changes (bind of a VAO, a texture, ...) counted
+ *   by the demo, glUseProgram and glUniform* counted by ShaderProgram
+ *
+ * FrameBenchmark benchmark{FrameBenchmarkOptions::fromCommandLine(argc, argv, "demo"), camera_path};
+ * while (!context.shouldClose() && !benchmark.isFinished()) {
+ *   benchmark.beginFrame(camera);
+ *   ... render, benchmark.countDraws(1) ...
+ *   benchmark.endFrame(ShaderProgram::takeFrameStats());
+ *   context.endFrame();
+ * }
+ * benchmark.report();
+ *
+ * Without --benchmark all the functions do nothing, so the demo keeps
+ * the same loop when it is interactive
+ */
+class FrameBenchmark final {
+private:
+  struct FrameRecord_ {
+    double frame_time{0.0};
+    double cpu_time{0.0};
+    // negative: the query had no result yet when it was read
+    double gpu_time{-1.0};
+    std::size_t draw_calls{0};
+    std::size_t state_changes{0};
+    std::size_t uniform_uploads{0};
+  };
+  // a query is read N_queries_ frames after it was issued
+  static constexpr std::size_t N_queries_{4};
+  static constexpr std::size_t no_frame_{static_cast<std::size_t>(-1)};
+
+  FrameBenchmarkOptions options_;
+  CameraPath camera_path_;
+  // index of the current frame, warm up included
+  std::size_t frame_index_{0};
+  std::vector<FrameRecord_> record_list_;
+  FrameRecord_ current_record_{};
+  std::array<GLuint, N_queries_> query_id_list_{};
+  // record waiting for the result of each query
+  std::array<std::size_t, N_queries_> query_record_list_{};
+  std::chrono::steady_clock::time_point frame_begin_time_;
+  std::chrono::steady_clock::time_point last_frame_end_time_;
+  bool is_reported_{false};
+
+  bool isMeasured_() const;
+  // wait: block until the result is there, else drop it if it is late
+  void readQuery_(std::size_t query_index, bool wait);
+  void writeJson_(const std::string& renderer) const;
+public:
+  FrameBenchmark(const FrameBenchmarkOptions& options, const CameraPath& camera_path);
+  ~FrameBenchmark();
+  FrameBenchmark(const FrameBenchmark&) = delete;
+  FrameBenchmark& operator=(const FrameBenchmark&) = delete;
+
+  bool isEnabled() const;
+  // all the frames were measured
+  bool isFinished() const;
+  // time of the current frame on the path, in seconds
+  float getTime() const;
+  float getTimeStep() const;
+
+  // Place the camera on the path and start measuring the frame
+  void beginFrame(Camera& camera);
+  void countDraws(std::size_t n_draws = 1);
+  void countStateChanges(std::size_t n_state_changes = 1);
+  // shader_stats: the counters of ShaderProgram for this frame
+  void endFrame(const ShaderStateStats& shader_stats);
+
+  // Print the statistics (and write the JSON file), once the benchmark is finished
+  void report();
+};
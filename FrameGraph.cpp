@@ -0,0 +1,695 @@
+#include <algorithm>
+#include <iostream>
+
+#include "FrameGraph.hpp"
+
+namespace {
+
+// pixel format and type given to glTexImage2D (without data)
+void getUploadFormat(GLenum internal_format, GLenum& format, GLenum& type)
+{
+  switch (internal_format)
+  {
+    case GL_DEPTH_COMPONENT16:
+    case GL_DEPTH_COMPONENT24:
+    case GL_DEPTH_COMPONENT32F:
+      format = GL_DEPTH_COMPONENT;
+      type = GL_FLOAT;
+      return;
+    case GL_DEPTH24_STENCIL8:
+      format = GL_DEPTH_STENCIL;
+      type = GL_UNSIGNED_INT_24_8;
+      return;
+    case GL_R8:
+    case GL_R16F:
+    case GL_R32F:
+      format = GL_RED;
+      type = GL_FLOAT;
+      return;
+    case GL_RG8:
+    case GL_RG16F:
+    case GL_RG32F:
+      format = GL_RG;
+      type = GL_FLOAT;
+      return;
+    default:
+      format = GL_RGBA;
+      type = GL_FLOAT;
+  }
+}
+
+}
+
+bool RenderTargetDesc::operator==(const RenderTargetDesc& other) const
+{
+  return width == other.width && height == other.height && internal_format == other.internal_format;
+}
+
+bool RenderTargetDesc::isDepth() const
+{
+  return internal_format == GL_DEPTH_COMPONENT16 || internal_format == GL_DEPTH_COMPONENT24
+    || internal_format == GL_DEPTH_COMPONENT32F || internal_format == GL_DEPTH24_STENCIL8;
+}
+
+std::size_t RenderTargetDesc::getByteSize() const
+{
+  std::size_t pixel_size{4};
+  switch (internal_format)
+  {
+    case GL_R8: pixel_size = 1; break;
+    case GL_R16F: case GL_RG8: case GL_DEPTH_COMPONENT16: pixel_size = 2; break;
+    case GL_RGBA16F: case GL_RG32F: pixel_size = 8; break;
+    case GL_RGBA32F: pixel_size = 16; break;
+    default: break;
+  }
+  return static_cast<std::size_t>(width) * height * pixel_size;
+}
+
+FrameGraphPassBuilder::FrameGraphPassBuilder(FrameGraph& frame_graph, std::uint32_t pass_index) :
+  frame_graph_{frame_graph},
+  pass_index_{pass_index}
+{
+}
+
+FrameGraphPassBuilder& FrameGraphPassBuilder::read(RenderTargetHandle target)
+{
+  frame_graph_.pass_list_[pass_index_].read_list.push_back(target.index);
+  frame_graph_.is_compiled_ = false;
+  return *this;
+}
+
+FrameGraphPassBuilder& FrameGraphPassBuilder::writeColor(RenderTargetHandle target, std::optional<glm::vec4> clear_color)
+{
+  frame_graph_.pass_list_[pass_index_].write_list.push_back({target.index, false, clear_color, std::nullopt});
+  frame_graph_.is_compiled_ = false;
+  return *this;
+}
+
+FrameGraphPassBuilder& FrameGraphPassBuilder::writeDepth(RenderTargetHandle target, std::optional<float> clear_depth)
+{
+  frame_graph_.pass_list_[pass_index_].write_list.push_back({target.index, true, std::nullopt, clear_depth});
+  frame_graph_.is_compiled_ = false;
+  return *this;
+}
+
+FrameGraphPassBuilder& FrameGraphPassBuilder::keep()
+{
+  frame_graph_.pass_list_[pass_index_].is_kept = true;
+  frame_graph_.is_compiled_ = false;
+  return *this;
+}
+
+FrameGraph::~FrameGraph()
+{
+  release_();
+}
+
+RenderTargetHandle FrameGraph::importFramebuffer(const std::string& name, GLuint framebuffer_id, int width, int height)
+{
+  Target_ target{name, RenderTargetDesc{width, height, GL_NONE}};
+  target.is_imported = true;
+  target.imported_framebuffer_id = framebuffer_id;
+  target_list_.push_back(target);
+  is_compiled_ = false;
+  return RenderTargetHandle{static_cast<std::uint32_t>(target_list_.size() - 1)};
+}
+
+RenderTargetHandle FrameGraph::createRenderTarget(const std::string& name, const RenderTargetDesc& desc)
+{
+  target_list_.push_back(Target_{name, desc});
+  is_compiled_ = false;
+  return RenderTargetHandle{static_cast<std::uint32_t>(target_list_.size() - 1)};
+}
+
+FrameGraphPassBuilder FrameGraph::addPass(const std::string& name, std::function<void(const FrameGraph&)> execute)
+{
+  pass_list_.push_back(Pass_{name, std::move(execute)});
+  is_compiled_ = false;
+  return FrameGraphPassBuilder{*this, static_cast<std::uint32_t>(pass_list_.size() - 1)};
+}
+
+void FrameGraph::release_()
+{
+  for (const auto& [attachment_list, framebuffer_id] : framebuffer_map_)
+  {
+    glDeleteFramebuffers(1, &framebuffer_id);
+  }
+  framebuffer_map_.clear();
+  for (const auto& texture : texture_list_)
+  {
+    glDeleteTextures(1, &texture.id);
+  }
+  texture_list_.clear();
+  schedule_.clear();
+  stats_ = FrameGraphStats{};
+  is_compiled_ = false;
+}
+
+std::vector<std::uint32_t> FrameGraph::getWrittenTargets_(const Pass_& pass) const
+{
+  std::vector<std::uint32_t> written_target_list{};
+  for (const auto& write : pass.write_list)
+  {
+    written_target_list.push_back(write.target);
+  }
+  return written_target_list;
+}
+
+void FrameGraph::cull_()
+{
+  // reference counts: the readers of each target (an imported framebuffer
+  // is read outside of the graph) and the outputs of each pass still used
+  for (auto& target : target_list_)
+  {
+    target.n_readers = target.is_imported ? 1 : 0;
+  }
+  for (auto& pass : pass_list_)
+  {
+    pass.is_culled = false;
+    pass.n_used_writes = pass.write_list.size();
+    for (std::uint32_t target : pass.read_list)
+    {
+      target_list_[target].n_readers++;
+    }
+  }
+
+  std::vector<std::uint32_t> unused_target_list{};
+  for (std::uint32_t i = 0; i < target_list_.size(); i++)
+  {
+    if (target_list_[i].n_readers == 0)
+    {
+      unused_target_list.push_back(i);
+    }
+  }
+
+  // a pass whose outputs are all unused is culled, and the targets it read
+  // lose a reader: the passes writing them may become useless in turn
+  while (!unused_target_list.empty())
+  {
+    const std::uint32_t unused_target{unused_target_list.back()};
+    unused_target_list.pop_back();
+
+    for (auto& pass : pass_list_)
+    {
+      if (pass.is_culled || pass.is_kept)
+      {
+        continue;
+      }
+      for (const auto& write : pass.write_list)
+      {
+        if (write.target == unused_target && --pass.n_used_writes == 0)
+        {
+          pass.is_culled = true;
+          for (std::uint32_t target : pass.read_list)
+          {
+            if (--target_list_[target].n_readers == 0)
+            {
+              unused_target_list.push_back(target);
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+void FrameGraph::schedulePasses_()
+{
+  // b depends on a (declared before it) when b reads what a writes, or
+  // writes what a reads or writes: their order must be kept
+  const std::size_t n_passes{pass_list_.size()};
+  std::vector<std::vector<std::uint32_t>> dependency_list(n_passes);
+  for (std::uint32_t b = 0; b < n_passes; b++)
+  {
+    if (pass_list_[b].is_culled)
+    {
+      continue;
+    }
+    const auto b_written{getWrittenTargets_(pass_list_[b])};
+    for (std::uint32_t a = 0; a < b; a++)
+    {
+      if (pass_list_[a].is_culled)
+      {
+        continue;
+      }
+      const auto a_written{getWrittenTargets_(pass_list_[a])};
+      auto is_in = [](const std::vector<std::uint32_t>& list, std::uint32_t target) {
+        return std::find(list.begin(), list.end(), target) != list.end();
+      };
+      bool is_dependent{false};
+      for (std::uint32_t target : pass_list_[b].read_list)
+      {
+        is_dependent = is_dependent || is_in(a_written, target);
+      }
+      for (std::uint32_t target : b_written)
+      {
+        is_dependent = is_dependent || is_in(a_written, target) || is_in(pass_list_[a].read_list, target);
+      }
+      if (is_dependent)
+      {
+        dependency_list[b].push_back(a);
+      }
+    }
+  }
+
+  // Among the passes whose dependencies are done, take the first one
+  // writing the same targets as the last pass, else the first declared
+  std::vector<bool> is_scheduled(n_passes, false);
+  std::vector<std::uint32_t> last_written{};
+  schedule_.clear();
+  while (true)
+  {
+    int chosen{-1};
+    for (std::uint32_t i = 0; i < n_passes; i++)
+    {
+      if (pass_list_[i].is_culled || is_scheduled[i])
+      {
+        continue;
+      }
+      const bool is_ready{std::all_of(dependency_list[i].begin(), dependency_list[i].end(), [&](std::uint32_t a) { return is_scheduled[a]; })};
+      if (!is_ready)
+      {
+        continue;
+      }
+      if (chosen == -1)
+      {
+        chosen = static_cast<int>(i);
+      }
+      if (!schedule_.empty() && getWrittenTargets_(pass_list_[i]) == last_written)
+      {
+        chosen = static_cast<int>(i);
+        break;
+      }
+    }
+    if (chosen == -1)
+    {
+      break;
+    }
+    is_scheduled[chosen] = true;
+    schedule_.push_back(static_cast<std::uint32_t>(chosen));
+    last_written = getWrittenTargets_(pass_list_[chosen]);
+  }
+}
+
+void FrameGraph::allocateTextures_()
+{
+  // lifetime of each target: from its first pass to its last one
+  for (auto& target : target_list_)
+  {
+    target.first_use = -1;
+    target.last_use = -1;
+  }
+  for (int position = 0; position < static_cast<int>(schedule_.size()); position++)
+  {
+    const auto& pass{pass_list_[schedule_[position]]};
+    auto use = [&](std::uint32_t index) {
+      auto& target{target_list_[index]};
+      target.first_use = target.first_use == -1 ? position : target.first_use;
+      target.last_use = position;
+    };
+    for (std::uint32_t target : pass.read_list)
+    {
+      use(target);
+    }
+    for (const auto& write : pass.write_list)
+    {
+      use(write.target);
+    }
+  }
+
+  std::vector<std::uint32_t> transient_list{};
+  for (std::uint32_t i = 0; i < target_list_.size(); i++)
+  {
+    if (!target_list_[i].is_imported && target_list_[i].first_use != -1)
+    {
+      transient_list.push_back(i);
+    }
+  }
+  std::sort(transient_list.begin(), transient_list.end(), [&](std::uint32_t a, std::uint32_t b) {
+    return target_list_[a].first_use < target_list_[b].first_use;
+  });
+
+  // the textures are created on the active unit: its texture is bound
+  // again at the end, the application may have bound it before compile()
+  GLint previous_texture_id{0};
+  glGetIntegerv(GL_TEXTURE_BINDING_2D, &previous_texture_id);
+
+  // A texture is reused by a target of the same size and format whose
+  // first pass comes after the last pass of the previous target
+  std::vector<int> texture_last_use{};
+  for (std::uint32_t index : transient_list)
+  {
+    auto& target{target_list_[index]};
+    stats_.n_render_targets++;
+    stats_.unaliased_bytes += target.desc.getByteSize();
+
+    std::size_t texture_index{0};
+    while (texture_index < texture_list_.size()
+      && !(texture_list_[texture_index].desc == target.desc && texture_last_use[texture_index] < target.first_use))
+    {
+      texture_index++;
+    }
+
+    if (texture_index == texture_list_.size())
+    {
+      GLenum format{GL_RGBA};
+      GLenum type{GL_FLOAT};
+      getUploadFormat(target.desc.internal_format, format, type);
+
+      Texture_ texture{target.desc, 0};
+      glGenTextures(1, &texture.id);
+      glBindTexture(GL_TEXTURE_2D, texture.id);
+      glTexImage2D(GL_TEXTURE_2D, 0, target.desc.internal_format, target.desc.width, target.desc.height, 0, format, type, nullptr);
+      const GLint filter{target.desc.isDepth() ? GL_NEAREST : GL_LINEAR};
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+      texture_list_.push_back(texture);
+      texture_last_use.push_back(-1);
+      stats_.allocated_bytes += target.desc.getByteSize();
+    }
+
+    target.texture_index = texture_index;
+    texture_last_use[texture_index] = target.last_use;
+  }
+  glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(previous_texture_id));
+  stats_.n_textures = texture_list_.size();
+}
+
+bool FrameGraph::createFramebuffers_()
+{
+  for (std::uint32_t pass_index : schedule_)
+  {
+    auto& pass{pass_list_[pass_index]};
+    if (pass.write_list.empty())
+    {
+      std::cout << "ERROR::FRAME_GRAPH::PASS_WITHOUT_OUTPUT " << pass.name << std::endl;
+      return false;
+    }
+
+    // an imported framebuffer is used as it is
+    const auto& first_target{target_list_[pass.write_list.front().target]};
+    pass.width = first_target.desc.width;
+    pass.height = first_target.desc.height;
+    if (first_target.is_imported)
+    {
+      for (const auto& write : pass.write_list)
+      {
+        if (write.target != pass.write_list.front().target)
+        {
+          std::cout << "ERROR::FRAME_GRAPH::IMPORTED_FRAMEBUFFER_WITH_OTHER_TARGETS " << pass.name << std::endl;
+          return false;
+        }
+      }
+      pass.framebuffer_id = first_target.imported_framebuffer_id;
+      continue;
+    }
+
+    // the colors in the order of the writes, then the depth (or 0)
+    std::vector<GLuint> attachment_list{};
+    GLuint depth_texture_id{0};
+    GLenum depth_attachment{GL_DEPTH_ATTACHMENT};
+    for (const auto& write : pass.write_list)
+    {
+      const auto& target{target_list_[write.target]};
+      if (target.is_imported)
+      {
+        std::cout << "ERROR::FRAME_GRAPH::IMPORTED_FRAMEBUFFER_WITH_OTHER_TARGETS " << pass.name << std::endl;
+        return false;
+      }
+      if (write.is_depth != target.desc.isDepth())
+      {
+        std::cout << "ERROR::FRAME_GRAPH::WRONG_ATTACHMENT_FORMAT " << pass.name << " writes " << target.name << std::endl;
+        return false;
+      }
+      const GLuint texture_id{texture_list_[target.texture_index].id};
+      if (write.is_depth)
+      {
+        depth_texture_id = texture_id;
+        depth_attachment = target.desc.internal_format == GL_DEPTH24_STENCIL8 ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+      }
+      else
+      {
+        attachment_list.push_back(texture_id);
+      }
+    }
+    const std::size_t n_colors{attachment_list.size()};
+    attachment_list.push_back(depth_texture_id);
+
+    auto found{framebuffer_map_.find(attachment_list)};
+    if (found != framebuffer_map_.end())
+    {
+      pass.framebuffer_id = found->second;
+      continue;
+    }
+
+    GLuint framebuffer_id{0};
+    glGenFramebuffers(1, &framebuffer_id);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_id);
+    std::vector<GLenum> draw_buffer_list{};
+    for (std::size_t i = 0; i < n_colors; i++)
+    {
+      glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_2D, attachment_list[i], 0);
+      draw_buffer_list.push_back(GL_COLOR_ATTACHMENT0 + i);
+    }
+    if (depth_texture_id != 0)
+    {
+      glFramebufferTexture2D(GL_FRAMEBUFFER, depth_attachment, GL_TEXTURE_2D, depth_texture_id, 0);
+    }
+    // a depth only framebuffer (shadow map) has no color to draw nor read
+    if (n_colors == 0)
+    {
+      glDrawBuffer(GL_NONE);
+      glReadBuffer(GL_NONE);
+    }
+    else
+    {
+      glDrawBuffers(static_cast<GLsizei>(n_colors), draw_buffer_list.data());
+    }
+    const GLenum status{glCheckFramebufferStatus(GL_FRAMEBUFFER)};
+    framebuffer_map_[attachment_list] = framebuffer_id;
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+    {
+      std::cout << "ERROR::FRAME_GRAPH::FRAMEBUFFER_INCOMPLETE " << pass.name << " (0x" << std::hex << status << std::dec << ")" << std::endl;
+      return false;
+    }
+    pass.framebuffer_id = framebuffer_id;
+  }
+
+  stats_.n_framebuffers = framebuffer_map_.size();
+  return true;
+}
+
+bool FrameGraph::compile()
+{
+  release_();
+
+  // a target can only be read once written, and written as an attachment
+  for (std::uint32_t i = 0; i < pass_list_.size(); i++)
+  {
+    for (std::uint32_t target : pass_list_[i].read_list)
+    {
+      const bool is_written_before{std::any_of(pass_list_.begin(), pass_list_.begin() + i, [&](const Pass_& pass) {
+        return std::any_of(pass.write_list.begin(), pass.write_list.end(), [&](const Write_& write) { return write.target == target; });
+      })};
+      if (target_list_[target].is_imported || !is_written_before)
+      {
+        std::cout << "ERROR::FRAME_GRAPH::READ_BEFORE_WRITE " << pass_list_[i].name << " reads " << target_list_[target].name << std::endl;
+        return false;
+      }
+    }
+  }
+
+  cull_();
+  schedulePasses_();
+  allocateTextures_();
+  // the framebuffers are bound to be created: bind the one of the
+  // application again (not 0, headless the default one is an FBO)
+  GLint previous_framebuffer_id{0};
+  glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previous_framebuffer_id);
+  const bool is_created{createFramebuffers_()};
+  glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(previous_framebuffer_id));
+  if (!is_created)
+  {
+    release_();
+    return false;
+  }
+
+  stats_.n_passes = pass_list_.size();
+  stats_.n_culled_passes = pass_list_.size() - schedule_.size();
+  is_compiled_ = true;
+
+  // the binds and the clears of a frame, as execute() does them
+  std::optional<GLuint> bound_framebuffer_id{};
+  for (std::uint32_t pass_index : schedule_)
+  {
+    const auto& pass{pass_list_[pass_index]};
+    if (bound_framebuffer_id != pass.framebuffer_id)
+    {
+      stats_.n_framebuffer_binds++;
+      bound_framebuffer_id = pass.framebuffer_id;
+    }
+    const bool has_clear{std::any_of(pass.write_list.begin(), pass.write_list.end(), [](const Write_& write) {
+      return write.clear_color.has_value() || write.clear_depth.has_value();
+    })};
+    stats_.n_clears += has_clear ? 1 : 0;
+  }
+
+  return true;
+}
+
+void FrameGraph::execute()
+{
+  if (!is_compiled_)
+  {
+    std::cout << "ERROR::FRAME_GRAPH::NOT_COMPILED" << std::endl;
+    return;
+  }
+
+  std::optional<GLuint> bound_framebuffer_id{};
+  for (std::uint32_t pass_index : schedule_)
+  {
+    const auto& pass{pass_list_[pass_index]};
+
+    // consecutive passes writing the same targets keep the framebuffer
+    if (bound_framebuffer_id != pass.framebuffer_id)
+    {
+      glBindFramebuffer(GL_FRAMEBUFFER, pass.framebuffer_id);
+      glViewport(0, 0, pass.width, pass.height);
+      bound_framebuffer_id = pass.framebuffer_id;
+    }
+
+    // one glClear for all the attachments when they are all cleared to the
+    // same color, else one glClearBuffer per attachment
+    std::size_t n_colors{0};
+    std::vector<std::pair<GLint, glm::vec4>> clear_color_list{};
+    std::optional<float> clear_depth{};
+    for (const auto& write : pass.write_list)
+    {
+      if (!write.is_depth)
+      {
+        if (write.clear_color.has_value())
+        {
+          clear_color_list.emplace_back(static_cast<GLint>(n_colors), *write.clear_color);
+        }
+        n_colors++;
+      }
+      if (write.clear_depth.has_value())
+      {
+        clear_depth = write.clear_depth;
+      }
+    }
+
+    const bool is_same_color{std::all_of(clear_color_list.begin(), clear_color_list.end(), [&](const auto& clear) {
+      return clear.second == clear_color_list.front().second;
+    })};
+    if (clear_color_list.size() == n_colors && is_same_color)
+    {
+      GLbitfield clear_mask{0};
+      if (!clear_color_list.empty())
+      {
+        const glm::vec4& color{clear_color_list.front().second};
+        glClearColor(color.r, color.g, color.b, color.a);
+        clear_mask |= GL_COLOR_BUFFER_BIT;
+      }
+      if (clear_depth.has_value())
+      {
+        glClearDepth(*clear_depth);
+        clear_mask |= GL_DEPTH_BUFFER_BIT;
+      }
+      if (clear_mask != 0)
+      {
+        glClear(clear_mask);
+      }
+    }
+    else
+    {
+      for (const auto& [draw_buffer, color] : clear_color_list)
+      {
+        glClearBufferfv(GL_COLOR, draw_buffer, &color[0]);
+      }
+      if (clear_depth.has_value())
+      {
+        glClearBufferfv(GL_DEPTH, 0, &*clear_depth);
+      }
+    }
+
+    pass.execute(*this);
+  }
+}
+
+GLuint FrameGraph::getTexture(RenderTargetHandle target) const
+{
+  const auto& render_target{target_list_[target.index]};
+  if (render_target.is_imported || render_target.first_use == -1 || !is_compiled_)
+  {
+    return 0;
+  }
+  return texture_list_[render_target.texture_index].id;
+}
+
+bool FrameGraph::isCulled(const std::string& pass_name) const
+{
+  for (const auto& pass : pass_list_)
+  {
+    if (pass.name == pass_name)
+    {
+      return pass.is_culled;
+    }
+  }
+  return false;
+}
+
+const FrameGraphStats& FrameGraph::getStats() const
+{
+  return stats_;
+}
+
+void FrameGraph::print() const
+{
+  std::cout << "Frame graph: " << stats_.n_passes << " passes (" << stats_.n_culled_passes << " culled), "
+    << stats_.n_render_targets << " render targets in " << stats_.n_textures << " textures ("
+    << stats_.allocated_bytes / 1024 << " KB instead of " << stats_.unaliased_bytes / 1024 << " KB), "
+    << stats_.n_framebuffers << " framebuffers" << std::endl;
+
+  auto print_target = [&](std::uint32_t index) {
+    const auto& target{target_list_[index]};
+    std::cout << target.name;
+    if (!target.is_imported)
+    {
+      std::cout << " [texture " << target.texture_index << "]";
+    }
+  };
+  for (std::size_t i = 0; i < schedule_.size(); i++)
+  {
+    const auto& pass{pass_list_[schedule_[i]]};
+    std::cout << "  " << i + 1 << ". " << pass.name << ":";
+    for (std::size_t j = 0; j < pass.read_list.size(); j++)
+    {
+      std::cout << (j == 0 ? " " : ", ");
+      print_target(pass.read_list[j]);
+    }
+    std::cout << " ->";
+    for (std::size_t j = 0; j < pass.write_list.size(); j++)
+    {
+      const auto& write{pass.write_list[j]};
+      std::cout << (j == 0 ? " " : ", ");
+      print_target(write.target);
+      if (write.clear_color.has_value() || write.clear_depth.has_value())
+      {
+        std::cout << " (cleared)";
+      }
+    }
+    std::cout << std::endl;
+  }
+  for (const auto& pass : pass_list_)
+  {
+    if (pass.is_culled)
+    {
+      std::cout << "  culled: " << pass.name << std::endl;
+    }
+  }
+  std::cout << "  per frame: " << stats_.n_framebuffer_binds << " framebuffer binds, "
+    << stats_.n_clears << " clears" << std::endl;
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "glad/glad.h"
+#include "glm/glm.hpp"
+
+// Size and format of a render target: GL_RGBA8, GL_RGBA16F,
+// GL_DEPTH_COMPONENT24, GL_DEPTH24_STENCIL8, ...
+struct RenderTargetDesc final {
+  int width;
+  int height;
+  GLenum internal_format;
+
+  bool operator==(const RenderTargetDesc& other) const;
+  bool isDepth() const;
+  std::size_t getByteSize() const;
+};
+
+// A render target declared in a frame graph
+struct RenderTargetHandle final {
+  std::uint32_t index;
+};
+
+// What the frame graph did with the passes and the targets (see FrameGraph::compile)
+struct FrameGraphStats final {
+  std::size_t n_passes{0};
+  std::size_t n_culled_passes{0};
+  std::size_t n_render_targets{0};
+  // textures really allocated, after aliasing
+  std::size_t n_textures{0};
+  std::size_t n_framebuffers{0};
+  // memory of the transient targets, without and with aliasing
+  std::size_t unaliased_bytes{0};
+  std::size_t allocated_bytes{0};
+  // per frame
+  std::size_t n_framebuffer_binds{0};
+  std::size_t n_clears{0};
+};
+
+class FrameGraph;
+
+// Declare what a pass reads and writes (see FrameGraph::addPass)
+class FrameGraphPassBuilder final {
+private:
+  FrameGraph& frame_graph_;
+  std::uint32_t pass_index_;
+public:
+  FrameGraphPassBuilder(FrameGraph& frame_graph, std::uint32_t pass_index);
+  // sampled as a texture by the pass
+  FrameGraphPassBuilder& read(RenderTargetHandle target);
+  // attached to the framebuffer of the pass, cleared before the pass if a value is given
+  FrameGraphPassBuilder& writeColor(RenderTargetHandle target, std::optional<glm::vec4> clear_color = std::nullopt);
+  FrameGraphPassBuilder& writeDepth(RenderTargetHandle target, std::optional<float> clear_depth = std::nullopt);
+  // never culled, even if nothing reads what it writes
+  FrameGraphPassBuilder& keep();
+};
+
+/**
+ * Frame graph: the passes of a frame declare the render targets they read
+ * (as textures) and write (as attachments of their framebuffer), and the
+ * graph finds out, once in compile():
+ *
+ * - the passes to cull: those whose outputs are never read, directly or
+ *   through other passes, before reaching an imported framebuffer (the screen)
+ * - the order of the passes: the order of declaration, except that a pass
+ *   writing the same framebuffer as the previous one is moved just after it
+ *   when no dependency prevents it, to save a framebuffer switch
+ * - the textures: a transient target only lives from its first to its
+ *   last pass, so targets of the same size and format whose lifetimes do
+ *   not overlap share the same texture (aliasing)
+ * - the framebuffers: one per set of attachments, so passes writing the
+ *   same targets share it, and consecutive passes do not bind it again
+ * - the clears: the attachments cleared by a pass are cleared together,
+ *   with one glClear when possible
+ *
+ * FrameGraph frame_graph{};
+ * auto screen{frame_graph.importFramebuffer("screen", context.getDefaultFramebuffer(), 800, 600)};
+ * auto shadow_map{frame_graph.createRenderTarget("shadow map", {1024, 1024, GL_DEPTH_COMPONENT24})};
+ * frame_graph.addPass("shadow map", [&](const FrameGraph&) { ... })
+ *   .writeDepth(shadow_map, 1.0f);
+ * frame_graph.addPass("scene", [&](const FrameGraph& graph) { glBindTexture(GL_TEXTURE_2D, graph.getTexture(shadow_map)); ... })
+ *   .read(shadow_map)
+ *   .writeColor(screen, glm::vec4(0.0f))
+ *   .writeDepth(screen, 1.0f);
+ * frame_graph.compile();
+ * while (...) frame_graph.execute();
+ *
+ * A transient target has no defined content before its first write in the
+ * frame (its texture may be shared): the first pass writing it should
+ * clear it, or cover all of it
+ * The pass functions only draw: the framebuffer, the viewport and the
+ * clears are set by the graph
+ */
+class FrameGraph final {
+private:
+  friend class FrameGraphPassBuilder;
+
+  struct Target_ {
+    std::string name;
+    RenderTargetDesc desc;
+    // imported framebuffer (the screen, ...): not owned, never culled
+    bool is_imported{false};
+    GLuint imported_framebuffer_id{0};
+    // compile() results
+    std::size_t n_readers{0};
+    int first_use{-1};
+    int last_use{-1};
+    std::size_t texture_index{0};
+  };
+  struct Write_ {
+    std::uint32_t target;
+    bool is_depth;
+    std::optional<glm::vec4> clear_color;
+    std::optional<float> clear_depth;
+  };
+  struct Pass_ {
+    std::string name;
+    std::function<void(const FrameGraph&)> execute;
+    std::vector<std::uint32_t> read_list{};
+    std::vector<Write_> write_list{};
+    bool is_kept{false};
+    // compile() results
+    bool is_culled{false};
+    std::size_t n_used_writes{0};
+    GLuint framebuffer_id{0};
+    int width{0};
+    int height{0};
+  };
+  // a texture, shared by the targets aliased on it
+  struct Texture_ {
+    RenderTargetDesc desc;
+    GLuint id;
+  };
+
+  std::vector<Target_> target_list_;
+  std::vector<Pass_> pass_list_;
+  // execution order, culled passes excluded
+  std::vector<std::uint32_t> schedule_;
+  std::vector<Texture_> texture_list_;
+  // attachments (texture ids, depth last) -> framebuffer
+  std::map<std::vector<GLuint>, GLuint> framebuffer_map_;
+  FrameGraphStats stats_{};
+  bool is_compiled_{false};
+
+  void release_();
+  void cull_();
+  void schedulePasses_();
+  void allocateTextures_();
+  bool createFramebuffers_();
+  // framebuffer key of a pass: the targets it writes
+  std::vector<std::uint32_t> getWrittenTargets_(const Pass_& pass) const;
+public:
+  FrameGraph() = default;
+  ~FrameGraph();
+  FrameGraph(const FrameGraph&) = delete;
+  FrameGraph& operator=(const FrameGraph&) = delete;
+
+  // A framebuffer created outside of the graph (0, the one of GLContext, ...)
+  RenderTargetHandle importFramebuffer(const std::string& name, GLuint framebuffer_id, int width, int height);
+  // A texture which only lives during the frame, allocated by compile()
+  RenderTargetHandle createRenderTarget(const std::string& name, const RenderTargetDesc& desc);
+  FrameGraphPassBuilder addPass(const std::string& name, std::function<void(const FrameGraph&)> execute);
+
+  // Cull, order, allocate: after the declarations, and again after any change
+  bool compile();
+  // Run the passes of the frame
+  void execute();
+
+  // texture of a target, for the passes reading it
+  GLuint getTexture(RenderTargetHandle target) const;
+  bool isCulled(const std::string& pass_name) const;
+  const FrameGraphStats& getStats() const;
+  // the passes in execution order, with their targets and textures
+  void print() const;
+};
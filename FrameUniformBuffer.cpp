@@ -0,0 +1,31 @@
+#include "FrameUniformBuffer.hpp"
+
+FrameUniformBuffer::FrameUniformBuffer()
+{
+  glGenBuffers(1, &id_);
+  glBindBuffer(GL_UNIFORM_BUFFER, id_);
+  // allocate the storage, it will be filled by update()
+  // GL_STREAM_DRAW: written once per frame, used a few times
+  glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniforms), NULL, GL_STREAM_DRAW);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+  // link the buffer to the binding point, the blocks of the programs
+  // will be linked to the same binding point
+  glBindBufferBase(GL_UNIFORM_BUFFER, binding_point, id_);
+}
+
+void FrameUniformBuffer::attach(ShaderProgram& shader_program)
+{
+  shader_program.bindUniformBlock("FrameUniforms", binding_point);
+}
+
+void FrameUniformBuffer::update(const FrameUniforms& frame_uniforms)
+{
+  glBindBuffer(GL_UNIFORM_BUFFER, id_);
+  // Orphan the previous storage: the driver can give us a fresh one
+  // instead of waiting for the draws of the last frame still reading it
+  // (persistent mapping would need OpenGL 4.4, we target 3.3)
+  glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniforms), NULL, GL_STREAM_DRAW);
+  glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameUniforms), &frame_uniforms);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
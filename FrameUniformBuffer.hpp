@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+
+#include "glad/glad.h"
+#include "glm/glm.hpp"
+
+#include "ShaderProgram.hpp"
+
+// C++ mirror of the std140 FrameUniforms block of the shaders:
+//
+// layout (std140) uniform FrameUniforms {
+//   mat4 view_matrix;
+//   mat4 projection_matrix;
+//   vec4 camera_pos;
+// };
+//
+// in std140 a mat4 is 4 vec4 columns (same as glm) and a vec3 is
+// aligned on 16 bytes, so we use a vec4 to make the padding explicit
+struct FrameUniforms {
+  glm::mat4 view_matrix;
+  glm::mat4 projection_matrix;
+  glm::vec4 camera_pos;
+};
+
+static_assert(sizeof(glm::mat4) == 64, "std140 mat4 is 64 bytes");
+static_assert(offsetof(FrameUniforms, view_matrix) == 0, "std140 offset of view_matrix");
+static_assert(offsetof(FrameUniforms, projection_matrix) == 64, "std140 offset of projection_matrix");
+static_assert(offsetof(FrameUniforms, camera_pos) == 128, "std140 offset of camera_pos");
+static_assert(sizeof(FrameUniforms) == 144, "std140 size of FrameUniforms");
+
+// Uniform Buffer Object holding the FrameUniforms
+// It is written once per frame and read by every program attached to it,
+// instead of uploading the same matrices to each program
+class FrameUniformBuffer final {
+private:
+  GLuint id_{0};
+public:
+  // binding point of the uniform buffer, shared by the block of all the programs
+  static constexpr GLuint binding_point{0};
+  FrameUniformBuffer();
+  // Make the FrameUniforms block of the program read this buffer
+  void attach(ShaderProgram& shader_program);
+  void update(const FrameUniforms& frame_uniforms);
+};
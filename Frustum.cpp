@@ -0,0 +1,35 @@
+#include "Frustum.hpp"
+
+Frustum extractFrustum(const glm::mat4& view_projection_matrix)
+{
+  // glm is column major: row i is made of the element i of each column
+  auto row = [&](int i) {
+    return glm::vec4(
+      view_projection_matrix[0][i],
+      view_projection_matrix[1][i],
+      view_projection_matrix[2][i],
+      view_projection_matrix[3][i]
+    );
+  };
+
+  const glm::vec4 row_x{row(0)};
+  const glm::vec4 row_y{row(1)};
+  const glm::vec4 row_z{row(2)};
+  const glm::vec4 row_w{row(3)};
+
+  Frustum frustum{};
+  // -w <= x is x + w >= 0, x <= w is w - x >= 0, ...
+  frustum.planes[Frustum::Left] = row_w + row_x;
+  frustum.planes[Frustum::Right] = row_w - row_x;
+  frustum.planes[Frustum::Bottom] = row_w + row_y;
+  frustum.planes[Frustum::Top] = row_w - row_y;
+  frustum.planes[Frustum::Near] = row_w + row_z;
+  frustum.planes[Frustum::Far] = row_w - row_z;
+
+  // normalize so the plane equation gives a distance
+  for (auto& plane : frustum.planes) {
+    plane /= glm::length(glm::vec3(plane));
+  }
+
+  return frustum;
+}
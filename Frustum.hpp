@@ -0,0 +1,26 @@
+#pragma once
+
+#include <array>
+
+#include "glm/glm.hpp"
+
+// The 6 planes of the visible volume of a camera, in world coordinates
+// A plane is (a, b, c, d) with a normalized normal (a, b, c) pointing
+// inside: dot(normal, p) + d is the signed distance of the point p,
+// and the point is inside the frustum when it is >= 0 for all the planes
+struct Frustum final {
+  enum Plane {
+    Left,
+    Right,
+    Bottom,
+    Top,
+    Near,
+    Far
+  };
+  std::array<glm::vec4, 6> planes;
+};
+
+// Extract the planes from a projection * view matrix (Gribb & Hartmann):
+// a point is visible when -w <= x, y, z <= w in clip space, each of these
+// 6 inequalities is a plane, combination of the rows of the matrix
+Frustum extractFrustum(const glm::mat4& view_projection_matrix);
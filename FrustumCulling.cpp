@@ -0,0 +1,259 @@
+#include <cmath>
+#include <iostream>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "FrustumCulling.hpp"
+
+std::size_t BoundingSpheres::add(const glm::vec3& center, float sphere_radius)
+{
+  center_x.push_back(center.x);
+  center_y.push_back(center.y);
+  center_z.push_back(center.z);
+  radius.push_back(sphere_radius);
+  return radius.size() - 1;
+}
+
+void BoundingSpheres::set(std::size_t id, const glm::vec3& center, float sphere_radius)
+{
+  center_x[id] = center.x;
+  center_y[id] = center.y;
+  center_z[id] = center.z;
+  radius[id] = sphere_radius;
+}
+
+void BoundingSpheres::reserve(std::size_t n_objects)
+{
+  center_x.reserve(n_objects);
+  center_y.reserve(n_objects);
+  center_z.reserve(n_objects);
+  radius.reserve(n_objects);
+}
+
+std::size_t BoundingSpheres::size() const
+{
+  return radius.size();
+}
+
+std::size_t BoundingBoxes::add(const glm::vec3& min_corner, const glm::vec3& max_corner)
+{
+  center_x.emplace_back();
+  center_y.emplace_back();
+  center_z.emplace_back();
+  extent_x.emplace_back();
+  extent_y.emplace_back();
+  extent_z.emplace_back();
+  set(size() - 1, min_corner, max_corner);
+  return size() - 1;
+}
+
+void BoundingBoxes::set(std::size_t id, const glm::vec3& min_corner, const glm::vec3& max_corner)
+{
+  const glm::vec3 center{0.5f * (min_corner + max_corner)};
+  const glm::vec3 extent{0.5f * (max_corner - min_corner)};
+  center_x[id] = center.x;
+  center_y[id] = center.y;
+  center_z[id] = center.z;
+  extent_x[id] = extent.x;
+  extent_y[id] = extent.y;
+  extent_z[id] = extent.z;
+}
+
+void BoundingBoxes::reserve(std::size_t n_objects)
+{
+  for (auto* component : {&center_x, &center_y, &center_z, &extent_x, &extent_y, &extent_z})
+  {
+    component->reserve(n_objects);
+  }
+}
+
+std::size_t BoundingBoxes::size() const
+{
+  return center_x.size();
+}
+
+namespace {
+
+// An object is outside when it is fully behind one plane:
+// signed distance of its center < -(its radius along the plane normal)
+// For a sphere this radius is the sphere radius, for a box it is
+// the projection of the half extents on the normal:
+// |normal.x| * extent.x + |normal.y| * extent.y + |normal.z| * extent.z
+bool isSphereVisible(const Frustum& frustum, const glm::vec3& center, float radius)
+{
+  for (const auto& plane : frustum.planes)
+  {
+    if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool isBoxVisible(const Frustum& frustum, const glm::vec3& center, const glm::vec3& extent)
+{
+  for (const auto& plane : frustum.planes)
+  {
+    const float radius{glm::dot(glm::abs(glm::vec3(plane)), extent)};
+    if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+#if defined(__SSE2__)
+// Append to visible_ids the ids first_id + lane of the lanes set in mask
+void appendVisible(int mask, std::size_t first_id, std::vector<std::uint32_t>& visible_ids)
+{
+  while (mask != 0)
+  {
+    const int lane{__builtin_ctz(mask)};
+    visible_ids.push_back(static_cast<std::uint32_t>(first_id + lane));
+    mask &= mask - 1;
+  }
+}
+#endif
+
+}
+
+CullingStats cullSpheres(const Frustum& frustum, const BoundingSpheres& spheres, std::vector<std::uint32_t>& visible_ids)
+{
+  return cullSpheres(frustum, spheres, 0, spheres.size(), visible_ids);
+}
+
+CullingStats cullSpheres(
+  const Frustum& frustum,
+  const BoundingSpheres& spheres,
+  std::size_t first_id,
+  std::size_t end_id,
+  std::vector<std::uint32_t>& visible_ids
+)
+{
+  visible_ids.clear();
+  // the loops below read the arrays up to end_id without any other check
+  if (first_id > end_id || end_id > spheres.size())
+  {
+    std::cout << "ERROR::FRUSTUM_CULLING::RANGE_OUT_OF_BOUNDS " << first_id << " " << end_id << std::endl;
+    return CullingStats{};
+  }
+  std::size_t i{first_id};
+
+#if defined(__SSE2__)
+  // plane coefficients broadcast to the 4 lanes, once for all the objects
+  __m128 plane_a[6];
+  __m128 plane_b[6];
+  __m128 plane_c[6];
+  __m128 plane_d[6];
+  for (int p = 0; p < 6; p++)
+  {
+    plane_a[p] = _mm_set1_ps(frustum.planes[p].x);
+    plane_b[p] = _mm_set1_ps(frustum.planes[p].y);
+    plane_c[p] = _mm_set1_ps(frustum.planes[p].z);
+    plane_d[p] = _mm_set1_ps(frustum.planes[p].w);
+  }
+
+  for (; i + 4 <= end_id; i += 4)
+  {
+    const __m128 x{_mm_loadu_ps(&spheres.center_x[i])};
+    const __m128 y{_mm_loadu_ps(&spheres.center_y[i])};
+    const __m128 z{_mm_loadu_ps(&spheres.center_z[i])};
+    const __m128 negative_radius{_mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(&spheres.radius[i]))};
+
+    // all bits set in the lanes still visible
+    __m128 visible{_mm_castsi128_ps(_mm_set1_epi32(-1))};
+    for (int p = 0; p < 6; p++)
+    {
+      const __m128 distance{_mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(plane_a[p], x), _mm_mul_ps(plane_b[p], y)),
+        _mm_add_ps(_mm_mul_ps(plane_c[p], z), plane_d[p])
+      )};
+      visible = _mm_and_ps(visible, _mm_cmpge_ps(distance, negative_radius));
+    }
+
+    appendVisible(_mm_movemask_ps(visible), i, visible_ids);
+  }
+#endif
+
+  for (; i < end_id; i++)
+  {
+    const glm::vec3 center{spheres.center_x[i], spheres.center_y[i], spheres.center_z[i]};
+    if (isSphereVisible(frustum, center, spheres.radius[i]))
+    {
+      visible_ids.push_back(static_cast<std::uint32_t>(i));
+    }
+  }
+
+  return CullingStats{visible_ids.size(), end_id - first_id - visible_ids.size()};
+}
+
+CullingStats cullBoxes(const Frustum& frustum, const BoundingBoxes& boxes, std::vector<std::uint32_t>& visible_ids)
+{
+  visible_ids.clear();
+  const std::size_t n_objects{boxes.size()};
+  std::size_t i{0};
+
+#if defined(__SSE2__)
+  __m128 plane_a[6];
+  __m128 plane_b[6];
+  __m128 plane_c[6];
+  __m128 plane_d[6];
+  // absolute values of the normal, to project the extents
+  __m128 plane_abs_a[6];
+  __m128 plane_abs_b[6];
+  __m128 plane_abs_c[6];
+  for (int p = 0; p < 6; p++)
+  {
+    plane_a[p] = _mm_set1_ps(frustum.planes[p].x);
+    plane_b[p] = _mm_set1_ps(frustum.planes[p].y);
+    plane_c[p] = _mm_set1_ps(frustum.planes[p].z);
+    plane_d[p] = _mm_set1_ps(frustum.planes[p].w);
+    plane_abs_a[p] = _mm_set1_ps(std::abs(frustum.planes[p].x));
+    plane_abs_b[p] = _mm_set1_ps(std::abs(frustum.planes[p].y));
+    plane_abs_c[p] = _mm_set1_ps(std::abs(frustum.planes[p].z));
+  }
+
+  for (; i + 4 <= n_objects; i += 4)
+  {
+    const __m128 x{_mm_loadu_ps(&boxes.center_x[i])};
+    const __m128 y{_mm_loadu_ps(&boxes.center_y[i])};
+    const __m128 z{_mm_loadu_ps(&boxes.center_z[i])};
+    const __m128 extent_x{_mm_loadu_ps(&boxes.extent_x[i])};
+    const __m128 extent_y{_mm_loadu_ps(&boxes.extent_y[i])};
+    const __m128 extent_z{_mm_loadu_ps(&boxes.extent_z[i])};
+
+    __m128 visible{_mm_castsi128_ps(_mm_set1_epi32(-1))};
+    for (int p = 0; p < 6; p++)
+    {
+      const __m128 distance{_mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(plane_a[p], x), _mm_mul_ps(plane_b[p], y)),
+        _mm_add_ps(_mm_mul_ps(plane_c[p], z), plane_d[p])
+      )};
+      const __m128 radius{_mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(plane_abs_a[p], extent_x), _mm_mul_ps(plane_abs_b[p], extent_y)),
+        _mm_mul_ps(plane_abs_c[p], extent_z)
+      )};
+      // distance >= -radius is distance + radius >= 0
+      visible = _mm_and_ps(visible, _mm_cmpge_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+    }
+
+    appendVisible(_mm_movemask_ps(visible), i, visible_ids);
+  }
+#endif
+
+  for (; i < n_objects; i++)
+  {
+    const glm::vec3 center{boxes.center_x[i], boxes.center_y[i], boxes.center_z[i]};
+    const glm::vec3 extent{boxes.extent_x[i], boxes.extent_y[i], boxes.extent_z[i]};
+    if (isBoxVisible(frustum, center, extent))
+    {
+      visible_ids.push_back(static_cast<std::uint32_t>(i));
+    }
+  }
+
+  return CullingStats{visible_ids.size(), n_objects - visible_ids.size()};
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "Frustum.hpp"
+
+// Bounding spheres of many objects in SoA: the culling loads the
+// center x of 4 objects in one register, then y, ...
+struct BoundingSpheres final {
+  std::vector<float> center_x;
+  std::vector<float> center_y;
+  std::vector<float> center_z;
+  std::vector<float> radius;
+
+  std::size_t add(const glm::vec3& center, float sphere_radius);
+  void set(std::size_t id, const glm::vec3& center, float sphere_radius);
+  void reserve(std::size_t n_objects);
+  std::size_t size() const;
+};
+
+// Axis aligned bounding boxes of many objects in SoA, stored as center
+// and half extents, which is what the plane test needs
+struct BoundingBoxes final {
+  std::vector<float> center_x;
+  std::vector<float> center_y;
+  std::vector<float> center_z;
+  std::vector<float> extent_x;
+  std::vector<float> extent_y;
+  std::vector<float> extent_z;
+
+  std::size_t add(const glm::vec3& min_corner, const glm::vec3& max_corner);
+  void set(std::size_t id, const glm::vec3& min_corner, const glm::vec3& max_corner);
+  void reserve(std::size_t n_objects);
+  std::size_t size() const;
+};
+
+// Counters of a culling pass
+struct CullingStats {
+  std::size_t visible{0};
+  std::size_t culled{0};
+};
+
+// Write in visible_ids the ids of the objects intersecting the frustum
+// (visible_ids is cleared first), 4 objects per iteration with SSE
+// The test is conservative: an object near a corner of the frustum,
+// outside of it but not fully behind one plane, is kept
+CullingStats cullSpheres(const Frustum& frustum, const BoundingSpheres& spheres, std::vector<std::uint32_t>& visible_ids);
+// Same for the objects first_id to end_id (excluded) only, for example
+// one range per thread (a range outside of spheres is an error, nothing is visible)
+CullingStats cullSpheres(
+  const Frustum& frustum,
+  const BoundingSpheres& spheres,
+  std::size_t first_id,
+  std::size_t end_id,
+  std::vector<std::uint32_t>& visible_ids
+);
+CullingStats cullBoxes(const Frustum& frustum, const BoundingBoxes& boxes, std::vector<std::uint32_t>& visible_ids);
@@ -0,0 +1,325 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "glad/glad.h"
+
+#include "GLCallCounter.hpp"
+#include "GLExtensions.hpp"
+#include "FrameBenchmark.hpp"
+
+namespace {
+
+struct FunctionCounter {
+  const char* name;
+  GLCallCategory category;
+  // current frame
+  std::size_t frame_calls{0};
+  std::int64_t frame_time{0};
+  // all the frames ended
+  std::size_t total_calls{0};
+  std::int64_t total_time{0};
+  std::size_t max_frame_calls{0};
+};
+
+// indexed by the wrappers, filled once by install()
+std::vector<FunctionCounter> function_counter_list{};
+std::vector<std::array<std::size_t, N_gl_call_categories>> frame_count_list{};
+// nanoseconds spent in the GL functions, per frame
+std::vector<std::int64_t> frame_time_list{};
+bool is_installed{false};
+
+bool startsWith(const char* name, const char* prefix)
+{
+  return std::strncmp(name, prefix, std::strlen(prefix)) == 0;
+}
+
+GLCallCategory categorize(const char* name)
+{
+  // the exceptions first: they start like another category
+  for (const char* state_name : {"glDrawBuffer", "glUniformBlockBinding"})
+  {
+    if (startsWith(name, state_name))
+    {
+      return GLCallCategory::StateChange;
+    }
+  }
+  if (startsWith(name, "glDraw") || startsWith(name, "glMultiDraw"))
+  {
+    return GLCallCategory::Draw;
+  }
+  if (startsWith(name, "glUniform"))
+  {
+    return GLCallCategory::UniformUpload;
+  }
+  for (const char* buffer_name : {"glBufferData", "glBufferSubData", "glMapBuffer", "glUnmapBuffer", "glFlushMappedBufferRange", "glCopyBufferSubData"})
+  {
+    if (startsWith(name, buffer_name))
+    {
+      return GLCallCategory::BufferUpload;
+    }
+  }
+  for (const char* texture_name : {"glTexImage", "glTexSubImage", "glCompressedTex", "glGenerateMipmap"})
+  {
+    if (startsWith(name, texture_name))
+    {
+      return GLCallCategory::TextureUpload;
+    }
+  }
+  if (startsWith(name, "glGet") || startsWith(name, "glIs") || startsWith(name, "glReadPixels") || startsWith(name, "glCheckFramebufferStatus"))
+  {
+    return GLCallCategory::Query;
+  }
+  for (const char* state_name : {
+    "glBind", "glUseProgram", "glEnable", "glDisable", "glActiveTexture", "glBlend", "glDepth",
+    "glStencil", "glCullFace", "glFrontFace", "glViewport", "glScissor", "glPolygon", "glColorMask",
+    "glClearColor", "glClearDepth", "glClearStencil", "glLineWidth", "glPointSize", "glPixelStore",
+    "glTexParameter", "glSamplerParameter", "glVertexAttribPointer", "glVertexAttribIPointer",
+    "glVertexAttribDivisor", "glPrimitiveRestartIndex", "glReadBuffer"
+  })
+  {
+    if (startsWith(name, state_name))
+    {
+      return GLCallCategory::StateChange;
+    }
+  }
+  return GLCallCategory::Other;
+}
+
+// Count and time a call, until the end of the scope
+class CallTimer {
+private:
+  FunctionCounter& counter_;
+  std::chrono::steady_clock::time_point start_time_;
+public:
+  explicit CallTimer(FunctionCounter& counter) :
+    counter_{counter},
+    start_time_{std::chrono::steady_clock::now()}
+  {
+  }
+  ~CallTimer()
+  {
+    counter_.frame_calls++;
+    counter_.frame_time += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time_).count();
+  }
+};
+
+// A wrapper per glad pointer: the pointer (&glad_glDrawArrays, ...)
+// is a template parameter, so each function has its own static call
+// with the same signature, and its own original function
+template <auto* pointer, typename Function = std::remove_pointer_t<decltype(pointer)>>
+struct CountedFunction;
+
+template <auto* pointer, typename Result, typename... Args>
+struct CountedFunction<pointer, Result (APIENTRYP)(Args...)> {
+  inline static Result (APIENTRYP original)(Args...){nullptr};
+  inline static std::size_t counter_index{0};
+
+  static Result APIENTRY call(Args... args)
+  {
+    CallTimer timer{function_counter_list[counter_index]};
+    return original(args...);
+  }
+};
+
+template <auto* pointer>
+void wrap(const char* name)
+{
+  // not loaded: not in the context, or an extension not supported
+  if (*pointer == nullptr)
+  {
+    return;
+  }
+
+  using Counted = CountedFunction<pointer>;
+  Counted::original = *pointer;
+  Counted::counter_index = function_counter_list.size();
+  function_counter_list.push_back(FunctionCounter{name, categorize(name)});
+  *pointer = &Counted::call;
+}
+
+// 0, 1, 2-3, 4-7, ...
+std::size_t getBucket(std::size_t n_calls)
+{
+  std::size_t bucket{0};
+  while (n_calls > 0)
+  {
+    n_calls >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+
+std::string getBucketName(std::size_t bucket)
+{
+  if (bucket < 2)
+  {
+    return std::to_string(bucket);
+  }
+  const std::size_t first{std::size_t{1} << (bucket - 1)};
+  return std::to_string(first) + "-" + std::to_string(2 * first - 1);
+}
+
+}
+
+const char* getCategoryName(GLCallCategory category)
+{
+  switch (category)
+  {
+    case GLCallCategory::Draw: return "draw calls";
+    case GLCallCategory::StateChange: return "state changes";
+    case GLCallCategory::UniformUpload: return "uniform uploads";
+    case GLCallCategory::BufferUpload: return "buffer uploads";
+    case GLCallCategory::TextureUpload: return "texture uploads";
+    case GLCallCategory::Query: return "queries";
+    case GLCallCategory::Other: return "other";
+  }
+  return "unknown";
+}
+
+bool GLCallCounter::isRequested(int argc, char* argv[])
+{
+  for (int i = 1; i < argc; i++)
+  {
+    if (std::strcmp(argv[i], "--count-gl-calls") == 0)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+void GLCallCounter::install()
+{
+  if (is_installed)
+  {
+    return;
+  }
+
+  // no reallocation once the wrappers use it
+  function_counter_list.reserve(1024);
+#define GL_FUNCTION(name) wrap<&glad_##name>(#name);
+#include "GLFunctionList.hpp"
+#undef GL_FUNCTION
+
+  is_installed = true;
+}
+
+bool GLCallCounter::isInstalled()
+{
+  return is_installed;
+}
+
+void GLCallCounter::endFrame()
+{
+  if (!is_installed)
+  {
+    return;
+  }
+
+  std::array<std::size_t, N_gl_call_categories> frame_counts{};
+  std::int64_t frame_time{0};
+  for (auto& counter : function_counter_list)
+  {
+    if (counter.frame_calls == 0)
+    {
+      continue;
+    }
+    frame_counts[static_cast<std::size_t>(counter.category)] += counter.frame_calls;
+    frame_time += counter.frame_time;
+    counter.total_calls += counter.frame_calls;
+    counter.total_time += counter.frame_time;
+    counter.max_frame_calls = std::max(counter.max_frame_calls, counter.frame_calls);
+    counter.frame_calls = 0;
+    counter.frame_time = 0;
+  }
+  frame_count_list.push_back(frame_counts);
+  frame_time_list.push_back(frame_time);
+}
+
+std::array<std::size_t, N_gl_call_categories> GLCallCounter::getLastFrameCounts()
+{
+  return frame_count_list.empty() ? std::array<std::size_t, N_gl_call_categories>{} : frame_count_list.back();
+}
+
+void GLCallCounter::report()
+{
+  if (!is_installed || frame_count_list.empty())
+  {
+    return;
+  }
+
+  const std::size_t n_frames{frame_count_list.size()};
+  std::size_t n_calls{0};
+  for (const auto& counter : function_counter_list)
+  {
+    n_calls += counter.total_calls;
+  }
+  std::vector<double> frame_time_ms_list{};
+  for (std::int64_t frame_time : frame_time_list)
+  {
+    frame_time_ms_list.push_back(frame_time / 1e6);
+  }
+  const FrameStatistics time_statistics{FrameStatistics::compute(frame_time_ms_list)};
+
+  std::cout << "GL calls over " << n_frames << " frames: " << static_cast<double>(n_calls) / n_frames
+    << " calls per frame, " << time_statistics.mean << " ms per frame in the GL functions ("
+    << time_statistics.p95 << " ms p95)" << std::endl;
+
+  // calls per frame of each category: statistics, and how many frames
+  // had 0, 1, 2-3, 4-7, ... of them
+  for (std::size_t category = 0; category < N_gl_call_categories; category++)
+  {
+    std::vector<double> value_list{};
+    std::vector<std::size_t> histogram{};
+    for (const auto& frame_counts : frame_count_list)
+    {
+      value_list.push_back(static_cast<double>(frame_counts[category]));
+      const std::size_t bucket{getBucket(frame_counts[category])};
+      histogram.resize(std::max(histogram.size(), bucket + 1));
+      histogram[bucket]++;
+    }
+    const FrameStatistics statistics{FrameStatistics::compute(value_list)};
+    std::cout << "  " << std::left << std::setw(16) << getCategoryName(static_cast<GLCallCategory>(category)) << std::right
+      << " p50 " << statistics.p50 << ", p95 " << statistics.p95 << ", max " << statistics.max << " |";
+    for (std::size_t bucket = 0; bucket < histogram.size(); bucket++)
+    {
+      if (histogram[bucket] > 0)
+      {
+        std::cout << " " << getBucketName(bucket) << ": " << histogram[bucket];
+      }
+    }
+    std::cout << std::endl;
+  }
+
+  std::vector<const FunctionCounter*> called_list{};
+  for (const auto& counter : function_counter_list)
+  {
+    if (counter.total_calls > 0)
+    {
+      called_list.push_back(&counter);
+    }
+  }
+  std::sort(called_list.begin(), called_list.end(), [](const FunctionCounter* a, const FunctionCounter* b) {
+    return a->total_calls > b->total_calls;
+  });
+  const std::size_t N_shown{15};
+  std::cout << "  most called functions (mean calls per frame, max, time per frame):" << std::endl;
+  std::cout << std::fixed;
+  for (std::size_t i = 0; i < std::min(N_shown, called_list.size()); i++)
+  {
+    const FunctionCounter& counter{*called_list[i]};
+    std::cout << "    " << std::left << std::setw(36) << counter.name << std::right
+      << std::setw(10) << std::setprecision(1) << static_cast<double>(counter.total_calls) / n_frames
+      << std::setw(8) << counter.max_frame_calls
+      << std::setw(10) << std::setprecision(4) << counter.total_time / 1e6 / n_frames << " ms  "
+      << getCategoryName(counter.category) << std::endl;
+  }
+  std::cout << std::defaultfloat << std::setprecision(6);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+// What a GL call does, for the counts per frame
+enum class GLCallCategory {
+  Draw,
+  // bind, use, enable, blend, depth, ... state
+  StateChange,
+  UniformUpload,
+  BufferUpload,
+  TextureUpload,
+  // glGet*, glIs*, glReadPixels: may wait for the driver, or the GPU
+  Query,
+  Other
+};
+constexpr std::size_t N_gl_call_categories{7};
+
+const char* getCategoryName(GLCallCategory category);
+
+/**
+ * Instrumented loader mode: every function pointer loaded by glad
+ * (glad_glDrawArrays, ...) is replaced by a wrapper which counts and times
+ * the call before calling the driver, so the GL calls of the examples are
+ * measured without an external tracer or any change in the render code
+ *
+ * gladLoadGLLoader(...); loadGLExtensions(...);
+ * GLCallCounter::install();
+ * while (...) {
+ *   ... render ...
+ *   context.endFrame();
+ *   GLCallCounter::endFrame();
+ * }
+ * GLCallCounter::report();
+ *
+ * The report gives for each category the histogram of the calls per frame,
+ * and the functions called the most per frame: a glGetUniformLocation per
+ * object, or a glBufferData per frame, shows at once
+ *
+ * Without install() the pointers are not touched, there is no cost at all
+ * With it, each call costs two clock reads (tens of nanoseconds)
+ * The functions are listed in GLFunctionList.hpp
+ */
+class GLCallCounter final {
+public:
+  GLCallCounter() = delete;
+
+  // --count-gl-calls on the command line
+  static bool isRequested(int argc, char* argv[]);
+  // Wrap the loaded functions, after gladLoadGLLoader and loadGLExtensions
+  // (the functions loaded after are not counted)
+  static void install();
+  static bool isInstalled();
+  // After the last call of the frame
+  static void endFrame();
+  // calls of each category in the last frame ended
+  static std::array<std::size_t, N_gl_call_categories> getLastFrameCounts();
+  // Print the histograms and the functions called the most
+  static void report();
+};
@@ -0,0 +1,406 @@
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+// only the surfaceless platform is used, without X11
+#define EGL_NO_X11
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include "GLContext.hpp"
+
+namespace {
+
+bool hasEGLExtension(EGLDisplay display, const char* extension)
+{
+  const char* extensions{eglQueryString(display, EGL_EXTENSIONS)};
+  if (extensions == nullptr)
+  {
+    return false;
+  }
+  // extensions are separated by spaces: look for the whole name
+  const std::size_t length{std::strlen(extension)};
+  for (const char* found = std::strstr(extensions, extension); found != nullptr; found = std::strstr(found + length, extension))
+  {
+    const bool starts{found == extensions || found[-1] == ' '};
+    const bool ends{found[length] == ' ' || found[length] == '\0'};
+    if (starts && ends)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+}
+
+GLContextOptions GLContextOptions::fromEnvironment()
+{
+  GLContextOptions options{};
+  if (const char* headless_frames = std::getenv("LEARNOPENGL_HEADLESS"))
+  {
+    options.headless_frames = std::strtoul(headless_frames, nullptr, 10);
+  }
+  return options;
+}
+
+GLContextOptions GLContextOptions::fromCommandLine(int argc, char* argv[])
+{
+  GLContextOptions options{fromEnvironment()};
+
+  for (int i = 1; i + 1 < argc; i++)
+  {
+    if (std::strcmp(argv[i], "--headless") == 0)
+    {
+      options.headless_frames = std::strtoul(argv[++i], nullptr, 10);
+    }
+    else if (std::strcmp(argv[i], "--output") == 0)
+    {
+      options.output_path = argv[++i];
+    }
+  }
+
+  return options;
+}
+
+GLContext::GLContext(const GLContextOptions& options) :
+  options_{options},
+  is_headless_{options.headless_frames > 0},
+  start_time_{std::chrono::steady_clock::now()}
+{
+  is_valid_ = isHeadless() ? createHeadless_() : createWindow_();
+  if (is_valid_)
+  {
+    glViewport(0, 0, options_.width, options_.height);
+  }
+}
+
+GLContext::~GLContext()
+{
+  if (isHeadless())
+  {
+    if (egl_display_ != nullptr)
+    {
+      if (is_valid_)
+      {
+        glDeleteFramebuffers(1, &framebuffer_id_);
+        glDeleteRenderbuffers(1, &color_renderbuffer_id_);
+        glDeleteRenderbuffers(1, &depth_renderbuffer_id_);
+      }
+      eglMakeCurrent(egl_display_, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+      if (egl_context_ != nullptr)
+      {
+        eglDestroyContext(egl_display_, egl_context_);
+      }
+      eglTerminate(egl_display_);
+    }
+  }
+  else
+  {
+    glfwTerminate();
+  }
+}
+
+bool GLContext::createWindow_()
+{
+  glfwInit();
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+  glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+  if (!options_.visible)
+  {
+    glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+  }
+
+  window_ = glfwCreateWindow(options_.width, options_.height, options_.title.c_str(), NULL, NULL);
+  if (window_ == NULL)
+  {
+    std::cout << "Failed to create GLFW window" << std::endl;
+    return false;
+  }
+  glfwMakeContextCurrent(window_);
+
+  // Glad: load all OpenGL function pointers
+  if (!gladLoadGLLoader(getProcAddressLoader()))
+  {
+    std::cout << "Failed to initialize GLAD" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool GLContext::createHeadless_()
+{
+  // the surfaceless platform needs neither a display server nor a GPU,
+  // else try the default display (which may need X11 or a GPU)
+  EGLDisplay display{EGL_NO_DISPLAY};
+  if (hasEGLExtension(EGL_NO_DISPLAY, "EGL_MESA_platform_surfaceless"))
+  {
+    auto getPlatformDisplay{reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"))};
+    if (getPlatformDisplay != nullptr)
+    {
+      display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    }
+  }
+  if (display == EGL_NO_DISPLAY)
+  {
+    display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+  }
+
+  EGLint major{0};
+  EGLint minor{0};
+  if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor))
+  {
+    std::cout << "ERROR::GL_CONTEXT::EGL_INITIALIZATION_FAILED" << std::endl;
+    return false;
+  }
+  egl_display_ = display;
+
+  // no surface at all: the context is made current without one,
+  // the frames go to a framebuffer object
+  if (!hasEGLExtension(display, "EGL_KHR_surfaceless_context"))
+  {
+    std::cout << "ERROR::GL_CONTEXT::EGL_SURFACELESS_CONTEXT_NOT_SUPPORTED" << std::endl;
+    return false;
+  }
+
+  if (!eglBindAPI(EGL_OPENGL_API))
+  {
+    std::cout << "ERROR::GL_CONTEXT::EGL_OPENGL_API_NOT_SUPPORTED" << std::endl;
+    return false;
+  }
+
+  const EGLint config_attributes[]{EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE};
+  EGLConfig config{nullptr};
+  EGLint n_configs{0};
+  if (!eglChooseConfig(display, config_attributes, &config, 1, &n_configs) || n_configs == 0)
+  {
+    // the config is only needed for the surfaces, which are not used
+    config = EGL_NO_CONFIG_KHR;
+  }
+
+  const EGLint context_attributes[]{
+    EGL_CONTEXT_MAJOR_VERSION, 3,
+    EGL_CONTEXT_MINOR_VERSION, 3,
+    EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+    EGL_NONE
+  };
+  EGLContext context{eglCreateContext(display, config, EGL_NO_CONTEXT, context_attributes)};
+  if (context == EGL_NO_CONTEXT)
+  {
+    std::cout << "ERROR::GL_CONTEXT::EGL_CONTEXT_CREATION_FAILED " << std::hex << eglGetError() << std::dec << std::endl;
+    return false;
+  }
+  egl_context_ = context;
+
+  if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+  {
+    std::cout << "ERROR::GL_CONTEXT::EGL_MAKE_CURRENT_FAILED" << std::endl;
+    return false;
+  }
+
+  if (!gladLoadGLLoader(getProcAddressLoader()))
+  {
+    std::cout << "Failed to initialize GLAD" << std::endl;
+    return false;
+  }
+
+  createFramebuffer_();
+  if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+  {
+    std::cout << "ERROR::GL_CONTEXT::FRAMEBUFFER_NOT_COMPLETE" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+void GLContext::createFramebuffer_()
+{
+  // same content as the default framebuffer of a GLFW window:
+  // RGBA8 color, 24 bits depth and 8 bits stencil
+  glGenRenderbuffers(1, &color_renderbuffer_id_);
+  glBindRenderbuffer(GL_RENDERBUFFER, color_renderbuffer_id_);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, options_.width, options_.height);
+
+  glGenRenderbuffers(1, &depth_renderbuffer_id_);
+  glBindRenderbuffer(GL_RENDERBUFFER, depth_renderbuffer_id_);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, options_.width, options_.height);
+  glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+  glGenFramebuffers(1, &framebuffer_id_);
+  glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_id_);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color_renderbuffer_id_);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depth_renderbuffer_id_);
+}
+
+void GLContext::saveFrame_() const
+{
+  const int width{options_.width};
+  const int height{options_.height};
+  std::vector<unsigned char> pixels(static_cast<std::size_t>(width) * height * 3);
+
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer_id_);
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+
+  std::ofstream file{options_.output_path, std::ios::binary};
+  if (!file)
+  {
+    std::cout << "ERROR::GL_CONTEXT::FRAME_NOT_SUCCESFULLY_WRITTEN " << options_.output_path << std::endl;
+    return;
+  }
+  file << "P6\n" << width << " " << height << "\n255\n";
+  // OpenGL rows start at the bottom, PPM rows at the top
+  for (int y = height - 1; y >= 0; y--)
+  {
+    file.write(reinterpret_cast<const char*>(pixels.data() + static_cast<std::size_t>(y) * width * 3), width * 3);
+  }
+}
+
+bool GLContext::isValid() const
+{
+  return is_valid_;
+}
+
+bool GLContext::isHeadless() const
+{
+  return is_headless_;
+}
+
+GLFWwindow* GLContext::getWindow() const
+{
+  return window_;
+}
+
+GLuint GLContext::getDefaultFramebuffer() const
+{
+  return framebuffer_id_;
+}
+
+int GLContext::getWidth() const
+{
+  return options_.width;
+}
+
+int GLContext::getHeight() const
+{
+  return options_.height;
+}
+
+std::size_t GLContext::getFrameCount() const
+{
+  return n_frames_;
+}
+
+GLADloadproc GLContext::getProcAddressLoader() const
+{
+  if (isHeadless())
+  {
+    return reinterpret_cast<GLADloadproc>(eglGetProcAddress);
+  }
+  return reinterpret_cast<GLADloadproc>(glfwGetProcAddress);
+}
+
+bool GLContext::shouldClose() const
+{
+  if (isHeadless())
+  {
+    return is_close_requested_ || n_frames_ >= options_.headless_frames;
+  }
+  return glfwWindowShouldClose(window_);
+}
+
+void GLContext::close()
+{
+  if (isHeadless())
+  {
+    is_close_requested_ = true;
+  }
+  else
+  {
+    glfwSetWindowShouldClose(window_, true);
+  }
+}
+
+void GLContext::endFrame()
+{
+  n_frames_++;
+
+  if (!isHeadless())
+  {
+    // swap buffer and poll IO events
+    glfwSwapBuffers(window_);
+    glfwPollEvents();
+    return;
+  }
+
+  // nothing waits for the frame as a swap would: the time of the
+  // frames would only be the time to queue the commands
+  glFinish();
+
+  // the first frame also loads the textures, compiles the shaders, ...
+  // it is not counted in the frame rate
+  const auto now{std::chrono::steady_clock::now()};
+  if (n_frames_ == 1)
+  {
+    first_frame_end_time_ = now;
+  }
+
+  if (n_frames_ == options_.headless_frames)
+  {
+    std::chrono::duration<double> duration{now - first_frame_end_time_};
+    std::cout << n_frames_ << " frames rendered";
+    if (n_frames_ > 1)
+    {
+      std::cout << ", " << (n_frames_ - 1) / duration.count() << " frames/s after the first one";
+    }
+    std::cout << std::endl;
+    if (!options_.output_path.empty())
+    {
+      saveFrame_();
+    }
+  }
+}
+
+double GLContext::getTime() const
+{
+  if (isHeadless())
+  {
+    std::chrono::duration<double> duration{std::chrono::steady_clock::now() - start_time_};
+    return duration.count();
+  }
+  return glfwGetTime();
+}
+
+bool GLContext::isKeyPressed(int key) const
+{
+  return !isHeadless() && glfwGetKey(window_, key) == GLFW_PRESS;
+}
+
+void GLContext::setFramebufferSizeCallback(GLFWframebuffersizefun callback)
+{
+  if (!isHeadless())
+  {
+    glfwSetFramebufferSizeCallback(window_, callback);
+  }
+}
+
+void GLContext::setCursorPosCallback(GLFWcursorposfun callback)
+{
+  if (!isHeadless())
+  {
+    glfwSetCursorPosCallback(window_, callback);
+  }
+}
+
+void GLContext::captureCursor()
+{
+  if (!isHeadless())
+  {
+    glfwSetInputMode(window_, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+  }
+}
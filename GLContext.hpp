@@ -0,0 +1,104 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+#include "glad/glad.h"
+#include "GLFW/glfw3.h"
+
+// How the OpenGL context of an example is created
+struct GLContextOptions final {
+  int width{800};
+  int height{600};
+  std::string title{"LearnOpenGL"};
+  // false for a hidden window, when only the context is needed
+  bool visible{true};
+  // 0: in a GLFW window, until it is closed
+  // N: offscreen, without any window nor display, N frames then exit
+  std::size_t headless_frames{0};
+  // offscreen only: the last frame is written to this file (binary PPM)
+  std::string output_path{};
+
+  // LEARNOPENGL_HEADLESS environment variable: number of frames
+  static GLContextOptions fromEnvironment();
+  // --headless N [--output frame.ppm] on the command line,
+  // else the environment
+  static GLContextOptions fromCommandLine(int argc, char* argv[]);
+};
+
+/**
+ * OpenGL 3.3 core context of the examples, with glad loaded
+ *
+ * With a window it is GLFW, as before. Offscreen (headless) it is EGL,
+ * on the surfaceless platform of Mesa (EGL_MESA_platform_surfaceless):
+ * no X display and no /dev/dri access are needed, Mesa falls back to
+ * llvmpipe on a server or a CI box without GPU
+ * Without a window there is no default framebuffer: the frames are
+ * rendered in a framebuffer object of the same size, bound at creation
+ *
+ * GLContext context{GLContextOptions::fromCommandLine(argc, argv)};
+ * if (!context.isValid()) return -1;
+ * while (!context.shouldClose()) {
+ *   ... render ...
+ *   context.endFrame();
+ * }
+ *
+ * Offscreen, the input functions do nothing: no key is ever pressed
+ */
+class GLContext final {
+private:
+  GLContextOptions options_;
+  GLFWwindow* window_{nullptr};
+  // EGLDisplay and EGLContext, kept opaque so EGL is only included by GLContext.cpp
+  void* egl_display_{nullptr};
+  void* egl_context_{nullptr};
+  GLuint framebuffer_id_{0};
+  GLuint color_renderbuffer_id_{0};
+  GLuint depth_renderbuffer_id_{0};
+  std::size_t n_frames_{0};
+  // fixed at construction: the teardown depends on it
+  bool is_headless_{false};
+  // close() in headless mode, before the N frames
+  bool is_close_requested_{false};
+  std::chrono::steady_clock::time_point start_time_;
+  std::chrono::steady_clock::time_point first_frame_end_time_;
+  bool is_valid_{false};
+
+  bool createWindow_();
+  bool createHeadless_();
+  void createFramebuffer_();
+  void saveFrame_() const;
+public:
+  explicit GLContext(const GLContextOptions& options = GLContextOptions{});
+  ~GLContext();
+  GLContext(const GLContext&) = delete;
+  GLContext& operator=(const GLContext&) = delete;
+
+  bool isValid() const;
+  bool isHeadless() const;
+  // nullptr when headless
+  GLFWwindow* getWindow() const;
+  // framebuffer to bind to draw on screen again (0 with a window)
+  GLuint getDefaultFramebuffer() const;
+  int getWidth() const;
+  int getHeight() const;
+  std::size_t getFrameCount() const;
+  // to load the entry points of the extensions: loadGLExtensions(context.getProcAddressLoader())
+  GLADloadproc getProcAddressLoader() const;
+
+  // the window was closed, or the N frames were rendered
+  bool shouldClose() const;
+  void close();
+  // After the rendering of a frame: swap the buffers and poll the events
+  // Offscreen: wait for the frame to be rendered, and save the last one
+  void endFrame();
+
+  // seconds since the creation of the context
+  double getTime() const;
+  bool isKeyPressed(int key) const;
+  void setFramebufferSizeCallback(GLFWframebuffersizefun callback);
+  void setCursorPosCallback(GLFWcursorposfun callback);
+  // hide the cursor and keep it in the window (camera control)
+  void captureCursor();
+};
@@ -0,0 +1,107 @@
+#include <cstring>
+#include <iostream>
+
+#include "GLExtensions.hpp"
+
+int GLAD_GL_ARB_get_program_binary{0};
+PFNGLGETPROGRAMBINARYPROC glad_glGetProgramBinary{nullptr};
+PFNGLPROGRAMBINARYPROC glad_glProgramBinary{nullptr};
+PFNGLPROGRAMPARAMETERIPROC glad_glProgramParameteri{nullptr};
+
+int GLAD_GL_KHR_parallel_shader_compile{0};
+PFNGLMAXSHADERCOMPILERTHREADSKHRPROC glad_glMaxShaderCompilerThreadsKHR{nullptr};
+
+int GLAD_GL_ARB_draw_indirect{0};
+PFNGLDRAWELEMENTSINDIRECTPROC glad_glDrawElementsIndirect{nullptr};
+
+int GLAD_GL_ARB_base_instance{0};
+PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXBASEINSTANCEPROC glad_glDrawElementsInstancedBaseVertexBaseInstance{nullptr};
+
+int GLAD_GL_ARB_multi_draw_indirect{0};
+PFNGLMULTIDRAWELEMENTSINDIRECTPROC glad_glMultiDrawElementsIndirect{nullptr};
+
+namespace {
+
+bool hasExtension(const char* extension_name)
+{
+  GLint n_extensions{0};
+  glGetIntegerv(GL_NUM_EXTENSIONS, &n_extensions);
+
+  for (GLint i = 0; i < n_extensions; i++)
+  {
+    auto name{reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i))};
+
+    if (name != nullptr && std::strcmp(name, extension_name) == 0)
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool hasVersion(GLint major, GLint minor)
+{
+  GLint context_major{0};
+  GLint context_minor{0};
+  glGetIntegerv(GL_MAJOR_VERSION, &context_major);
+  glGetIntegerv(GL_MINOR_VERSION, &context_minor);
+
+  return context_major > major || (context_major == major && context_minor >= minor);
+}
+
+// false (and an error) if the driver advertises the function but does not give it
+template <typename Proc>
+bool loadEntryPoint(GLADloadproc load, const char* function_name, Proc& function)
+{
+  function = reinterpret_cast<Proc>(load(function_name));
+  if (function == nullptr)
+  {
+    std::cout << "ERROR::GL_EXTENSIONS::ENTRY_POINT_NOT_FOUND: " << function_name << std::endl;
+    return false;
+  }
+  return true;
+}
+
+}
+
+bool loadGLExtensions(GLADloadproc load)
+{
+  bool is_loaded{true};
+
+  if (hasVersion(4, 1) || hasExtension("GL_ARB_get_program_binary"))
+  {
+    // not && between the calls: each missing function is reported
+    bool has_functions{loadEntryPoint(load, "glGetProgramBinary", glad_glGetProgramBinary)};
+    has_functions &= loadEntryPoint(load, "glProgramBinary", glad_glProgramBinary);
+    has_functions &= loadEntryPoint(load, "glProgramParameteri", glad_glProgramParameteri);
+    GLAD_GL_ARB_get_program_binary = has_functions;
+    is_loaded &= has_functions;
+  }
+
+  if (hasExtension("GL_KHR_parallel_shader_compile"))
+  {
+    GLAD_GL_KHR_parallel_shader_compile = loadEntryPoint(load, "glMaxShaderCompilerThreadsKHR", glad_glMaxShaderCompilerThreadsKHR);
+    is_loaded &= GLAD_GL_KHR_parallel_shader_compile != 0;
+  }
+
+  if (hasVersion(4, 0) || hasExtension("GL_ARB_draw_indirect"))
+  {
+    GLAD_GL_ARB_draw_indirect = loadEntryPoint(load, "glDrawElementsIndirect", glad_glDrawElementsIndirect);
+    is_loaded &= GLAD_GL_ARB_draw_indirect != 0;
+  }
+
+  if (hasVersion(4, 2) || hasExtension("GL_ARB_base_instance"))
+  {
+    GLAD_GL_ARB_base_instance = loadEntryPoint(load, "glDrawElementsInstancedBaseVertexBaseInstance", glad_glDrawElementsInstancedBaseVertexBaseInstance);
+    is_loaded &= GLAD_GL_ARB_base_instance != 0;
+  }
+
+  if (hasVersion(4, 3) || hasExtension("GL_ARB_multi_draw_indirect"))
+  {
+    GLAD_GL_ARB_multi_draw_indirect = loadEntryPoint(load, "glMultiDrawElementsIndirect", glad_glMultiDrawElementsIndirect);
+    is_loaded &= GLAD_GL_ARB_multi_draw_indirect != 0;
+  }
+
+  return is_loaded;
+}
@@ -0,0 +1,97 @@
+#include <cstddef>
+
+#include "InstancedMesh.hpp"
+
+void setupInstanceAttributes(GLuint first_location, std::size_t first_instance)
+{
+  const std::size_t base_offset{first_instance * sizeof(InstanceTransform)};
+
+  // a mat4 attribute is 4 vec4 attributes, one per column
+  for (GLuint i = 0; i < 4; i++)
+  {
+    const std::size_t offset{base_offset + offsetof(InstanceTransform, model_matrix) + i * sizeof(glm::vec4)};
+    glVertexAttribPointer(first_location + i, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceTransform), reinterpret_cast<void*>(offset));
+    glEnableVertexAttribArray(first_location + i);
+    // the attribute advances once per instance, not once per vertex
+    glVertexAttribDivisor(first_location + i, 1);
+  }
+
+  // and a mat3 is 3 vec3
+  for (GLuint i = 0; i < 3; i++)
+  {
+    const GLuint location{first_location + 4 + i};
+    const std::size_t offset{base_offset + offsetof(InstanceTransform, normal_matrix) + i * sizeof(glm::vec3)};
+    glVertexAttribPointer(location, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceTransform), reinterpret_cast<void*>(offset));
+    glEnableVertexAttribArray(location);
+    glVertexAttribDivisor(location, 1);
+  }
+}
+
+InstancedMesh::InstancedMesh(const VertexArray& vertex_array, GLuint first_location) : vertex_array_{vertex_array}
+{
+  vertex_array_.bind();
+
+  glGenBuffers(1, &instance_vbo_id_);
+  glBindBuffer(GL_ARRAY_BUFFER, instance_vbo_id_);
+
+  setupInstanceAttributes(first_location);
+
+  vertex_array_.unbind();
+}
+
+void InstancedMesh::setInstances(const std::vector<glm::mat4>& model_matrix_list)
+{
+  std::vector<InstanceTransform> transform_list(model_matrix_list.size());
+  for (std::size_t i = 0; i < model_matrix_list.size(); i++)
+  {
+    transform_list[i].model_matrix = model_matrix_list[i];
+    // Normal matrix: the inverse transpose of the upper 3x3 of the model
+    // (the translation does not apply to normals), cheaper than the mat4 inverse
+    transform_list[i].normal_matrix = glm::transpose(glm::inverse(glm::mat3(model_matrix_list[i])));
+  }
+
+  setInstances(transform_list);
+}
+
+void InstancedMesh::setInstances(const std::vector<InstanceTransform>& transform_list)
+{
+  n_instances_ = transform_list.size();
+  const std::size_t size{n_instances_ * sizeof(InstanceTransform)};
+
+  glBindBuffer(GL_ARRAY_BUFFER, instance_vbo_id_);
+  if (n_instances_ > capacity_)
+  {
+    capacity_ = n_instances_;
+    glBufferData(GL_ARRAY_BUFFER, size, transform_list.data(), GL_DYNAMIC_DRAW);
+  }
+  else
+  {
+    // Orphan the previous storage, the draws of the last frame may still read it
+    glBufferData(GL_ARRAY_BUFFER, capacity_ * sizeof(InstanceTransform), NULL, GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, size, transform_list.data());
+  }
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+std::size_t InstancedMesh::getInstanceCount() const
+{
+  return n_instances_;
+}
+
+void InstancedMesh::draw(GLenum mode)
+{
+  if (n_instances_ == 0)
+  {
+    return;
+  }
+
+  vertex_array_.bind();
+  if (vertex_array_.n_indices > 0)
+  {
+    glDrawElementsInstanced(mode, static_cast<GLsizei>(vertex_array_.n_indices), GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(n_instances_));
+  }
+  else
+  {
+    glDrawArraysInstanced(mode, 0, static_cast<GLsizei>(vertex_array_.n_vertices), static_cast<GLsizei>(n_instances_));
+  }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "glad/glad.h"
+#include "glm/glm.hpp"
+
+#include "VertexArray.hpp"
+
+// Per instance data, read by the vertex shader as attributes which
+// advance once per instance (divisor 1) instead of once per vertex:
+//
+// layout (location = 3) in mat4 a_model_matrix;  // locations 3 to 6
+// layout (location = 7) in mat3 a_normal_matrix; // locations 7 to 9
+//
+// a matrix attribute takes one location per column
+struct InstanceTransform final {
+  glm::mat4 model_matrix;
+  glm::mat3 normal_matrix;
+};
+
+// Declare the instance attributes on the bound VAO, reading the InstanceTransform
+// array of the bound GL_ARRAY_BUFFER from first_instance
+// (without GL_ARB_base_instance, that is how a draw starts at another instance)
+void setupInstanceAttributes(GLuint first_location, std::size_t first_instance = 0);
+
+/**
+ * Mesh drawn many times with a single glDraw*Instanced call
+ *
+ * Instead of one draw and two glUniformMatrix per object, the model
+ * and normal matrices of all the instances are uploaded in one
+ * instance buffer, read through the VAO of the mesh
+ */
+class InstancedMesh final {
+private:
+  VertexArray vertex_array_;
+  GLuint instance_vbo_id_{0};
+  std::size_t n_instances_{0};
+  // instances the instance buffer can hold without a new allocation
+  std::size_t capacity_{0};
+public:
+  // first_location: location of a_model_matrix, the instance attributes
+  // take 7 locations from there
+  // The instance attributes are added to the VAO of vertex_array
+  InstancedMesh(const VertexArray& vertex_array, GLuint first_location);
+  // Upload the model matrices, the normal matrices are computed from them
+  void setInstances(const std::vector<glm::mat4>& model_matrix_list);
+  void setInstances(const std::vector<InstanceTransform>& transform_list);
+  std::size_t getInstanceCount() const;
+  void draw(GLenum mode = GL_TRIANGLES);
+};
@@ -0,0 +1,160 @@
+#include <algorithm>
+
+#include "JobSystem.hpp"
+
+JobSystem::JobSystem(std::size_t n_threads)
+{
+  if (n_threads == 0)
+  {
+    n_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+
+  for (std::size_t i = 0; i < n_threads; i++)
+  {
+    queue_list_.push_back(std::make_unique<JobQueue_>());
+  }
+
+  // the calling thread is the thread 0
+  worker_list_.reserve(n_threads - 1);
+  for (std::size_t i = 1; i < n_threads; i++)
+  {
+    worker_list_.emplace_back(&JobSystem::work_, this, i);
+  }
+}
+
+JobSystem::~JobSystem()
+{
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    stopping_ = true;
+  }
+
+  job_condition_.notify_all();
+
+  for (auto& worker : worker_list_)
+  {
+    worker.join();
+  }
+}
+
+std::size_t JobSystem::getThreadCount() const
+{
+  return queue_list_.size();
+}
+
+std::size_t JobSystem::getStolenJobCount() const
+{
+  return n_stolen_jobs_.load();
+}
+
+void JobSystem::work_(std::size_t thread_index)
+{
+  while (true)
+  {
+    if (runJob_(thread_index))
+    {
+      continue;
+    }
+
+    // nothing to do: sleep until the next parallelFor
+    std::unique_lock<std::mutex> lock{mutex_};
+    job_condition_.wait(lock, [this] { return stopping_ || n_queued_jobs_.load() > 0; });
+
+    if (stopping_ == true)
+    {
+      return;
+    }
+  }
+}
+
+bool JobSystem::runJob_(std::size_t thread_index)
+{
+  const std::size_t n_threads{queue_list_.size()};
+  Job_ job{};
+  bool is_found{false};
+
+  // its own queue first, then the next ones
+  for (std::size_t k = 0; k < n_threads && !is_found; k++)
+  {
+    auto& queue{*queue_list_[(thread_index + k) % n_threads]};
+    std::lock_guard<std::mutex> lock{queue.mutex};
+    if (queue.job_list.empty())
+    {
+      continue;
+    }
+    if (k == 0)
+    {
+      job = queue.job_list.back();
+      queue.job_list.pop_back();
+    }
+    else
+    {
+      // the owner works from the back: the front is the farthest from it
+      job = queue.job_list.front();
+      queue.job_list.pop_front();
+      n_stolen_jobs_++;
+    }
+    is_found = true;
+  }
+
+  if (!is_found)
+  {
+    return false;
+  }
+
+  n_queued_jobs_--;
+  (*job.task->body)(job.begin, job.end, thread_index);
+  // release: what the body wrote is visible to the thread seeing 0
+  job.task->n_remaining_chunks.fetch_sub(1, std::memory_order_release);
+  return true;
+}
+
+void JobSystem::parallelFor(std::size_t n_items, std::size_t grain_size, const LoopBody& body)
+{
+  if (n_items == 0)
+  {
+    return;
+  }
+
+  grain_size = std::max(grain_size, std::size_t{1});
+  const std::size_t n_chunks{(n_items + grain_size - 1) / grain_size};
+  const std::size_t n_threads{queue_list_.size()};
+
+  // alone: no queue at all
+  if (n_threads == 1)
+  {
+    body(0, n_items, 0);
+    return;
+  }
+
+  Task_ task{&body, {n_chunks}};
+  // counted before they are queued, so it never goes below 0
+  n_queued_jobs_ += n_chunks;
+
+  // thread t gets the chunks t * n_chunks / n_threads to (t + 1) * n_chunks / n_threads
+  for (std::size_t thread_index = 0; thread_index < n_threads; thread_index++)
+  {
+    auto& queue{*queue_list_[thread_index]};
+    std::lock_guard<std::mutex> lock{queue.mutex};
+    for (std::size_t chunk = thread_index * n_chunks / n_threads; chunk < (thread_index + 1) * n_chunks / n_threads; chunk++)
+    {
+      queue.job_list.push_back(Job_{&task, chunk * grain_size, std::min((chunk + 1) * grain_size, n_items)});
+    }
+  }
+
+  // taking the mutex: a worker is either waiting, and woken up, or
+  // will see the jobs before waiting
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+  }
+  job_condition_.notify_all();
+
+  // work too, then wait for the chunks taken by the others
+  while (task.n_remaining_chunks.load(std::memory_order_acquire) > 0)
+  {
+    if (!runJob_(0))
+    {
+      std::this_thread::yield();
+    }
+  }
+}
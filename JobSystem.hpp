@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Pool of threads sharing the iterations of a loop:
+ *
+ * JobSystem job_system{};   // one thread per core, the calling one included
+ * job_system.parallelFor(n_objects, 1024, [&](std::size_t begin, std::size_t end, std::size_t thread_index) {
+ *   for (std::size_t i = begin; i < end; i++) ... write in the data of thread_index
+ * });
+ *
+ * The loop is cut in chunks of grain_size iterations, and each thread gets
+ * a queue of neighbour chunks. A thread takes the chunks of its own queue
+ * (from the back), and when it is empty steals those of another thread
+ * (from the front): a thread slowed down by heavier chunks, or by the
+ * system, does not make the others wait (work stealing)
+ *
+ * The calling thread works too (thread_index 0) until the loop is done
+ * thread_index is stable for a thread, so the body can write in per thread
+ * buffers without any lock, and merge them after parallelFor
+ */
+class JobSystem final {
+public:
+  using LoopBody = std::function<void(std::size_t begin, std::size_t end, std::size_t thread_index)>;
+private:
+  // a parallelFor being run
+  struct Task_ {
+    const LoopBody* body;
+    std::atomic<std::size_t> n_remaining_chunks;
+  };
+  struct Job_ {
+    Task_* task;
+    std::size_t begin;
+    std::size_t end;
+  };
+  // one per thread, on its own cache line: the threads do not slow each
+  // other down by writing next to each other
+  struct alignas(64) JobQueue_ {
+    std::mutex mutex;
+    std::deque<Job_> job_list;
+  };
+
+  std::vector<std::thread> worker_list_;
+  std::vector<std::unique_ptr<JobQueue_>> queue_list_;
+  std::atomic<std::size_t> n_queued_jobs_{0};
+  std::atomic<std::size_t> n_stolen_jobs_{0};
+  bool stopping_{false};
+  std::mutex mutex_;
+  std::condition_variable job_condition_;
+
+  void work_(std::size_t thread_index);
+  // Run a job of the queue of the thread, else steal one
+  // Return false when all the queues are empty
+  bool runJob_(std::size_t thread_index);
+public:
+  // n_threads: the calling thread and n_threads - 1 workers (0: one per core)
+  explicit JobSystem(std::size_t n_threads = 0);
+  ~JobSystem();
+  JobSystem(const JobSystem&) = delete;
+  JobSystem& operator=(const JobSystem&) = delete;
+
+  std::size_t getThreadCount() const;
+  // Run body on the chunks of [0, n_items) and return when they are all done
+  // Only from the thread which created the JobSystem, not from a body
+  void parallelFor(std::size_t n_items, std::size_t grain_size, const LoopBody& body);
+  // jobs run by another thread than the one they were given to, since the start
+  std::size_t getStolenJobCount() const;
+};
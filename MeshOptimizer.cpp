@@ -0,0 +1,301 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <unordered_map>
+
+#include "MeshOptimizer.hpp"
+#include "UniformHash.hpp"
+
+namespace {
+
+// Forsyth scoring parameters, the values of the original article
+constexpr std::size_t forsyth_cache_size{32};
+constexpr float cache_decay_power{1.5f};
+constexpr float last_triangle_score{0.75f};
+constexpr float valence_boost_scale{2.0f};
+constexpr float valence_boost_power{0.5f};
+
+// Score of a vertex at cache_position in the LRU cache (-1 if not in it)
+// still used by n_remaining triangles
+float vertexScore(int cache_position, unsigned int n_remaining)
+{
+  // no triangle left: the vertex must not attract any triangle
+  if (n_remaining == 0)
+  {
+    return -1.0f;
+  }
+
+  float score{0.0f};
+  if (cache_position >= 0)
+  {
+    if (cache_position < 3)
+    {
+      // used by the last triangle: a fixed score, lower than the next ones
+      // so the strips do not go back and forth
+      score = last_triangle_score;
+    }
+    else
+    {
+      const float scaler{1.0f / (forsyth_cache_size - 3)};
+      score = std::pow(1.0f - (cache_position - 3) * scaler, cache_decay_power);
+    }
+  }
+
+  // boost the vertices with few triangles left, to finish them
+  // instead of leaving lonely triangles for the end
+  score += valence_boost_scale * std::pow(static_cast<float>(n_remaining), -valence_boost_power);
+
+  return score;
+}
+
+}
+
+IndexedMesh weldVertices(const std::vector<float>& vertices, std::size_t vertex_stride)
+{
+  IndexedMesh mesh{};
+  mesh.vertex_stride = vertex_stride;
+
+  const std::size_t n_input{vertices.size() / vertex_stride};
+  const std::size_t vertex_bytes{vertex_stride * sizeof(float)};
+  mesh.indices.reserve(n_input);
+  mesh.vertices.reserve(vertices.size());
+
+  // hash of the vertex bytes -> index of the welded vertices with this hash
+  std::unordered_multimap<std::uint64_t, unsigned int> vertex_map{};
+  vertex_map.reserve(n_input);
+
+  std::vector<float> vertex(vertex_stride);
+  for (std::size_t i = 0; i < n_input; i++)
+  {
+    // adding 0.0 turns -0.0 into 0.0, so they have the same bytes
+    for (std::size_t j = 0; j < vertex_stride; j++)
+    {
+      vertex[j] = vertices[i * vertex_stride + j] + 0.0f;
+    }
+
+    const std::uint64_t hash{hashBytes(std::string_view{reinterpret_cast<const char*>(vertex.data()), vertex_bytes})};
+
+    unsigned int index{std::numeric_limits<unsigned int>::max()};
+    const auto range{vertex_map.equal_range(hash)};
+    for (auto it = range.first; it != range.second; ++it)
+    {
+      if (std::memcmp(mesh.vertices.data() + it->second * vertex_stride, vertex.data(), vertex_bytes) == 0)
+      {
+        index = it->second;
+        break;
+      }
+    }
+
+    if (index == std::numeric_limits<unsigned int>::max())
+    {
+      index = static_cast<unsigned int>(mesh.countVertices());
+      mesh.vertices.insert(mesh.vertices.end(), vertex.begin(), vertex.end());
+      vertex_map.emplace(hash, index);
+    }
+
+    mesh.indices.push_back(index);
+  }
+
+  return mesh;
+}
+
+void optimizeVertexCache(IndexedMesh& mesh)
+{
+  const std::size_t n_vertices{mesh.countVertices()};
+  const std::size_t n_triangles{mesh.countTriangles()};
+  if (n_triangles == 0)
+  {
+    return;
+  }
+
+  // triangles using each vertex, packed in a single array:
+  // the ones of vertex v start at triangle_offsets[v], and the
+  // n_remaining[v] first of them are not emitted yet
+  std::vector<unsigned int> n_remaining(n_vertices, 0);
+  for (unsigned int index : mesh.indices)
+  {
+    n_remaining[index]++;
+  }
+
+  std::vector<std::size_t> triangle_offsets(n_vertices + 1, 0);
+  for (std::size_t v = 0; v < n_vertices; v++)
+  {
+    triangle_offsets[v + 1] = triangle_offsets[v] + n_remaining[v];
+  }
+
+  std::vector<unsigned int> vertex_triangles(mesh.indices.size());
+  {
+    std::vector<std::size_t> fill{triangle_offsets.begin(), triangle_offsets.end() - 1};
+    for (std::size_t t = 0; t < n_triangles; t++)
+    {
+      for (std::size_t k = 0; k < 3; k++)
+      {
+        vertex_triangles[fill[mesh.indices[t * 3 + k]]++] = static_cast<unsigned int>(t);
+      }
+    }
+  }
+
+  std::vector<int> cache_positions(n_vertices, -1);
+  std::vector<float> vertex_scores(n_vertices);
+  for (std::size_t v = 0; v < n_vertices; v++)
+  {
+    vertex_scores[v] = vertexScore(-1, n_remaining[v]);
+  }
+
+  std::vector<float> triangle_scores(n_triangles);
+  std::vector<bool> emitted(n_triangles, false);
+  for (std::size_t t = 0; t < n_triangles; t++)
+  {
+    triangle_scores[t] = vertex_scores[mesh.indices[t * 3]]
+      + vertex_scores[mesh.indices[t * 3 + 1]]
+      + vertex_scores[mesh.indices[t * 3 + 2]];
+  }
+
+  // simulated LRU cache, the most recent vertex first
+  // it may hold 3 more vertices than the cache while it is updated
+  std::vector<unsigned int> cache{};
+  std::vector<unsigned int> new_cache{};
+  cache.reserve(forsyth_cache_size + 3);
+  new_cache.reserve(forsyth_cache_size + 3);
+
+  std::vector<unsigned int> new_indices{};
+  new_indices.reserve(mesh.indices.size());
+
+  std::size_t best_triangle{static_cast<std::size_t>(
+    std::max_element(triangle_scores.begin(), triangle_scores.end()) - triangle_scores.begin())};
+
+  for (std::size_t n_emitted = 0; n_emitted < n_triangles; n_emitted++)
+  {
+    const unsigned int* triangle{&mesh.indices[best_triangle * 3]};
+    new_indices.insert(new_indices.end(), triangle, triangle + 3);
+    emitted[best_triangle] = true;
+
+    // the triangle is no longer waiting on its vertices
+    for (std::size_t k = 0; k < 3; k++)
+    {
+      const unsigned int v{triangle[k]};
+      unsigned int* first{&vertex_triangles[triangle_offsets[v]]};
+      unsigned int* last{first + n_remaining[v]};
+      *std::find(first, last, static_cast<unsigned int>(best_triangle)) = *(last - 1);
+      n_remaining[v]--;
+    }
+
+    // its vertices go to the front of the cache
+    new_cache.assign(triangle, triangle + 3);
+    for (unsigned int v : cache)
+    {
+      if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+      {
+        new_cache.push_back(v);
+      }
+    }
+
+    // update the vertices which moved in (or out of) the cache,
+    // then the triangles still using them
+    for (std::size_t i = 0; i < new_cache.size(); i++)
+    {
+      const unsigned int v{new_cache[i]};
+      cache_positions[v] = i < forsyth_cache_size ? static_cast<int>(i) : -1;
+      vertex_scores[v] = vertexScore(cache_positions[v], n_remaining[v]);
+    }
+
+    float best_score{-1.0f};
+    bool found{false};
+    for (unsigned int v : new_cache)
+    {
+      for (std::size_t j = 0; j < n_remaining[v]; j++)
+      {
+        const unsigned int t{vertex_triangles[triangle_offsets[v] + j]};
+        triangle_scores[t] = vertex_scores[mesh.indices[t * 3]]
+          + vertex_scores[mesh.indices[t * 3 + 1]]
+          + vertex_scores[mesh.indices[t * 3 + 2]];
+        if (triangle_scores[t] > best_score)
+        {
+          best_score = triangle_scores[t];
+          best_triangle = t;
+          found = true;
+        }
+      }
+    }
+
+    if (new_cache.size() > forsyth_cache_size)
+    {
+      new_cache.resize(forsyth_cache_size);
+    }
+    std::swap(cache, new_cache);
+
+    // no triangle touches the cache: the mesh is disconnected here,
+    // look for the best one among all the remaining triangles
+    if (!found && n_emitted + 1 < n_triangles)
+    {
+      best_score = -std::numeric_limits<float>::max();
+      for (std::size_t t = 0; t < n_triangles; t++)
+      {
+        if (!emitted[t] && triangle_scores[t] > best_score)
+        {
+          best_score = triangle_scores[t];
+          best_triangle = t;
+        }
+      }
+    }
+  }
+
+  mesh.indices = std::move(new_indices);
+}
+
+void optimizeVertexFetch(IndexedMesh& mesh)
+{
+  const std::size_t n_vertices{mesh.countVertices()};
+  const std::size_t stride{mesh.vertex_stride};
+  constexpr unsigned int unused{std::numeric_limits<unsigned int>::max()};
+
+  std::vector<unsigned int> remap(n_vertices, unused);
+  std::vector<float> new_vertices{};
+  new_vertices.reserve(mesh.vertices.size());
+
+  unsigned int next_index{0};
+  for (unsigned int& index : mesh.indices)
+  {
+    if (remap[index] == unused)
+    {
+      remap[index] = next_index++;
+      const float* vertex{mesh.vertices.data() + index * stride};
+      new_vertices.insert(new_vertices.end(), vertex, vertex + stride);
+    }
+    index = remap[index];
+  }
+
+  // vertices never used by a triangle are dropped
+  mesh.vertices = std::move(new_vertices);
+}
+
+float computeACMR(const std::vector<unsigned int>& indices, std::size_t cache_size)
+{
+  if (indices.size() < 3)
+  {
+    return 0.0f;
+  }
+
+  const unsigned int max_index{*std::max_element(indices.begin(), indices.end())};
+
+  // a FIFO cache only needs to know when a vertex entered it:
+  // it is still in it if less than cache_size misses happened since
+  std::vector<std::size_t> entered_at(static_cast<std::size_t>(max_index) + 1, 0);
+  std::vector<bool> seen(static_cast<std::size_t>(max_index) + 1, false);
+  std::size_t n_misses{0};
+
+  for (unsigned int index : indices)
+  {
+    if (!seen[index] || n_misses - entered_at[index] >= cache_size)
+    {
+      seen[index] = true;
+      entered_at[index] = n_misses;
+      n_misses++;
+    }
+  }
+
+  return static_cast<float>(n_misses) / static_cast<float>(indices.size() / 3);
+}
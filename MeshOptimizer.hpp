@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Mesh processing on the float arrays of the examples
+ * (vertex_stride floats per vertex, for example 8 for position, normal, uv)
+ *
+ * The cubes are drawn with 36 vertices and glDrawArrays because a corner
+ * has a different texture coordinate (or normal) on each face: it is
+ * not one vertex but three. Welding only merges the vertices equal
+ * on all their attributes, so seams are kept and an index buffer can be used
+ *
+ * auto mesh{weldVertices(cube_vertices, 8)};   // 36 -> 24 vertices
+ * optimizeVertexCache(mesh);                  // triangle order
+ * optimizeVertexFetch(mesh);                  // vertex order
+ */
+
+struct IndexedMesh final {
+  std::vector<float> vertices;
+  std::vector<unsigned int> indices;
+  std::size_t vertex_stride{0};
+
+  std::size_t countVertices() const { return vertices.size() / vertex_stride; }
+  std::size_t countTriangles() const { return indices.size() / 3; }
+};
+
+// Merge the identical vertices of a triangle list (3 vertices per triangle,
+// as drawn by glDrawArrays(GL_TRIANGLES, ...)) and build the index buffer
+// Vertices must be bitwise equal to be merged (0.0 and -0.0 are the same)
+IndexedMesh weldVertices(const std::vector<float>& vertices, std::size_t vertex_stride);
+
+// Reorder the triangles so the vertices are reused while they are still
+// in the post-transform cache of the GPU (the vertex shader is not run again)
+// Tom Forsyth "Linear-Speed Vertex Cache Optimisation": greedy choice of the
+// triangle with the best score, the score of a vertex being higher when it
+// is recent in a simulated LRU cache and when few triangles still use it
+void optimizeVertexCache(IndexedMesh& mesh);
+
+// Renumber the vertices in the order of their first use by the index buffer,
+// so the vertex fetch reads memory almost linearly
+// Run it after optimizeVertexCache, as it depends on the triangle order
+void optimizeVertexFetch(IndexedMesh& mesh);
+
+// Average Cache Miss Ratio: vertex shader invocations per triangle, with
+// a FIFO post-transform cache of cache_size vertices
+// 3.0 for glDrawArrays (no reuse at all), 0.5 is the best possible
+// on a large regular grid
+float computeACMR(const std::vector<unsigned int>& indices, std::size_t cache_size = 16);
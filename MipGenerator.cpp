@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "MipGenerator.hpp"
+
+namespace {
+
+// average of the 4 source pixels of the dst pixel (x, y), for any size
+void downsampleBoxPixel(const unsigned char* src, int width, int height, int n_channels, int x, int y, unsigned char* dst_pixel)
+{
+  // an odd or 1 pixel wide image has no second column/row to read
+  const int x0{std::min(2 * x, width - 1)};
+  const int x1{std::min(2 * x + 1, width - 1)};
+  const int y0{std::min(2 * y, height - 1)};
+  const int y1{std::min(2 * y + 1, height - 1)};
+
+  for (int c = 0; c < n_channels; c++)
+  {
+    const int sum{
+      src[(y0 * width + x0) * n_channels + c]
+      + src[(y0 * width + x1) * n_channels + c]
+      + src[(y1 * width + x0) * n_channels + c]
+      + src[(y1 * width + x1) * n_channels + c]
+    };
+    // + 2 to round to the nearest
+    dst_pixel[c] = static_cast<unsigned char>((sum + 2) >> 2);
+  }
+}
+
+#if defined(__SSE2__)
+// 2 dst pixels per iteration, from 4 RGBA pixels of 2 rows
+// return the first dst x not done
+int downsampleBoxRowRGBA(const unsigned char* row0, const unsigned char* row1, int dst_width, unsigned char* dst_row)
+{
+  const __m128i zero{_mm_setzero_si128()};
+  const __m128i rounding{_mm_set1_epi16(2)};
+  int x{0};
+
+  for (; x + 2 <= dst_width; x += 2)
+  {
+    // 4 source pixels of each row
+    const __m128i top{_mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 8))};
+    const __m128i bottom{_mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 8))};
+
+    // vertical sum on 16 bits: pixels 0 and 1 in lo, 2 and 3 in hi
+    const __m128i lo{_mm_add_epi16(_mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero))};
+    const __m128i hi{_mm_add_epi16(_mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero))};
+
+    // horizontal sum: (0 + 1) and (2 + 3)
+    __m128i sum{_mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi))};
+    sum = _mm_srli_epi16(_mm_add_epi16(sum, rounding), 2);
+
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst_row + x * 4), _mm_packus_epi16(sum, zero));
+  }
+
+  return x;
+}
+#endif
+
+}
+
+void downsampleBox(const unsigned char* src, int width, int height, int n_channels, unsigned char* dst)
+{
+  const int dst_width{std::max(1, width / 2)};
+  const int dst_height{std::max(1, height / 2)};
+
+  for (int y = 0; y < dst_height; y++)
+  {
+    int x{0};
+    unsigned char* dst_row{dst + y * dst_width * n_channels};
+
+#if defined(__SSE2__)
+    // the fast path needs the 2 rows and the 2 columns of each dst pixel
+    if (n_channels == 4 && width >= 2 && height >= 2)
+    {
+      x = downsampleBoxRowRGBA(
+        src + (2 * y) * width * 4,
+        src + (2 * y + 1) * width * 4,
+        dst_width,
+        dst_row
+      );
+    }
+#endif
+
+    for (; x < dst_width; x++)
+    {
+      downsampleBoxPixel(src, width, height, n_channels, x, y, dst_row + x * n_channels);
+    }
+  }
+}
+
+std::vector<MipLevel> generateMipChain(const unsigned char* data, int width, int height, int n_channels)
+{
+  std::vector<MipLevel> level_list;
+
+  level_list.push_back(MipLevel{width, height, std::vector<unsigned char>(data, data + width * height * n_channels)});
+
+  while (width > 1 || height > 1)
+  {
+    const int dst_width{std::max(1, width / 2)};
+    const int dst_height{std::max(1, height / 2)};
+
+    MipLevel level{dst_width, dst_height, std::vector<unsigned char>(dst_width * dst_height * n_channels)};
+    downsampleBox(level_list.back().data.data(), width, height, n_channels, level.data.data());
+    level_list.push_back(std::move(level));
+
+    width = dst_width;
+    height = dst_height;
+  }
+
+  return level_list;
+}
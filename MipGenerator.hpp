@@ -0,0 +1,18 @@
+#pragma once
+
+#include <vector>
+
+// One level of a mipmap chain, tightly packed (no row alignment)
+struct MipLevel {
+  int width;
+  int height;
+  std::vector<unsigned char> data;
+};
+
+// Halve an image with a 2x2 box filter (same result as glGenerateMipmap
+// on most drivers), dst must hold max(1, width / 2) * max(1, height / 2) pixels
+// Uses SSE2 for 4 channels images when available
+void downsampleBox(const unsigned char* src, int width, int height, int n_channels, unsigned char* dst);
+
+// Build the whole chain, from the image itself (level 0) down to 1x1
+std::vector<MipLevel> generateMipChain(const unsigned char* data, int width, int height, int n_channels);
@@ -0,0 +1,342 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "OcclusionBuffer.hpp"
+#include "MeshOptimizer.hpp"
+
+namespace {
+
+// the depth of a box is compared to depths interpolated over the triangles:
+// without a small margin, a box could be hidden by its own faces
+constexpr float depth_bias{1e-5f};
+
+}
+
+OccluderMesh makeOccluderMesh(const std::vector<float>& vertices, std::size_t vertex_stride)
+{
+  const std::size_t n_vertices{vertices.size() / vertex_stride};
+  std::vector<float> position_list(n_vertices * 3);
+  for (std::size_t i = 0; i < n_vertices; i++)
+  {
+    for (std::size_t j = 0; j < 3; j++)
+    {
+      position_list[i * 3 + j] = vertices[i * vertex_stride + j];
+    }
+  }
+
+  // only the positions are compared: the corners of the cube are merged
+  IndexedMesh mesh{weldVertices(position_list, 3)};
+
+  OccluderMesh occluder{};
+  for (std::size_t i = 0; i < mesh.countVertices(); i++)
+  {
+    occluder.positions.emplace_back(mesh.vertices[i * 3], mesh.vertices[i * 3 + 1], mesh.vertices[i * 3 + 2]);
+  }
+  occluder.indices = std::move(mesh.indices);
+
+  // the triangles of the examples do not all have the same winding:
+  // turn the ones whose normal points inside (against the vertex normal)
+  for (std::size_t t = 0; t < occluder.indices.size() / 3; t++)
+  {
+    unsigned int* triangle{&occluder.indices[t * 3]};
+    const glm::vec3 normal{glm::cross(
+      occluder.positions[triangle[1]] - occluder.positions[triangle[0]],
+      occluder.positions[triangle[2]] - occluder.positions[triangle[0]]
+    )};
+    const float* vertex_normal{&vertices[t * 3 * vertex_stride + 3]};
+    if (glm::dot(normal, glm::vec3(vertex_normal[0], vertex_normal[1], vertex_normal[2])) < 0.0f)
+    {
+      std::swap(triangle[1], triangle[2]);
+    }
+  }
+
+  return occluder;
+}
+
+OcclusionBuffer::OcclusionBuffer(int width, int height) :
+  width_{(std::max(width, 4) + 3) / 4 * 4},
+  height_{std::max(height, 1)}
+{
+  glm::ivec2 size{width_, height_};
+  level_size_list_.push_back(size);
+  while (size.x > 1 || size.y > 1)
+  {
+    size = (size + 1) / 2;
+    level_size_list_.push_back(size);
+  }
+
+  for (const auto& level_size : level_size_list_)
+  {
+    level_list_.emplace_back(static_cast<std::size_t>(level_size.x) * level_size.y, 1.0f);
+  }
+}
+
+void OcclusionBuffer::clear(const glm::mat4& view_projection_matrix)
+{
+  view_projection_matrix_ = view_projection_matrix;
+  std::fill(level_list_[0].begin(), level_list_[0].end(), 1.0f);
+  n_triangles_ = 0;
+}
+
+void OcclusionBuffer::addOccluder(const OccluderMesh& occluder, const glm::mat4& model_matrix)
+{
+  const glm::mat4 model_view_projection_matrix{view_projection_matrix_ * model_matrix};
+  clip_position_list_.resize(occluder.positions.size());
+  for (std::size_t i = 0; i < occluder.positions.size(); i++)
+  {
+    clip_position_list_[i] = model_view_projection_matrix * glm::vec4(occluder.positions[i], 1.0f);
+  }
+
+  for (std::size_t t = 0; t + 2 < occluder.indices.size(); t += 3)
+  {
+    const glm::vec4& c0{clip_position_list_[occluder.indices[t]]};
+    const glm::vec4& c1{clip_position_list_[occluder.indices[t + 1]]};
+    const glm::vec4& c2{clip_position_list_[occluder.indices[t + 2]]};
+
+    // in front of the near plane (or behind the camera), the GPU clips
+    // the triangle: without clipping here, it is skipped, it can only
+    // hide less
+    if (c0.z < -c0.w || c1.z < -c1.w || c2.z < -c2.w)
+    {
+      continue;
+    }
+
+    auto toScreen{[&](const glm::vec4& clip) {
+      const glm::vec3 ndc{glm::vec3(clip) / clip.w};
+      return glm::vec3(
+        (ndc.x * 0.5f + 0.5f) * width_,
+        (ndc.y * 0.5f + 0.5f) * height_,
+        ndc.z * 0.5f + 0.5f
+      );
+    }};
+    const glm::vec3 v0{toScreen(c0)};
+    const glm::vec3 v1{toScreen(c1)};
+    const glm::vec3 v2{toScreen(c2)};
+
+    // back faces are hidden by the front faces of the same occluder
+    const float area{(v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x)};
+    if (area <= 0.0f)
+    {
+      continue;
+    }
+
+    rasterizeTriangle_(v0, v1, v2);
+    n_triangles_++;
+  }
+}
+
+void OcclusionBuffer::rasterizeTriangle_(const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2)
+{
+  const int x_min{std::max(static_cast<int>(std::floor(std::min({v0.x, v1.x, v2.x}))), 0) & ~3};
+  const int x_max{std::min(static_cast<int>(std::floor(std::max({v0.x, v1.x, v2.x}))), width_ - 1)};
+  const int y_min{std::max(static_cast<int>(std::floor(std::min({v0.y, v1.y, v2.y}))), 0)};
+  const int y_max{std::min(static_cast<int>(std::floor(std::max({v0.y, v1.y, v2.y}))), height_ - 1)};
+  if (x_min > x_max || y_min > y_max)
+  {
+    return;
+  }
+
+  // edge functions: w0 is > 0 on the side of v0 of the edge v1 v2, ...
+  // they are linear in x and y, so they are incremented from pixel to pixel
+  // The depth z / w is linear in screen space too:
+  // z = z0 + w1 * (z1 - z0) / area + w2 * (z2 - z0) / area
+  const float area{(v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x)};
+  const float dz1{(v1.z - v0.z) / area};
+  const float dz2{(v2.z - v0.z) / area};
+
+  const float w0_dx{v1.y - v2.y};
+  const float w1_dx{v2.y - v0.y};
+  const float w2_dx{v0.y - v1.y};
+  const float w0_dy{v2.x - v1.x};
+  const float w1_dy{v0.x - v2.x};
+  const float w2_dy{v1.x - v0.x};
+
+  // edge values at the center of the pixel (x_min, y_min)
+  const float px{x_min + 0.5f};
+  const float py{y_min + 0.5f};
+  float w0_row{(px - v1.x) * w0_dx + (py - v1.y) * w0_dy};
+  float w1_row{(px - v2.x) * w1_dx + (py - v2.y) * w1_dy};
+  float w2_row{(px - v0.x) * w2_dx + (py - v0.y) * w2_dy};
+
+  float* depth_buffer{level_list_[0].data()};
+
+#if defined(__SSE2__)
+  const __m128 lane{_mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f)};
+  const __m128 w0_step{_mm_set1_ps(4.0f * w0_dx)};
+  const __m128 w1_step{_mm_set1_ps(4.0f * w1_dx)};
+  const __m128 w2_step{_mm_set1_ps(4.0f * w2_dx)};
+  const __m128 z0{_mm_set1_ps(v0.z)};
+  const __m128 dz1_4{_mm_set1_ps(dz1)};
+  const __m128 dz2_4{_mm_set1_ps(dz2)};
+  const __m128 zero{_mm_setzero_ps()};
+
+  for (int y = y_min; y <= y_max; y++)
+  {
+    // the 4 lanes are the pixels x, x + 1, x + 2, x + 3
+    __m128 w0{_mm_add_ps(_mm_set1_ps(w0_row), _mm_mul_ps(lane, _mm_set1_ps(w0_dx)))};
+    __m128 w1{_mm_add_ps(_mm_set1_ps(w1_row), _mm_mul_ps(lane, _mm_set1_ps(w1_dx)))};
+    __m128 w2{_mm_add_ps(_mm_set1_ps(w2_row), _mm_mul_ps(lane, _mm_set1_ps(w2_dx)))};
+    float* row{depth_buffer + static_cast<std::size_t>(y) * width_};
+
+    // width_ is a multiple of 4 and x_min too: the 4 pixels are in the row
+    for (int x = x_min; x <= x_max; x += 4)
+    {
+      const __m128 inside{_mm_and_ps(
+        _mm_and_ps(_mm_cmpge_ps(w0, zero), _mm_cmpge_ps(w1, zero)),
+        _mm_cmpge_ps(w2, zero)
+      )};
+      if (_mm_movemask_ps(inside) != 0)
+      {
+        const __m128 depth{_mm_add_ps(z0, _mm_add_ps(_mm_mul_ps(w1, dz1_4), _mm_mul_ps(w2, dz2_4)))};
+        const __m128 previous_depth{_mm_loadu_ps(row + x)};
+        const __m128 nearest_depth{_mm_min_ps(previous_depth, depth)};
+        // the pixels out of the triangle keep their depth
+        _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearest_depth), _mm_andnot_ps(inside, previous_depth)));
+      }
+      w0 = _mm_add_ps(w0, w0_step);
+      w1 = _mm_add_ps(w1, w1_step);
+      w2 = _mm_add_ps(w2, w2_step);
+    }
+
+    w0_row += w0_dy;
+    w1_row += w1_dy;
+    w2_row += w2_dy;
+  }
+#else
+  for (int y = y_min; y <= y_max; y++)
+  {
+    float w0{w0_row};
+    float w1{w1_row};
+    float w2{w2_row};
+    float* row{depth_buffer + static_cast<std::size_t>(y) * width_};
+
+    for (int x = x_min; x <= x_max; x++)
+    {
+      if (w0 >= 0.0f && w1 >= 0.0f && w2 >= 0.0f)
+      {
+        row[x] = std::min(row[x], v0.z + w1 * dz1 + w2 * dz2);
+      }
+      w0 += w0_dx;
+      w1 += w1_dx;
+      w2 += w2_dx;
+    }
+
+    w0_row += w0_dy;
+    w1_row += w1_dy;
+    w2_row += w2_dy;
+  }
+#endif
+}
+
+void OcclusionBuffer::buildHiZ()
+{
+  for (std::size_t level = 1; level < level_list_.size(); level++)
+  {
+    const glm::ivec2 source_size{level_size_list_[level - 1]};
+    const glm::ivec2 size{level_size_list_[level]};
+    const float* source{level_list_[level - 1].data()};
+    float* destination{level_list_[level].data()};
+
+    for (int y = 0; y < size.y; y++)
+    {
+      // an odd size has a last texel covering only 1 texel of the level below
+      const int y0{2 * y};
+      const int y1{std::min(2 * y + 1, source_size.y - 1)};
+      for (int x = 0; x < size.x; x++)
+      {
+        const int x0{2 * x};
+        const int x1{std::min(2 * x + 1, source_size.x - 1)};
+        destination[y * size.x + x] = std::max(
+          std::max(source[y0 * source_size.x + x0], source[y0 * source_size.x + x1]),
+          std::max(source[y1 * source_size.x + x0], source[y1 * source_size.x + x1])
+        );
+      }
+    }
+  }
+}
+
+bool OcclusionBuffer::isVisible(const Aabb& box) const
+{
+  glm::vec2 screen_min{std::numeric_limits<float>::max()};
+  glm::vec2 screen_max{-std::numeric_limits<float>::max()};
+  float min_depth{std::numeric_limits<float>::max()};
+
+  for (int corner = 0; corner < 8; corner++)
+  {
+    const glm::vec4 position{
+      corner & 1 ? box.max_corner.x : box.min_corner.x,
+      corner & 2 ? box.max_corner.y : box.min_corner.y,
+      corner & 4 ? box.max_corner.z : box.min_corner.z,
+      1.0f
+    };
+    const glm::vec4 clip{view_projection_matrix_ * position};
+    // the box crosses the near plane: it covers the whole screen
+    if (clip.z < -clip.w)
+    {
+      return true;
+    }
+    const glm::vec3 ndc{glm::vec3(clip) / clip.w};
+    screen_min = glm::min(screen_min, glm::vec2(ndc));
+    screen_max = glm::max(screen_max, glm::vec2(ndc));
+    min_depth = std::min(min_depth, ndc.z * 0.5f + 0.5f);
+  }
+
+  // rectangle of the pixels touched by the box
+  int x0{static_cast<int>(std::floor((screen_min.x * 0.5f + 0.5f) * width_))};
+  int x1{static_cast<int>(std::floor((screen_max.x * 0.5f + 0.5f) * width_))};
+  int y0{static_cast<int>(std::floor((screen_min.y * 0.5f + 0.5f) * height_))};
+  int y1{static_cast<int>(std::floor((screen_max.y * 0.5f + 0.5f) * height_))};
+  if (x1 < 0 || y1 < 0 || x0 >= width_ || y0 >= height_)
+  {
+    return false;
+  }
+  x0 = std::max(x0, 0);
+  y0 = std::max(y0, 0);
+  x1 = std::min(x1, width_ - 1);
+  y1 = std::min(y1, height_ - 1);
+
+  // first level where the rectangle covers at most 2x2 texels
+  std::size_t level{0};
+  while (level + 1 < level_list_.size() && ((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1))
+  {
+    level++;
+  }
+
+  const int level_width{level_size_list_[level].x};
+  const float* texels{level_list_[level].data()};
+  float max_depth{0.0f};
+  for (int y = y0 >> level; y <= y1 >> level; y++)
+  {
+    for (int x = x0 >> level; x <= x1 >> level; x++)
+    {
+      max_depth = std::max(max_depth, texels[y * level_width + x]);
+    }
+  }
+
+  return min_depth <= max_depth + depth_bias;
+}
+
+int OcclusionBuffer::getWidth() const
+{
+  return width_;
+}
+
+int OcclusionBuffer::getHeight() const
+{
+  return height_;
+}
+
+std::size_t OcclusionBuffer::getTriangleCount() const
+{
+  return n_triangles_;
+}
+
+const std::vector<float>& OcclusionBuffer::getDepthBuffer() const
+{
+  return level_list_[0];
+}
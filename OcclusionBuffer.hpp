@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "BoundingVolumeHierarchy.hpp"
+
+// Positions and triangles of an occluder, without the other attributes:
+// the cube of the examples is 8 vertices and 12 triangles here
+// The triangles are counter clockwise seen from outside, so the ones
+// facing away from the camera are skipped
+struct OccluderMesh final {
+  std::vector<glm::vec3> positions;
+  std::vector<unsigned int> indices;
+};
+
+// Build the occluder of a mesh of the examples (vertex_stride floats per
+// vertex, position first then normal, like makeCubeVertices())
+// The vertex normals give the outside of each triangle, whatever its winding
+OccluderMesh makeOccluderMesh(const std::vector<float>& vertices, std::size_t vertex_stride);
+
+/**
+ * Software occlusion culling: the occluders (a few large objects close to
+ * the camera) are rasterized on the CPU in a small depth buffer, then the
+ * bounding boxes of the other objects are tested against it before the
+ * draw list is built, so the hidden objects never reach the GPU
+ *
+ * OcclusionBuffer occlusion_buffer{};
+ * occlusion_buffer.clear(view_projection_matrix);
+ * for (...) occlusion_buffer.addOccluder(cube_occluder, model_matrix);
+ * occlusion_buffer.buildHiZ();
+ * if (occlusion_buffer.isVisible(box)) ...
+ *
+ * The triangles are rasterized 4 pixels at a time with SSE, keeping the
+ * nearest depth (z / w in [0, 1]) of each pixel
+ * The Hi-Z pyramid keeps the farthest depth of each block of 2x2 texels of
+ * the level below: a box is hidden when its nearest depth is behind the
+ * farthest depth of the texels it covers, which is read from the level
+ * where the box covers at most 2x2 texels
+ *
+ * The pixels are only covered when their center is in a triangle: at this
+ * resolution an object seen through a gap thinner than a pixel of the
+ * buffer may be culled
+ */
+class OcclusionBuffer final {
+private:
+  int width_;
+  int height_;
+  glm::mat4 view_projection_matrix_{1.0f};
+  // level 0 is the depth buffer, each level is half the size of the previous
+  std::vector<std::vector<float>> level_list_;
+  std::vector<glm::ivec2> level_size_list_;
+  std::size_t n_triangles_{0};
+  // vertices of the occluder being added, in clip space
+  std::vector<glm::vec4> clip_position_list_;
+
+  // Rasterize a triangle in screen space (pixels, depth in [0, 1])
+  void rasterizeTriangle_(const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2);
+public:
+  // width is rounded up to a multiple of 4, for SSE
+  explicit OcclusionBuffer(int width = 256, int height = 192);
+
+  // Start a frame: the depth buffer is cleared to the far plane
+  void clear(const glm::mat4& view_projection_matrix);
+  void addOccluder(const OccluderMesh& occluder, const glm::mat4& model_matrix);
+  // Build the pyramid from the depth buffer, after the last occluder
+  void buildHiZ();
+
+  // false when the box is hidden by the occluders (or out of the screen)
+  // A box crossing the near plane is always visible
+  bool isVisible(const Aabb& box) const;
+
+  int getWidth() const;
+  int getHeight() const;
+  // triangles rasterized since clear(), after back face culling
+  std::size_t getTriangleCount() const;
+  const std::vector<float>& getDepthBuffer() const;
+};
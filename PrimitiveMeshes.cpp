@@ -0,0 +1,134 @@
+#include <cmath>
+
+#include "PrimitiveMeshes.hpp"
+
+std::vector<float> makeCubeVertices()
+{
+  return {
+    -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f,  0.0f,
+     0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f,  0.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f,  1.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f,  1.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f,  1.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f,  0.0f,
+
+    -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f,  0.0f,
+     0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f,  0.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f,  1.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f,  1.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f,  1.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f,  0.0f,
+
+    -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f,  0.0f,
+    -0.5f,  0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  1.0f,  1.0f,
+    -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f,  1.0f,
+    -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f,  1.0f,
+    -0.5f, -0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  0.0f,  0.0f,
+    -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f,  0.0f,
+
+     0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  1.0f,  0.0f,
+     0.5f,  0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  1.0f,  1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  0.0f,  1.0f,
+     0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  0.0f,  1.0f,
+     0.5f, -0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  0.0f,  0.0f,
+     0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  1.0f,  0.0f,
+
+    -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f,  1.0f,
+     0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  1.0f,  1.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f,  0.0f,
+     0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f,  0.0f,
+    -0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  0.0f,  0.0f,
+    -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f,  1.0f,
+
+    -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f,  1.0f,
+     0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  1.0f,  1.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f,  0.0f,
+     0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f,  0.0f,
+    -0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  0.0f,  0.0f,
+    -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f,  1.0f
+  };
+}
+
+std::vector<float> makeSphereVertices(int N_rings, int N_sectors)
+{
+  std::vector<float> vertices{};
+  vertices.reserve(static_cast<std::size_t>(N_rings) * N_sectors * 6 * 8);
+
+  auto addVertex = [&](int ring, int sector) {
+    const float u{static_cast<float>(sector) / N_sectors};
+    const float v{static_cast<float>(ring) / N_rings};
+    const float theta{u * 2.0f * static_cast<float>(M_PI)};
+    const float phi{v * static_cast<float>(M_PI)};
+    const float x{std::cos(theta) * std::sin(phi)};
+    const float y{std::cos(phi)};
+    const float z{std::sin(theta) * std::sin(phi)};
+    vertices.insert(vertices.end(), {0.5f * x, 0.5f * y, 0.5f * z, x, y, z, u, v});
+  };
+
+  // two triangles per quad, counter clockwise seen from outside
+  for (int ring = 0; ring < N_rings; ring++)
+  {
+    for (int sector = 0; sector < N_sectors; sector++)
+    {
+      addVertex(ring, sector);
+      addVertex(ring + 1, sector + 1);
+      addVertex(ring + 1, sector);
+      addVertex(ring, sector);
+      addVertex(ring, sector + 1);
+      addVertex(ring + 1, sector + 1);
+    }
+  }
+
+  return vertices;
+}
+
+std::vector<float> makePyramidVertices()
+{
+  std::vector<float> vertices{};
+
+  const float apex[3]{0.0f, 0.5f, 0.0f};
+  const float base[4][3]{
+    {-0.5f, -0.5f, -0.5f},
+    { 0.5f, -0.5f, -0.5f},
+    { 0.5f, -0.5f,  0.5f},
+    {-0.5f, -0.5f,  0.5f}
+  };
+
+  auto addTriangle = [&](const float* a, const float* b, const float* c, const float (&uv)[6]) {
+    // flat normal of the face
+    const float ab[3]{b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+    const float ac[3]{c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+    float normal[3]{
+      ab[1] * ac[2] - ab[2] * ac[1],
+      ab[2] * ac[0] - ab[0] * ac[2],
+      ab[0] * ac[1] - ab[1] * ac[0]
+    };
+    const float length{std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2])};
+    for (float& n : normal)
+    {
+      n /= length;
+    }
+
+    const float* corners[3]{a, b, c};
+    for (int i = 0; i < 3; i++)
+    {
+      vertices.insert(vertices.end(), {
+        corners[i][0], corners[i][1], corners[i][2],
+        normal[0], normal[1], normal[2],
+        uv[i * 2], uv[i * 2 + 1]
+      });
+    }
+  };
+
+  // sides, counter clockwise seen from outside
+  for (int i = 0; i < 4; i++)
+  {
+    addTriangle(base[(i + 1) % 4], base[i], apex, {1.0f, 0.0f, 0.0f, 0.0f, 0.5f, 1.0f});
+  }
+
+  // base, seen from below
+  addTriangle(base[0], base[1], base[2], {0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f});
+  addTriangle(base[2], base[3], base[0], {1.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f});
+
+  return vertices;
+}
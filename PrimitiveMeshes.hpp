@@ -0,0 +1,17 @@
+#pragma once
+
+#include <vector>
+
+// Meshes used by the examples and benchmarks, as triangle lists
+// (3 vertices per triangle, ready for glDrawArrays or weldVertices)
+// with 8 floats per vertex: position, normal, texture coordinates
+
+// Unit cube centered on the origin, the one of the lighting examples
+std::vector<float> makeCubeVertices();
+
+// Sphere of radius 0.5 centered on the origin, N_rings from pole to pole
+// and N_sectors around the Y axis
+std::vector<float> makeSphereVertices(int N_rings, int N_sectors);
+
+// Pyramid with a square base of side 1, apex at y = 0.5
+std::vector<float> makePyramidVertices();
@@ -0,0 +1,248 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+
+#include "Profiler.hpp"
+
+namespace {
+
+// queries generated at once when a frame needs more
+constexpr std::size_t query_batch_size{64};
+
+}
+
+ProfilerOptions ProfilerOptions::fromCommandLine(int argc, char* argv[])
+{
+  ProfilerOptions options{};
+
+  for (int i = 1; i + 1 < argc; i++)
+  {
+    if (std::strcmp(argv[i], "--profile") == 0)
+    {
+      options.trace_path = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--profile-frames") == 0)
+    {
+      options.n_frames = std::strtoul(argv[++i], nullptr, 10);
+    }
+  }
+
+  return options;
+}
+
+Profiler::Profiler(const ProfilerOptions& options) :
+  options_{options},
+  start_time_{std::chrono::steady_clock::now()}
+{
+  if (options_.trace_path.empty() || options_.n_frames == 0)
+  {
+    return;
+  }
+
+#if defined(LEARNOPENGL_PROFILE)
+  if (active_ != nullptr)
+  {
+    std::cout << "ERROR::PROFILER::ALREADY_ACTIVE" << std::endl;
+    return;
+  }
+
+  // GPU time and CPU time at the same moment, the GPU timestamps are
+  // moved on the CPU time line with the difference
+  GLint64 gpu_time{0};
+  glGetInteger64v(GL_TIMESTAMP, &gpu_time);
+  gpu_time_offset_ = now_() - gpu_time;
+
+  event_list_.reserve(options_.n_frames * 16);
+  is_recording_ = true;
+  active_ = this;
+#else
+  std::cout << "ERROR::PROFILER::NOT_COMPILED: build with -DLEARNOPENGL_PROFILE to profile" << std::endl;
+#endif
+}
+
+Profiler::~Profiler()
+{
+  if (active_ != this)
+  {
+    return;
+  }
+  active_ = nullptr;
+
+  // the last two frames: wait for their GPU times, the oldest first
+  for (std::size_t i = 0; i < frame_list_.size(); i++)
+  {
+    collect_(frame_list_[(frame_index_ + i) % frame_list_.size()], true);
+  }
+  for (auto& frame : frame_list_)
+  {
+    if (!frame.query_id_list.empty())
+    {
+      glDeleteQueries(static_cast<GLsizei>(frame.query_id_list.size()), frame.query_id_list.data());
+    }
+  }
+
+  if (writeTrace_())
+  {
+    std::cout << "Profile of " << std::min(frame_index_, options_.n_frames) << " frames written in " << options_.trace_path;
+    if (n_dropped_frames_ > 0)
+    {
+      std::cout << " (" << n_dropped_frames_ << " frames without GPU times: the GPU was too late)";
+    }
+    std::cout << std::endl;
+  }
+}
+
+bool Profiler::isRecording() const
+{
+  return is_recording_;
+}
+
+std::int64_t Profiler::now_() const
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time_).count();
+}
+
+GLuint Profiler::issueTimestamp_(FrameQueries_& frame)
+{
+  if (frame.n_used_queries == frame.query_id_list.size())
+  {
+    frame.query_id_list.resize(frame.query_id_list.size() + query_batch_size);
+    glGenQueries(query_batch_size, frame.query_id_list.data() + frame.n_used_queries);
+  }
+
+  // written by the GPU when it reaches this point of the commands
+  glQueryCounter(frame.query_id_list[frame.n_used_queries], GL_TIMESTAMP);
+  return static_cast<GLuint>(frame.n_used_queries++);
+}
+
+void Profiler::beginScope(const char* name)
+{
+  if (!is_recording_)
+  {
+    return;
+  }
+
+  auto& frame{frame_list_[frame_index_ % frame_list_.size()]};
+  open_scope_list_.push_back(static_cast<std::uint32_t>(frame.scope_list.size()));
+  const GLuint begin_query{issueTimestamp_(frame)};
+  frame.scope_list.push_back(Scope_{name, now_(), 0, begin_query, 0});
+}
+
+void Profiler::endScope()
+{
+  if (!is_recording_ || open_scope_list_.empty())
+  {
+    return;
+  }
+
+  auto& frame{frame_list_[frame_index_ % frame_list_.size()]};
+  auto& scope{frame.scope_list[open_scope_list_.back()]};
+  open_scope_list_.pop_back();
+  scope.cpu_end = now_();
+  scope.end_query = issueTimestamp_(frame);
+}
+
+void Profiler::endFrame()
+{
+  if (!is_recording_)
+  {
+    return;
+  }
+
+  const std::int64_t frame_end_time{now_()};
+  event_list_.push_back(TraceEvent_{"frame", 1, frame_index_, frame_begin_time_, frame_end_time - frame_begin_time_});
+  frame_begin_time_ = frame_end_time;
+  // a scope not closed in its frame is lost: it has no end to report
+  // (its begin query stays issued, it is only not read)
+  auto& frame{frame_list_[frame_index_ % frame_list_.size()]};
+  std::sort(open_scope_list_.begin(), open_scope_list_.end(), std::greater<std::uint32_t>{});
+  for (std::uint32_t scope_index : open_scope_list_)
+  {
+    frame.scope_list.erase(frame.scope_list.begin() + scope_index);
+  }
+  open_scope_list_.clear();
+
+  frame_index_++;
+  if (frame_index_ >= options_.n_frames)
+  {
+    is_recording_ = false;
+    return;
+  }
+
+  // The queries of the previous frame had a whole frame to complete:
+  // read them, and reuse them for the next one
+  auto& next_frame{frame_list_[frame_index_ % frame_list_.size()]};
+  collect_(next_frame, false);
+  next_frame.frame_index = frame_index_;
+}
+
+void Profiler::collect_(FrameQueries_& frame, bool wait)
+{
+  if (frame.scope_list.empty())
+  {
+    frame.n_used_queries = 0;
+    return;
+  }
+
+  // the queries complete in order: the last one tells for all the frame
+  GLint is_available{GL_TRUE};
+  if (!wait)
+  {
+    glGetQueryObjectiv(frame.query_id_list[frame.n_used_queries - 1], GL_QUERY_RESULT_AVAILABLE, &is_available);
+  }
+  if (is_available == GL_FALSE)
+  {
+    n_dropped_frames_++;
+  }
+
+  for (const auto& scope : frame.scope_list)
+  {
+    event_list_.push_back(TraceEvent_{scope.name, 1, frame.frame_index, scope.cpu_begin, scope.cpu_end - scope.cpu_begin});
+    if (is_available == GL_TRUE)
+    {
+      GLuint64 gpu_begin{0};
+      GLuint64 gpu_end{0};
+      glGetQueryObjectui64v(frame.query_id_list[scope.begin_query], GL_QUERY_RESULT, &gpu_begin);
+      glGetQueryObjectui64v(frame.query_id_list[scope.end_query], GL_QUERY_RESULT, &gpu_end);
+      event_list_.push_back(TraceEvent_{
+        scope.name, 2, frame.frame_index,
+        static_cast<std::int64_t>(gpu_begin) + gpu_time_offset_,
+        static_cast<std::int64_t>(gpu_end - gpu_begin)
+      });
+    }
+  }
+
+  frame.scope_list.clear();
+  frame.n_used_queries = 0;
+}
+
+bool Profiler::writeTrace_() const
+{
+  std::ofstream file{options_.trace_path};
+  if (!file)
+  {
+    std::cout << "ERROR::PROFILER::FILE_NOT_WRITTEN " << options_.trace_path << std::endl;
+    return false;
+  }
+
+  // Trace Event Format: complete events ("X") with a beginning and a
+  // duration in microseconds, one thread per track
+  file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+  file << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 1, \"args\": {\"name\": \"CPU (render thread)\"}},\n";
+  file << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 2, \"args\": {\"name\": \"GPU\"}}";
+  file.precision(3);
+  file << std::fixed;
+  for (const auto& event : event_list_)
+  {
+    file << ",\n{\"name\": \"" << event.name << "\", \"cat\": \"" << (event.track == 1 ? "cpu" : "gpu")
+      << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << event.track
+      << ", \"ts\": " << event.begin / 1000.0 << ", \"dur\": " << event.duration / 1000.0
+      << ", \"args\": {\"frame\": " << event.frame_index << "}}";
+  }
+  file << "\n]}\n";
+
+  return static_cast<bool>(file);
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "glad/glad.h"
+
+// What is profiled, and where the trace is written
+struct ProfilerOptions final {
+  // Chrome trace file (chrome://tracing, ui.perfetto.dev), empty: no profiling
+  std::string trace_path{};
+  // the first n_frames frames are recorded
+  std::size_t n_frames{300};
+
+  // --profile trace.json [--profile-frames N]
+  static ProfilerOptions fromCommandLine(int argc, char* argv[]);
+};
+
+/**
+ * CPU and GPU time of the passes of the frames (see ProfileScope)
+ *
+ * Each scope takes two CPU timestamps, and two GL_TIMESTAMP queries which
+ * the GPU writes when it reaches them in the command stream. The queries of
+ * a frame are read at the end of the next one: the queries are double
+ * buffered, and the results of a frame still not available then are dropped
+ * rather than waited for, so the profiler never stalls the render loop
+ *
+ * Profiler profiler{ProfilerOptions::fromCommandLine(argc, argv)};
+ * while (...) {
+ *   {
+ *     PROFILE_SCOPE("cubes");
+ *     ...
+ *   }
+ *   PROFILE_END_FRAME();
+ *   context.endFrame();
+ * }
+ *
+ * The trace is written when the profiler is destroyed, with a track for the
+ * CPU (render thread) and one for the GPU. Only the render thread can open
+ * scopes, their names must outlive the profiler (string literals)
+ *
+ * The scopes are compiled only with LEARNOPENGL_PROFILE defined: otherwise
+ * PROFILE_SCOPE and PROFILE_END_FRAME are nothing at all
+ */
+class Profiler final {
+private:
+  struct Scope_ {
+    const char* name;
+    // nanoseconds since the creation of the profiler
+    std::int64_t cpu_begin;
+    std::int64_t cpu_end;
+    // queries of the beginning and the end in the frame query list
+    std::uint32_t begin_query;
+    std::uint32_t end_query;
+  };
+  // Queries and scopes of a frame, until its GPU times are read
+  struct FrameQueries_ {
+    std::size_t frame_index{0};
+    std::vector<GLuint> query_id_list;
+    std::size_t n_used_queries{0};
+    std::vector<Scope_> scope_list;
+  };
+  struct TraceEvent_ {
+    const char* name;
+    // 1: CPU, 2: GPU
+    int track;
+    std::size_t frame_index;
+    std::int64_t begin;
+    std::int64_t duration;
+  };
+  // scopes are recorded by the active profiler, if any
+  inline static Profiler* active_{nullptr};
+
+  ProfilerOptions options_;
+  std::array<FrameQueries_, 2> frame_list_;
+  std::size_t frame_index_{0};
+  // scopes of the current frame not ended yet
+  std::vector<std::uint32_t> open_scope_list_;
+  std::vector<TraceEvent_> event_list_;
+  std::chrono::steady_clock::time_point start_time_;
+  std::int64_t frame_begin_time_{0};
+  // CPU time - GPU time, to show both on the same time line
+  std::int64_t gpu_time_offset_{0};
+  std::size_t n_dropped_frames_{0};
+  bool is_recording_{false};
+
+  std::int64_t now_() const;
+  GLuint issueTimestamp_(FrameQueries_& frame);
+  // Move the scopes of a frame to the trace, and its GPU times if
+  // they are available (or always with wait)
+  void collect_(FrameQueries_& frame, bool wait);
+  bool writeTrace_() const;
+public:
+  explicit Profiler(const ProfilerOptions& options);
+  ~Profiler();
+  Profiler(const Profiler&) = delete;
+  Profiler& operator=(const Profiler&) = delete;
+
+  // nullptr when nothing is profiled
+  static Profiler* getActive()
+  {
+    return active_;
+  }
+
+  bool isRecording() const;
+  void beginScope(const char* name);
+  void endScope();
+  // After the last scope of the frame
+  void endFrame();
+};
+
+// Profile the enclosing block (see Profiler)
+class ProfileScope final {
+private:
+  Profiler* profiler_;
+public:
+  explicit ProfileScope(const char* name) :
+    profiler_{Profiler::getActive()}
+  {
+    if (profiler_ != nullptr)
+    {
+      profiler_->beginScope(name);
+    }
+  }
+  ~ProfileScope()
+  {
+    if (profiler_ != nullptr)
+    {
+      profiler_->endScope();
+    }
+  }
+  ProfileScope(const ProfileScope&) = delete;
+  ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+#if defined(LEARNOPENGL_PROFILE)
+#define PROFILE_CONCATENATE_(a, b) a##b
+#define PROFILE_SCOPE_NAME_(line) PROFILE_CONCATENATE_(profile_scope_, line)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_SCOPE_NAME_(__LINE__){name}
+#define PROFILE_END_FRAME() \
+  do { if (Profiler* active_profiler = Profiler::getActive()) active_profiler->endFrame(); } while (false)
+#else
+#define PROFILE_SCOPE(name) do {} while (false)
+#define PROFILE_END_FRAME() do {} while (false)
+#endif
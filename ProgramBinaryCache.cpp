@@ -0,0 +1,158 @@
+#include <cstdio>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <vector>
+
+#include "GLExtensions.hpp"
+#include "UniformHash.hpp"
+
+#include "ProgramBinaryCache.hpp"
+
+namespace {
+
+// written before the binary, to check the file is one of ours
+struct ProgramBinaryHeader {
+  std::uint32_t magic;
+  std::uint32_t version;
+  std::uint64_t key;
+  std::uint32_t binary_format;
+  std::uint32_t binary_length;
+};
+
+constexpr std::uint32_t program_binary_magic{0x4250474c}; // "LGPB"
+constexpr std::uint32_t program_binary_version{1};
+
+}
+
+ProgramBinaryCache::ProgramBinaryCache(const std::string& directory) :
+  directory_{directory}
+{
+  // the binary is only valid for the driver which produced it
+  for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION})
+  {
+    auto value{reinterpret_cast<const char*>(glGetString(name))};
+    driver_id_ += value != nullptr ? value : "";
+    driver_id_ += '\n';
+  }
+
+  std::error_code error;
+  std::filesystem::create_directories(directory_, error);
+}
+
+bool ProgramBinaryCache::isSupported() const
+{
+  if (GLAD_GL_ARB_get_program_binary == 0)
+  {
+    return false;
+  }
+
+  // the driver may support the API without any format to save
+  GLint n_formats{0};
+  glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &n_formats);
+
+  return n_formats > 0;
+}
+
+std::uint64_t ProgramBinaryCache::computeKey(const std::string& vertex_source, const std::string& fragment_source) const
+{
+  // separators, so moving code from one shader to the other changes the key
+  std::uint64_t key{hashBytes(driver_id_)};
+  key = hashBytes(std::string_view{"\0", 1}, key);
+  key = hashBytes(vertex_source, key);
+  key = hashBytes(std::string_view{"\0", 1}, key);
+  key = hashBytes(fragment_source, key);
+
+  return key;
+}
+
+std::string ProgramBinaryCache::getFilePath_(std::uint64_t key) const
+{
+  char file_name[32];
+  std::snprintf(file_name, sizeof(file_name), "%016llx.bin", static_cast<unsigned long long>(key));
+
+  return directory_ + "/" + file_name;
+}
+
+bool ProgramBinaryCache::load(GLuint program_id, std::uint64_t key)
+{
+  std::ifstream file_stream{getFilePath_(key), std::ios::binary};
+
+  ProgramBinaryHeader header{};
+
+  if (!file_stream.read(reinterpret_cast<char*>(&header), sizeof(header))
+    || header.magic != program_binary_magic
+    || header.version != program_binary_version
+    || header.key != key)
+  {
+    misses++;
+    return false;
+  }
+
+  std::vector<char> binary(header.binary_length);
+
+  if (!file_stream.read(binary.data(), binary.size()))
+  {
+    misses++;
+    return false;
+  }
+
+  glProgramBinary(program_id, header.binary_format, binary.data(), header.binary_length);
+
+  // the driver can refuse the binary (e.g. after an update), it is
+  // reported as a linking failure
+  GLint success{0};
+  glGetProgramiv(program_id, GL_LINK_STATUS, &success);
+
+  if (success == false)
+  {
+    misses++;
+    return false;
+  }
+
+  hits++;
+  return true;
+}
+
+void ProgramBinaryCache::store(GLuint program_id, std::uint64_t key) const
+{
+  GLint binary_length{0};
+  glGetProgramiv(program_id, GL_PROGRAM_BINARY_LENGTH, &binary_length);
+
+  if (binary_length <= 0)
+  {
+    return;
+  }
+
+  std::vector<char> binary(binary_length);
+  GLenum binary_format{0};
+  glGetProgramBinary(program_id, binary_length, &binary_length, &binary_format, binary.data());
+
+  ProgramBinaryHeader header{
+    program_binary_magic,
+    program_binary_version,
+    key,
+    binary_format,
+    static_cast<std::uint32_t>(binary_length)
+  };
+
+  // write in a temporary file, so an interrupted write never leaves
+  // a truncated binary behind
+  const std::string file_path{getFilePath_(key)};
+  const std::string temp_file_path{file_path + ".tmp"};
+
+  {
+    std::ofstream file_stream{temp_file_path, std::ios::binary | std::ios::trunc};
+    file_stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file_stream.write(binary.data(), binary_length);
+
+    if (!file_stream)
+    {
+      std::cout << "ERROR::SHADER::PROGRAM::BINARY_NOT_SUCCESFULLY_WRITTEN" << std::endl;
+      return;
+    }
+  }
+
+  std::error_code error;
+  std::filesystem::rename(temp_file_path, file_path, error);
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "glad/glad.h"
+
+// On disk cache of linked programs (glGetProgramBinary)
+// A program is stored in a file named after a key, which is the hash of
+// its sources and of the driver (vendor, renderer, version): a driver
+// update gives other keys, and a binary refused by the driver
+// is compiled again from the sources
+// Needs GL_ARB_get_program_binary (see GLExtensions), otherwise it is a no-op
+class ProgramBinaryCache final {
+private:
+  std::string directory_;
+  std::string driver_id_;
+  std::string getFilePath_(std::uint64_t key) const;
+public:
+  explicit ProgramBinaryCache(const std::string& directory);
+  std::size_t hits{0};
+  std::size_t misses{0};
+  bool isSupported() const;
+  std::uint64_t computeKey(const std::string& vertex_source, const std::string& fragment_source) const;
+  // Load the binary into the program, true if it is linked and ready to use
+  bool load(GLuint program_id, std::uint64_t key);
+  // Write the binary of a linked program
+  void store(GLuint program_id, std::uint64_t key) const;
+};
@@ -6,7 +6,10 @@
 #include "glad/glad.h"
 //#include "GLFW/glfw3.h"
 
+#include "GLExtensions.hpp"
+#include "ProgramBinaryCache.hpp"
 #include "ShaderProgram.hpp"
+#include "UniformHash.hpp"
 
 void ShaderProgram::checkCompilationStatus_(int vertex_shader_id)
 {
@@ -71,17 +74,13 @@ GLuint ShaderProgram::compile_(const std::string& shader_source, GLenum gl_shade
   return shader_id;
 }
 
-ShaderProgram::ShaderProgram(const char* vertex_path, const char* fragment_path)
+ShaderProgram::ShaderProgram(const char* vertex_path, const char* fragment_path, Build build)
 {
   // "Modern" OpenGL wants us to define 2 shaders: vertex and fragments
   // vertex shader is the first one in the pipeline
   std::string temp_vertex_source;
   readFromFile_(vertex_path, temp_vertex_source);
 
-  vertex_shader_id_ = compile_(temp_vertex_source, GL_VERTEX_SHADER);
-
-  checkCompilationStatus_(vertex_shader_id_);
-
   // Fragment shader handling
   // fragment shader handles the color output of the pixels
   // color in GLSL is in RGBA (Alpha: opacity)
@@ -90,71 +89,240 @@ ShaderProgram::ShaderProgram(const char* vertex_path, const char* fragment_path)
   std::string temp_fragment_source;
   readFromFile_(fragment_path, temp_fragment_source);
 
-  fragment_shader_id_ = compile_(temp_fragment_source, GL_FRAGMENT_SHADER);
+  id = glCreateProgram();
 
-  checkCompilationStatus_(fragment_shader_id_);
+  // Try first the program linked by a previous run
+  if (binary_cache_ != nullptr && binary_cache_->isSupported())
+  {
+    binary_key_ = binary_cache_->computeKey(temp_vertex_source, temp_fragment_source);
 
+    if (binary_cache_->load(id, binary_key_) == true)
+    {
+      cacheUniformLocations_();
+      return;
+    }
+
+    // start again from a clean program object, the refused binary
+    // may have left it in any state
+    glDeleteProgram(id);
+    id = glCreateProgram();
+    // tell the driver we will retrieve the binary after linking
+    glProgramParameteri(id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    pending_binary_cache_ = binary_cache_;
+  }
+
+  // Compile and link, without asking for any status: a status query
+  // waits for the driver to finish
+  vertex_shader_id_ = compile_(temp_vertex_source, GL_VERTEX_SHADER);
+  fragment_shader_id_ = compile_(temp_fragment_source, GL_FRAGMENT_SHADER);
 
   // Create the shader programm by linking the two shaders
-  id = glCreateProgram();
   glAttachShader(id, vertex_shader_id_);
   glAttachShader(id, fragment_shader_id_);
   glLinkProgram(id);
 
+  build_pending_ = true;
+
+  if (build == Build::Blocking)
+  {
+    finishBuild_();
+  }
+}
+
+void ShaderProgram::finishBuild_()
+{
+  build_pending_ = false;
+
+  checkCompilationStatus_(vertex_shader_id_);
+  checkCompilationStatus_(fragment_shader_id_);
   checkLinkingStatus_(id);
 
+  // Introspect the linked program once, instead of calling
+  // glGetUniformLocation (a string lookup in the driver) on every set
+  cacheUniformLocations_();
+
   // Clean the shader objects, they are not in use anymore
   glDeleteShader(vertex_shader_id_);
   glDeleteShader(fragment_shader_id_);
+
+  if (pending_binary_cache_ != nullptr)
+  {
+    GLint success{0};
+    glGetProgramiv(id, GL_LINK_STATUS, &success);
+
+    if (success == true)
+    {
+      pending_binary_cache_->store(id, binary_key_);
+    }
+
+    pending_binary_cache_ = nullptr;
+  }
+}
+
+bool ShaderProgram::isBuildComplete() const
+{
+  if (build_pending_ == false || GLAD_GL_KHR_parallel_shader_compile == 0)
+  {
+    return true;
+  }
+
+  GLint completed{GL_FALSE};
+  glGetProgramiv(id, GL_COMPLETION_STATUS_KHR, &completed);
+
+  return completed == GL_TRUE;
+}
+
+void ShaderProgram::setBinaryCache(ProgramBinaryCache* binary_cache)
+{
+  binary_cache_ = binary_cache;
+}
+
+ShaderStateStats ShaderProgram::takeFrameStats()
+{
+  ShaderStateStats stats{frame_stats};
+  frame_stats = ShaderStateStats{};
+
+  return stats;
+}
+
+void ShaderProgram::invalidateBoundProgram()
+{
+  bound_program_id_ = 0;
 }
 
 void ShaderProgram::use()
 {
+  ensureBuilt_();
+
+  // glUseProgram is not free even if the program is already in use
+  if (bound_program_id_ == id)
+  {
+    frame_stats.use_elided++;
+    return;
+  }
+
   // Activate this programm for each render and shader call
   glUseProgram(id);
+  bound_program_id_ = id;
+  frame_stats.use_calls++;
+}
+
+void ShaderProgram::bindUniformBlock(const char* block_name, GLuint binding_point)
+{
+  ensureBuilt_();
+
+  GLuint block_index{glGetUniformBlockIndex(id, block_name)};
+
+  if (block_index == GL_INVALID_INDEX)
+  {
+    std::cout << "ERROR::SHADER::PROGRAM::UNIFORM_BLOCK_NOT_FOUND\n" << block_name << std::endl;
+    return;
+  }
+
+  glUniformBlockBinding(id, block_index, binding_point);
+}
+
+void ShaderProgram::cacheUniformLocation_(const std::string& uniform_name)
+{
+  GLint location{glGetUniformLocation(id, uniform_name.c_str())};
+
+  // members of uniform blocks are active but have no location
+  if (location == -1)
+  {
+    return;
+  }
+
+  const int slot{static_cast<int>(uniform_slot_list_.size())};
+  auto [it, inserted] = uniform_slot_map_.emplace(hashUniformName(uniform_name), slot);
+
+  if (inserted == true)
+  {
+    uniform_slot_list_.push_back(UniformSlot_{location});
+  } else if (uniform_slot_list_[it->second].location != location)
+  {
+    std::cout << "ERROR::SHADER::PROGRAM::UNIFORM_HASH_COLLISION\n" << uniform_name << std::endl;
+  }
 }
 
-GLint ShaderProgram::getUniformLocation_(const std::string& uniform_name) {
-  return glGetUniformLocation(id, uniform_name.c_str());
+void ShaderProgram::cacheUniformLocations_()
+{
+  GLint n_uniforms{0};
+  GLint max_name_length{0};
+  glGetProgramiv(id, GL_ACTIVE_UNIFORMS, &n_uniforms);
+  glGetProgramiv(id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_name_length);
+
+  std::string name_buffer(max_name_length, '\0');
+
+  for (GLint i = 0; i < n_uniforms; i++)
+  {
+    GLsizei name_length{0};
+    GLint array_size{0};
+    GLenum type{0};
+    glGetActiveUniform(id, i, max_name_length, &name_length, &array_size, &type, name_buffer.data());
+
+    std::string uniform_name{name_buffer.data(), static_cast<std::size_t>(name_length)};
+
+    // arrays are reported as "name[0]", but they can be set with
+    // "name" or with each "name[i]", so register all of them
+    const auto array_suffix_pos{uniform_name.rfind("[0]")};
+
+    if (array_suffix_pos != std::string::npos && array_suffix_pos + 3 == uniform_name.size())
+    {
+      const std::string array_name{uniform_name.substr(0, array_suffix_pos)};
+      cacheUniformLocation_(array_name);
+
+      for (GLint j = 0; j < array_size; j++)
+      {
+        cacheUniformLocation_(array_name + "[" + std::to_string(j) + "]");
+      }
+    } else
+    {
+      cacheUniformLocation_(uniform_name);
+    }
+  }
+}
+
+int ShaderProgram::getUniformSlot_(UniformName uniform_name) const {
+  auto it{uniform_slot_map_.find(uniform_name.hash)};
+
+  // unknown (or optimized out) uniform
+  if (it == uniform_slot_map_.end())
+  {
+    return -1;
+  }
+
+  return it->second;
 }
 
-void ShaderProgram::setBool(const std::string& uniform_name, bool uniform_value)
+void ShaderProgram::setBool(UniformName uniform_name, bool uniform_value)
 {
-  glUniform1i(getUniformLocation_(uniform_name), static_cast<int>(uniform_value));
+  ensureBuilt_();
+  setUniform_(getUniformSlot_(uniform_name), uniform_value);
 }
 
-void ShaderProgram::setInt(const std::string& uniform_name, int uniform_value)
+void ShaderProgram::setInt(UniformName uniform_name, int uniform_value)
 { 
-    glUniform1i(getUniformLocation_(uniform_name), uniform_value);
+    ensureBuilt_();
+    setUniform_(getUniformSlot_(uniform_name), uniform_value);
 }
 
-void ShaderProgram::setFloat(const std::string &uniform_name, float uniform_value)
+void ShaderProgram::setFloat(UniformName uniform_name, float uniform_value)
 { 
-    glUniform1f(getUniformLocation_(uniform_name), uniform_value);
+    ensureBuilt_();
+    setUniform_(getUniformSlot_(uniform_name), uniform_value);
 }
 
-void ShaderProgram::setMat3(const std::string& uniform_name, const glm::mat3& mat) {
-  glUniformMatrix3fv(
-    getUniformLocation_(uniform_name),
-    1,
-    GL_FALSE,
-    glm::value_ptr(mat)
-  );
+void ShaderProgram::setMat3(UniformName uniform_name, const glm::mat3& mat) {
+  ensureBuilt_();
+  setUniform_(getUniformSlot_(uniform_name), mat);
 }
 
-void ShaderProgram::setMat4(const std::string& uniform_name, const glm::mat4& mat) {
-  glUniformMatrix4fv(
-    getUniformLocation_(uniform_name),
-    1,
-    GL_FALSE,
-    glm::value_ptr(mat)
-  );
+void ShaderProgram::setMat4(UniformName uniform_name, const glm::mat4& mat) {
+  ensureBuilt_();
+  setUniform_(getUniformSlot_(uniform_name), mat);
 }
 
-void ShaderProgram::setVec3(const std::string &uniform_name, const glm::vec3& vec) {
-  glUniform3fv(
-    getUniformLocation_(uniform_name),
-    1,
-    &vec[0]
-  );
+void ShaderProgram::setVec3(UniformName uniform_name, const glm::vec3& vec) {
+  ensureBuilt_();
+  setUniform_(getUniformSlot_(uniform_name), vec);
 }
\ No newline at end of file
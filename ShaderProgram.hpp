@@ -1,28 +1,148 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "glad/glad.h"
 #include "glm/glm.hpp"
 #include "glm/gtc/type_ptr.hpp"
 
+#include "UniformRef.hpp"
+
+class ProgramBinaryCache;
+
+// Number of GL calls issued and skipped by the ShaderProgram
+// shadow state (see ShaderProgram::use and the uniform setters)
+struct ShaderStateStats {
+  std::size_t use_calls{0};
+  std::size_t use_elided{0};
+  std::size_t uniform_calls{0};
+  std::size_t uniform_elided{0};
+};
+
 class ShaderProgram {
 private:
-  GLuint vertex_shader_id_;
-  GLuint fragment_shader_id_;
+  // location and last value written of an active uniform
+  // value is compared bytewise, so it is large enough for the biggest type (mat4)
+  struct UniformSlot_ {
+    GLint location;
+    std::size_t value_size{0};
+    std::array<unsigned char, sizeof(glm::mat4)> value{};
+  };
+  GLuint vertex_shader_id_{0};
+  GLuint fragment_shader_id_{0};
+  // compile and link submitted, but status not checked yet (see Build::Deferred)
+  bool build_pending_{false};
+  // cache where to write the binary once the build is finished, if any
+  ProgramBinaryCache* pending_binary_cache_{nullptr};
+  std::uint64_t binary_key_{0};
+  // uniform slots, filled once after linking and keyed by the
+  // hash of the uniform name, so the setters never ask the driver
+  std::unordered_map<std::uint64_t, int> uniform_slot_map_;
+  std::vector<UniformSlot_> uniform_slot_list_;
+  // program currently in use, shared by all the programs of the (single) context
+  inline static GLuint bound_program_id_{0};
+  // optional on disk cache of the linked programs
+  inline static ProgramBinaryCache* binary_cache_{nullptr};
   void readFromFile_(const char* file_path, std::string& dest_string);
   void checkCompilationStatus_(int shader_id);
   void checkLinkingStatus_(int shader_program_id);
   GLuint compile_(const std::string& shader_source, GLenum gl_shader_type);
-  GLint getUniformLocation_(const std::string& uniform_name);
+  void cacheUniformLocations_();
+  void cacheUniformLocation_(const std::string& uniform_name);
+  int getUniformSlot_(UniformName uniform_name) const;
+  // Check the compilation and linking, then introspect the program
+  void finishBuild_();
+  void ensureBuilt_()
+  {
+    if (build_pending_ == true)
+    {
+      finishBuild_();
+    }
+  }
+  // Upload the value only if it differs from the last one written in the slot
+  template <typename T>
+  void setUniform_(int slot, const T& uniform_value)
+  {
+    static_assert(sizeof(T) <= sizeof(glm::mat4), "uniform type too large for the shadow state");
+
+    // unknown or optimized out uniform, GL would ignore it anyway
+    if (slot < 0 || static_cast<std::size_t>(slot) >= uniform_slot_list_.size())
+    {
+      return;
+    }
+
+    auto& uniform_slot{uniform_slot_list_[slot]};
+
+    if (uniform_slot.value_size == sizeof(T) && std::memcmp(uniform_slot.value.data(), &uniform_value, sizeof(T)) == 0)
+    {
+      frame_stats.uniform_elided++;
+      return;
+    }
+
+    std::memcpy(uniform_slot.value.data(), &uniform_value, sizeof(T));
+    uniform_slot.value_size = sizeof(T);
+    frame_stats.uniform_calls++;
+    uploadUniform(uniform_slot.location, uniform_value);
+  }
 public:
-  ShaderProgram(const char* vertex_path, const char* fragment_path);
+  enum class Build {
+    // compile and link in the constructor, and wait for the result
+    Blocking,
+    // only submit the compile and link commands, the result is checked
+    // at first use: the driver can build several programs in parallel
+    // (GL_KHR_parallel_shader_compile) while we do something else
+    Deferred
+  };
+  ShaderProgram(const char* vertex_path, const char* fragment_path, Build build = Build::Blocking);
   GLuint id;
+  // counters of the current frame, for all the programs
+  inline static ShaderStateStats frame_stats{};
+  // Return the counters of the frame and reset them for the next one
+  static ShaderStateStats takeFrameStats();
+  // To call if glUseProgram is called outside of this class
+  static void invalidateBoundProgram();
+  // Load the programs created after this call from the cache when possible
+  // (and store them otherwise), nullptr to disable it
+  static void setBinaryCache(ProgramBinaryCache* binary_cache);
+  // False while the driver is still building a deferred program, so it can be
+  // polled without blocking. Without GL_KHR_parallel_shader_compile
+  // we can not know, so it is true and the first use will wait
+  bool isBuildComplete() const;
   void use();
-  void setBool(const std::string& uniform_name, bool uniform_value);
-  void setInt(const std::string& uniform_name, int uniform_value);
-  void setFloat(const std::string& uniform_name, float uniform_value);
-  void setMat4(const std::string& uniform_name, const glm::mat4& mat);
-  void setMat3(const std::string& uniform_name, const glm::mat3& mat);
-  void setVec3(const std::string& uniform_name, const glm::vec3& vec);
-};
\ No newline at end of file
+  // Link a uniform block of the program to a uniform buffer binding point
+  void bindUniformBlock(const char* block_name, GLuint binding_point);
+  void setBool(UniformName uniform_name, bool uniform_value);
+  void setInt(UniformName uniform_name, int uniform_value);
+  void setFloat(UniformName uniform_name, float uniform_value);
+  void setMat4(UniformName uniform_name, const glm::mat4& mat);
+  void setMat3(UniformName uniform_name, const glm::mat3& mat);
+  void setVec3(UniformName uniform_name, const glm::vec3& vec);
+  // Resolve a uniform once, outside of the render loop
+  template <typename T>
+  UniformRef<T> getUniform(UniformName uniform_name)
+  {
+    ensureBuilt_();
+
+    return UniformRef<T>{getUniformSlot_(uniform_name), id};
+  }
+  // Set a resolved uniform, the program has to be in use
+  template <typename T>
+  void set(UniformRef<T> uniform, const typename UniformRef<T>::value_type& uniform_value)
+  {
+    // its slot would be the one of another uniform here, if any
+    if (uniform.isValid() && uniform.programId() != id)
+    {
+      std::cout << "ERROR::SHADER::PROGRAM::UNIFORM_OF_ANOTHER_PROGRAM" << std::endl;
+      return;
+    }
+
+    setUniform_(uniform.slot(), uniform_value);
+  }
+};
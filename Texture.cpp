@@ -4,17 +4,8 @@
 
 #include "Texture.hpp"
 
-Texture::Texture(const char* image_source, GLuint image_format)
+Texture::Texture()
 {
-  // OpenGL y axis starts on the bottom and most images start on the top
-  // this tells stbi to flip y-axis for us
-  stbi_set_flip_vertically_on_load(true);
-  // Load texture image
-  int width{0};
-  int height{0};
-  int nrChannels{0};
-  unsigned char *data = stbi_load(image_source, &width, &height, &nrChannels, 0);
-
   // This will create an array of 1 Gluint elements
   glGenTextures(1, &id);
   bind();
@@ -33,6 +24,23 @@ Texture::Texture(const char* image_source, GLuint image_format)
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
   // Magnification filter does not use mipmaps, which are used only for downscaling
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+  unbind();
+}
+
+Texture::Texture(const char* image_source, GLuint image_format) : Texture()
+{
+  // OpenGL y axis starts on the bottom and most images start on the top
+  // this tells stbi to flip y-axis for us
+  stbi_set_flip_vertically_on_load(true);
+  // Load texture image
+  int width{0};
+  int height{0};
+  int nrChannels{0};
+  unsigned char *data = stbi_load(image_source, &width, &height, &nrChannels, 0);
+
+  bind();
+
   if (data != nullptr)
   {
     // Generate the texture with the loaded image data
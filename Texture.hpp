@@ -3,6 +3,8 @@
 #include "glad/glad.h"
 
 struct Texture final {
+  // Create a texture without any image yet (see TextureLoader)
+  Texture();
   Texture(const char* image_source, GLuint image_format);
   GLuint id{0};
   void bind();
@@ -0,0 +1,273 @@
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+
+#include "stb_image.h"
+
+#include "TextureArrayPacker.hpp"
+
+void TextureArray::bind()
+{
+  glBindTexture(GL_TEXTURE_2D_ARRAY, id);
+}
+
+void TextureArray::unbind()
+{
+  glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+TextureArrayPacker::TextureArrayPacker(int layer_width, int layer_height, int padding) :
+  layer_width_{layer_width},
+  layer_height_{layer_height},
+  padding_{padding}
+{
+}
+
+std::size_t TextureArrayPacker::add(const char* image_source)
+{
+  // OpenGL y axis starts on the bottom and most images start on the top
+  stbi_set_flip_vertically_on_load(true);
+
+  int width{0};
+  int height{0};
+  int file_channels{0};
+  unsigned char *data = stbi_load(image_source, &width, &height, &file_channels, 4);
+
+  if (data == nullptr)
+  {
+    std::cout << "Failed to load texture" << std::endl;
+    // keep an (empty) image so the indexes stay valid
+    image_list_.push_back(Image_{0, 0, {}});
+    return image_list_.size() - 1;
+  }
+
+  std::size_t image_index{add(data, width, height)};
+  stbi_image_free(data);
+
+  return image_index;
+}
+
+std::size_t TextureArrayPacker::add(const unsigned char* rgba_data, int width, int height)
+{
+  image_list_.push_back(Image_{width, height, std::vector<unsigned char>(rgba_data, rgba_data + width * height * 4)});
+
+  return image_list_.size() - 1;
+}
+
+int TextureArrayPacker::findPosition_(const std::vector<SkylineNode_>& skyline, int width, int height, int& x, int& y) const
+{
+  int best_index{-1};
+  int best_y{layer_height_};
+  int best_width{layer_width_ + 1};
+
+  for (std::size_t i = 0; i < skyline.size(); i++)
+  {
+    const int node_x{skyline[i].x};
+
+    if (node_x + width > layer_width_)
+    {
+      break;
+    }
+
+    // the rectangle lies on the highest node it spans
+    int top{0};
+    int remaining_width{width};
+
+    for (std::size_t j = i; remaining_width > 0; j++)
+    {
+      top = std::max(top, skyline[j].y);
+      remaining_width -= skyline[j].width;
+    }
+
+    if (top + height > layer_height_)
+    {
+      continue;
+    }
+
+    // bottom-left: lowest first, then the best fitting node
+    if (top < best_y || (top == best_y && skyline[i].width < best_width))
+    {
+      best_index = static_cast<int>(i);
+      best_y = top;
+      best_width = skyline[i].width;
+      x = node_x;
+      y = top;
+    }
+  }
+
+  return best_index;
+}
+
+void TextureArrayPacker::insertNode_(std::vector<SkylineNode_>& skyline, int node_index, int x, int y, int width, int height) const
+{
+  skyline.insert(skyline.begin() + node_index, SkylineNode_{x, y + height, width});
+
+  // the nodes below the new one are shrunk or removed
+  for (std::size_t i = node_index + 1; i < skyline.size();)
+  {
+    const int previous_end{skyline[i - 1].x + skyline[i - 1].width};
+
+    if (skyline[i].x >= previous_end)
+    {
+      break;
+    }
+
+    const int shrink{previous_end - skyline[i].x};
+    skyline[i].x += shrink;
+    skyline[i].width -= shrink;
+
+    if (skyline[i].width > 0)
+    {
+      break;
+    }
+
+    skyline.erase(skyline.begin() + i);
+  }
+
+  // merge the neighbours at the same height
+  for (std::size_t i = 0; i + 1 < skyline.size();)
+  {
+    if (skyline[i].y == skyline[i + 1].y)
+    {
+      skyline[i].width += skyline[i + 1].width;
+      skyline.erase(skyline.begin() + i + 1);
+    } else
+    {
+      i++;
+    }
+  }
+}
+
+TextureArray TextureArrayPacker::build()
+{
+  region_list_.assign(image_list_.size(), TextureRegion{});
+
+  // the tallest images first give a flatter skyline
+  std::vector<std::size_t> order(image_list_.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [this](std::size_t a, std::size_t b) {
+    return image_list_[a].height > image_list_[b].height;
+  });
+
+  std::vector<std::vector<SkylineNode_>> skyline_list;
+  // place of each image in its layer, with its padding
+  std::vector<glm::ivec3> position_list(image_list_.size(), glm::ivec3(-1));
+
+  for (std::size_t image_index : order)
+  {
+    const auto& image{image_list_[image_index]};
+    const int padded_width{image.width + 2 * padding_};
+    const int padded_height{image.height + 2 * padding_};
+
+    if (image.width == 0 || padded_width > layer_width_ || padded_height > layer_height_)
+    {
+      std::cout << "ERROR::TEXTURE_ARRAY::IMAGE_DOES_NOT_FIT " << image.width << "x" << image.height << std::endl;
+      continue;
+    }
+
+    // first layer with room for it
+    std::size_t layer{0};
+    int x{0};
+    int y{0};
+
+    for (; layer < skyline_list.size(); layer++)
+    {
+      int node_index{findPosition_(skyline_list[layer], padded_width, padded_height, x, y)};
+
+      if (node_index != -1)
+      {
+        insertNode_(skyline_list[layer], node_index, x, y, padded_width, padded_height);
+        break;
+      }
+    }
+
+    if (layer == skyline_list.size())
+    {
+      skyline_list.push_back({SkylineNode_{0, 0, layer_width_}});
+      x = 0;
+      y = 0;
+      insertNode_(skyline_list.back(), 0, x, y, padded_width, padded_height);
+    }
+
+    position_list[image_index] = glm::ivec3(x, y, layer);
+
+    auto& region{region_list_[image_index]};
+    region.layer = static_cast<int>(layer);
+    region.uv_offset = glm::vec2(
+      static_cast<float>(x + padding_) / layer_width_,
+      static_cast<float>(y + padding_) / layer_height_
+    );
+    region.uv_scale = glm::vec2(
+      static_cast<float>(image.width) / layer_width_,
+      static_cast<float>(image.height) / layer_height_
+    );
+  }
+
+  // compose the layers on the CPU, then a single upload
+  const std::size_t layer_size{static_cast<std::size_t>(layer_width_) * layer_height_ * 4};
+  std::vector<unsigned char> layer_data(std::max<std::size_t>(1, skyline_list.size()) * layer_size, 0);
+
+  for (std::size_t image_index = 0; image_index < image_list_.size(); image_index++)
+  {
+    const auto& image{image_list_[image_index]};
+    const glm::ivec3 position{position_list[image_index]};
+
+    if (position.z == -1)
+    {
+      continue;
+    }
+
+    unsigned char* layer{layer_data.data() + position.z * layer_size};
+
+    // the padding repeats the edge pixels of the image
+    for (int py = 0; py < image.height + 2 * padding_; py++)
+    {
+      const int image_y{std::clamp(py - padding_, 0, image.height - 1)};
+
+      for (int px = 0; px < image.width + 2 * padding_; px++)
+      {
+        const int image_x{std::clamp(px - padding_, 0, image.width - 1)};
+        const unsigned char* src{image.data.data() + (image_y * image.width + image_x) * 4};
+        unsigned char* dst{layer + ((position.y + py) * layer_width_ + position.x + px) * 4};
+        std::copy(src, src + 4, dst);
+      }
+    }
+  }
+
+  TextureArray texture_array{};
+  texture_array.n_layers = static_cast<int>(std::max<std::size_t>(1, skyline_list.size()));
+
+  glGenTextures(1, &texture_array.id);
+  texture_array.bind();
+  // no REPEAT: it would wrap on the whole layer, not on the image
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexImage3D(
+    GL_TEXTURE_2D_ARRAY,
+    0,
+    GL_RGBA,
+    layer_width_,
+    layer_height_,
+    texture_array.n_layers,  // depth of the array: its number of layers
+    0,
+    GL_RGBA,
+    GL_UNSIGNED_BYTE,
+    layer_data.data()
+  );
+  // the mipmaps are per layer, the padding limits the bleeding between
+  // images on the first levels
+  glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+  texture_array.unbind();
+
+  // the images are in the GPU now
+  image_list_.clear();
+
+  return texture_array;
+}
+
+const TextureRegion& TextureArrayPacker::getRegion(std::size_t image_index) const
+{
+  return region_list_[image_index];
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "glad/glad.h"
+#include "glm/glm.hpp"
+
+// Texture array (GL_TEXTURE_2D_ARRAY) built by TextureArrayPacker
+struct TextureArray final {
+  GLuint id{0};
+  int n_layers{0};
+  void bind();
+  void unbind();
+};
+
+// Where an image ended up in the texture array
+// uv in the image [0, 1] becomes uv_offset + uv * uv_scale in the layer
+struct TextureRegion {
+  int layer{-1};
+  glm::vec2 uv_offset{0.0f};
+  glm::vec2 uv_scale{1.0f};
+  // to send to the shaders in one vec4
+  glm::vec4 getRect() const { return glm::vec4(uv_offset, uv_scale); }
+};
+
+// Pack many (small) images in the layers of a single texture array, so a
+// scene with many materials needs one texture bind instead of one per material
+// The images are placed in each layer with a skyline (bottom-left) packer,
+// a new layer is opened when one is full
+// Each image is surrounded by a border copied from its edges, so linear
+// filtering does not bleed the neighbours (REPEAT wrapping is not
+// possible anymore: the uv of the meshes have to stay in [0, 1])
+class TextureArrayPacker final {
+private:
+  struct Image_ {
+    int width;
+    int height;
+    // RGBA
+    std::vector<unsigned char> data;
+  };
+  // top of the already packed images, from x to x + width
+  struct SkylineNode_ {
+    int x;
+    int y;
+    int width;
+  };
+  int layer_width_;
+  int layer_height_;
+  int padding_;
+  std::vector<Image_> image_list_;
+  std::vector<TextureRegion> region_list_;
+  // find the lowest place for a width*height rectangle in the skyline
+  // return the node index, -1 if it does not fit
+  int findPosition_(const std::vector<SkylineNode_>& skyline, int width, int height, int& x, int& y) const;
+  void insertNode_(std::vector<SkylineNode_>& skyline, int node_index, int x, int y, int width, int height) const;
+public:
+  TextureArrayPacker(int layer_width, int layer_height, int padding = 2);
+  // Add an image, return its index to get its region once built
+  std::size_t add(const char* image_source);
+  // rgba_data: width * height RGBA pixels, bottom row first (OpenGL order)
+  std::size_t add(const unsigned char* rgba_data, int width, int height);
+  // Pack all the images and upload them (with mipmaps)
+  TextureArray build();
+  // valid after build()
+  const TextureRegion& getRegion(std::size_t image_index) const;
+};
@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <limits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "TextureContainer.hpp"
+
+namespace {
+
+// RAII read only mapping of a whole file
+class MappedFile final {
+private:
+  void* data_{MAP_FAILED};
+  std::size_t size_{0};
+public:
+  explicit MappedFile(const char* file_path)
+  {
+    int file_descriptor{open(file_path, O_RDONLY)};
+
+    if (file_descriptor == -1)
+    {
+      return;
+    }
+
+    struct stat file_stat{};
+
+    if (fstat(file_descriptor, &file_stat) == 0 && file_stat.st_size > 0)
+    {
+      size_ = file_stat.st_size;
+      data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+    }
+
+    // the mapping stays valid without the descriptor
+    close(file_descriptor);
+  }
+  ~MappedFile()
+  {
+    if (data_ != MAP_FAILED)
+    {
+      munmap(data_, size_);
+    }
+  }
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  bool isValid() const { return data_ != MAP_FAILED; }
+  const unsigned char* data() const { return static_cast<const unsigned char*>(data_); }
+  std::size_t size() const { return size_; }
+};
+
+// A level must be inside the file and hold width * height pixels; the
+// values come from the file, so the sums and products are checked before
+// they can wrap around
+bool isLevelValid(const TextureContainerLevel& level, std::uint64_t n_channels, std::size_t file_size)
+{
+  if (level.width == 0 || level.height == 0)
+  {
+    return false;
+  }
+  // at most (2^32 - 1)^2, no overflow in 64 bits
+  const std::uint64_t n_pixels{static_cast<std::uint64_t>(level.width) * level.height};
+  if (n_pixels > std::numeric_limits<std::uint64_t>::max() / n_channels || level.size < n_pixels * n_channels)
+  {
+    return false;
+  }
+  // level.offset + level.size > file_size, without computing the sum
+  return level.offset <= file_size && level.size <= file_size - level.offset;
+}
+
+}
+
+bool writeTextureContainer(const char* container_path, GLuint image_format, const std::vector<MipLevel>& level_list)
+{
+  TextureContainerHeader header{
+    texture_container_magic,
+    texture_container_version,
+    image_format,
+    static_cast<std::uint32_t>(level_list.size())
+  };
+
+  std::vector<TextureContainerLevel> level_table;
+  std::uint64_t offset{sizeof(TextureContainerHeader) + level_list.size() * sizeof(TextureContainerLevel)};
+
+  for (auto& level : level_list)
+  {
+    level_table.push_back(TextureContainerLevel{
+      static_cast<std::uint32_t>(level.width),
+      static_cast<std::uint32_t>(level.height),
+      offset,
+      level.data.size()
+    });
+    offset += level.data.size();
+  }
+
+  std::ofstream file_stream{container_path, std::ios::binary | std::ios::trunc};
+  file_stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file_stream.write(reinterpret_cast<const char*>(level_table.data()), level_table.size() * sizeof(TextureContainerLevel));
+
+  for (auto& level : level_list)
+  {
+    file_stream.write(reinterpret_cast<const char*>(level.data.data()), level.data.size());
+  }
+
+  return static_cast<bool>(file_stream);
+}
+
+Texture loadTextureContainer(const char* container_path)
+{
+  Texture texture{};
+
+  MappedFile mapped_file{container_path};
+
+  if (!mapped_file.isValid() || mapped_file.size() < sizeof(TextureContainerHeader))
+  {
+    std::cout << "Failed to load texture" << std::endl;
+    return texture;
+  }
+
+  auto header{reinterpret_cast<const TextureContainerHeader*>(mapped_file.data())};
+  auto level_table{reinterpret_cast<const TextureContainerLevel*>(mapped_file.data() + sizeof(TextureContainerHeader))};
+
+  if (header->magic != texture_container_magic
+    || header->version != texture_container_version
+    || header->n_levels == 0
+    || sizeof(TextureContainerHeader) + header->n_levels * sizeof(TextureContainerLevel) > mapped_file.size())
+  {
+    std::cout << "Failed to load texture" << std::endl;
+    return texture;
+  }
+
+  if (header->image_format != GL_RGB && header->image_format != GL_RGBA)
+  {
+    std::cout << "Failed to load texture" << std::endl;
+    return texture;
+  }
+  const std::uint64_t n_channels{header->image_format == GL_RGBA ? 4u : 3u};
+
+  // all the levels are checked before the first upload: no texture with
+  // only a part of its mipmap chain
+  // level i is half the size of level i - 1 (at least 1): 32 levels at most
+  // for 32 bits sizes
+  if (header->n_levels > 32)
+  {
+    std::cout << "Failed to load texture" << std::endl;
+    return texture;
+  }
+  for (std::uint32_t i = 0; i < header->n_levels; i++)
+  {
+    const auto& level{level_table[i]};
+    if (!isLevelValid(level, n_channels, mapped_file.size())
+      || level.width != std::max(level_table[0].width >> i, 1u)
+      || level.height != std::max(level_table[0].height >> i, 1u))
+    {
+      std::cout << "Failed to load texture" << std::endl;
+      return texture;
+    }
+  }
+
+  texture.bind();
+  // the levels are tightly packed, a RGB row is not always aligned on 4 bytes
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+  for (std::uint32_t i = 0; i < header->n_levels; i++)
+  {
+    const auto& level{level_table[i]};
+
+    glTexImage2D(
+      GL_TEXTURE_2D,
+      i,  // mipmap level, no glGenerateMipmap needed
+      header->image_format,
+      level.width,
+      level.height,
+      0,
+      header->image_format,
+      GL_UNSIGNED_BYTE,
+      mapped_file.data() + level.offset
+    );
+  }
+
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  // a chain which stops before 1x1 is still complete for the mipmap filters
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, header->n_levels - 1);
+  texture.unbind();
+
+  return texture;
+}
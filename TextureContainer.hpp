@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "glad/glad.h"
+
+#include "MipGenerator.hpp"
+#include "Texture.hpp"
+
+// Precompiled texture file (.ltx): the whole mipmap chain, already decoded
+// and flipped for OpenGL, so loading is a mmap and one glTexImage2D per level
+// instead of a PNG/JPG decode and a glGenerateMipmap
+// (see texture_converter.cpp to create them)
+//
+// layout: TextureContainerHeader, n_levels TextureContainerLevel,
+// then the data of each level at its offset
+struct TextureContainerHeader {
+  std::uint32_t magic;
+  std::uint32_t version;
+  // GL_RGB or GL_RGBA
+  std::uint32_t image_format;
+  std::uint32_t n_levels;
+};
+
+struct TextureContainerLevel {
+  std::uint32_t width;
+  std::uint32_t height;
+  // from the start of the file
+  std::uint64_t offset;
+  std::uint64_t size;
+};
+
+constexpr std::uint32_t texture_container_magic{0x5845544c}; // "LTEX"
+constexpr std::uint32_t texture_container_version{1};
+
+bool writeTextureContainer(const char* container_path, GLuint image_format, const std::vector<MipLevel>& level_list);
+
+// Create a texture from a .ltx file, its data is read straight from the
+// mapped file by the driver, without any copy on our side
+// The texture has no image if the file can not be read
+Texture loadTextureContainer(const char* container_path);
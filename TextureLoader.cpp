@@ -0,0 +1,224 @@
+#include <cstring>
+#include <iostream>
+
+#include "stb_image.h"
+
+#include "TextureLoader.hpp"
+
+TextureLoader::TextureLoader(std::size_t n_threads, std::size_t upload_budget) :
+  upload_budget_{upload_budget}
+{
+  if (n_threads == 0)
+  {
+    n_threads = 1;
+  }
+
+  worker_list_.reserve(n_threads);
+
+  for (std::size_t i = 0; i < n_threads; i++)
+  {
+    worker_list_.emplace_back(&TextureLoader::work_, this);
+  }
+
+  pbo_list_.resize(2);
+  glGenBuffers(pbo_list_.size(), pbo_list_.data());
+}
+
+TextureLoader::~TextureLoader()
+{
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    stopping_ = true;
+  }
+
+  job_condition_.notify_all();
+
+  for (auto& worker : worker_list_)
+  {
+    worker.join();
+  }
+
+  // images decoded but never uploaded
+  for (auto& decoded_image : decoded_queue_)
+  {
+    stbi_image_free(decoded_image.data);
+  }
+
+  glDeleteBuffers(pbo_list_.size(), pbo_list_.data());
+}
+
+void TextureLoader::work_()
+{
+  // OpenGL y axis starts on the bottom and most images start on the top
+  // the flag is per thread, the workers do not share it
+  stbi_set_flip_vertically_on_load_thread(true);
+
+  while (true)
+  {
+    std::function<void()> job;
+
+    {
+      std::unique_lock<std::mutex> lock{mutex_};
+      job_condition_.wait(lock, [this] { return stopping_ || !job_queue_.empty(); });
+
+      if (stopping_ == true)
+      {
+        return;
+      }
+
+      job = std::move(job_queue_.front());
+      job_queue_.pop_front();
+    }
+
+    job();
+  }
+}
+
+Texture TextureLoader::load(const std::string& image_source, GLuint image_format)
+{
+  // created here, the workers have no GL context
+  Texture texture{};
+
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    n_pending_++;
+
+    job_queue_.push_back([this, image_source, image_format, texture_id = texture.id] {
+      // ask stbi for the channels matching the format, whatever the file has
+      const int n_channels{image_format == GL_RGBA ? 4 : 3};
+      DecodedImage_ decoded_image{texture_id, image_format, 0, 0, nullptr};
+      int file_channels{0};
+      decoded_image.data = stbi_load(image_source.c_str(), &decoded_image.width, &decoded_image.height, &file_channels, n_channels);
+
+      {
+        std::lock_guard<std::mutex> lock{mutex_};
+        decoded_queue_.push_back(decoded_image);
+      }
+
+      decoded_condition_.notify_one();
+    });
+  }
+
+  job_condition_.notify_one();
+
+  return texture;
+}
+
+void TextureLoader::upload_(const DecodedImage_& decoded_image)
+{
+  if (decoded_image.data == nullptr)
+  {
+    std::cout << "Failed to load texture" << std::endl;
+    return;
+  }
+
+  const int n_channels{decoded_image.image_format == GL_RGBA ? 4 : 3};
+  const std::size_t image_size{static_cast<std::size_t>(decoded_image.width) * decoded_image.height * n_channels};
+
+  // copy the image in a pixel buffer object: glTexImage2D reads from it
+  // asynchronously, instead of copying from our memory before returning
+  GLuint pbo{pbo_list_[next_pbo_]};
+  next_pbo_ = (next_pbo_ + 1) % pbo_list_.size();
+
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+  // orphan the previous storage, it may still be read by a previous upload
+  glBufferData(GL_PIXEL_UNPACK_BUFFER, image_size, NULL, GL_STREAM_DRAW);
+  void* pbo_data{glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, image_size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT)};
+
+  if (pbo_data != nullptr)
+  {
+    std::memcpy(pbo_data, decoded_image.data, image_size);
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+  }
+  else
+  {
+    // the mapping failed: upload from our memory, which is only read
+    // as a pointer with no pixel unpack buffer bound
+    std::cout << "ERROR::TEXTURE_LOADER::PBO_MAP_FAILED" << std::endl;
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  }
+
+  // the textures may already be bound to units by the render loop,
+  // restore the binding of the active unit when done
+  GLint previous_texture_id{0};
+  glGetIntegerv(GL_TEXTURE_BINDING_2D, &previous_texture_id);
+
+  glBindTexture(GL_TEXTURE_2D, decoded_image.texture_id);
+  // rows of a RGB image are not always aligned on 4 bytes
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glTexImage2D(
+    GL_TEXTURE_2D,
+    0,
+    decoded_image.image_format,
+    decoded_image.width,
+    decoded_image.height,
+    0,
+    decoded_image.image_format,
+    GL_UNSIGNED_BYTE,
+    // with the pixel unpack buffer bound, this is an offset in it
+    pbo_data != nullptr ? nullptr : decoded_image.data
+  );
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  glGenerateMipmap(GL_TEXTURE_2D);
+  glBindTexture(GL_TEXTURE_2D, previous_texture_id);
+
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+std::size_t TextureLoader::update()
+{
+  std::size_t n_uploaded{0};
+  std::size_t uploaded_size{0};
+
+  while (uploaded_size < upload_budget_)
+  {
+    DecodedImage_ decoded_image;
+
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+
+      if (decoded_queue_.empty())
+      {
+        break;
+      }
+
+      decoded_image = decoded_queue_.front();
+      decoded_queue_.pop_front();
+    }
+
+    upload_(decoded_image);
+    stbi_image_free(decoded_image.data);
+
+    const int n_channels{decoded_image.image_format == GL_RGBA ? 4 : 3};
+    uploaded_size += static_cast<std::size_t>(decoded_image.width) * decoded_image.height * n_channels;
+    n_uploaded++;
+
+    std::lock_guard<std::mutex> lock{mutex_};
+    n_pending_--;
+  }
+
+  return n_uploaded;
+}
+
+std::size_t TextureLoader::getPendingCount()
+{
+  std::lock_guard<std::mutex> lock{mutex_};
+
+  return n_pending_;
+}
+
+void TextureLoader::finish()
+{
+  while (getPendingCount() > 0)
+  {
+    {
+      std::unique_lock<std::mutex> lock{mutex_};
+      decoded_condition_.wait(lock, [this] { return !decoded_queue_.empty() || n_pending_ == 0; });
+    }
+
+    // no budget here, we want everything
+    while (update() > 0)
+    {
+    }
+  }
+}
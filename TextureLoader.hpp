@@ -0,0 +1,66 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "glad/glad.h"
+
+#include "Texture.hpp"
+
+// Load textures without stalling the render thread:
+// - images are decoded (stb_image) by a pool of worker threads
+// - the decoded images are uploaded by the render thread (the only one
+//   with a GL context) through pixel buffer objects, with a budget of
+//   bytes per frame, so a lot of textures never makes a frame too long
+class TextureLoader final {
+private:
+  struct DecodedImage_ {
+    GLuint texture_id;
+    GLuint image_format;
+    int width;
+    int height;
+    // nullptr if the image could not be decoded
+    unsigned char* data;
+  };
+  std::size_t upload_budget_;
+  std::vector<std::thread> worker_list_;
+  // decode jobs, run by the workers
+  std::deque<std::function<void()>> job_queue_;
+  // decoded images, waiting for the render thread
+  std::deque<DecodedImage_> decoded_queue_;
+  std::size_t n_pending_{0};
+  bool stopping_{false};
+  std::mutex mutex_;
+  std::condition_variable job_condition_;
+  std::condition_variable decoded_condition_;
+  // pixel buffer objects used in turn, so we do not wait for
+  // the previous copy to a texture to be over
+  std::vector<GLuint> pbo_list_;
+  std::size_t next_pbo_{0};
+  void work_();
+  void upload_(const DecodedImage_& decoded_image);
+public:
+  // upload_budget: bytes uploaded at most per update (at least one image is)
+  explicit TextureLoader(std::size_t n_threads, std::size_t upload_budget = 8 * 1024 * 1024);
+  ~TextureLoader();
+  TextureLoader(const TextureLoader&) = delete;
+  TextureLoader& operator=(const TextureLoader&) = delete;
+  // Return right away a texture without image, it gets its image
+  // (and its mipmaps) from a later update()
+  // image_format: GL_RGB or GL_RGBA
+  Texture load(const std::string& image_source, GLuint image_format);
+  // Upload the images decoded so far, within the budget, to call once
+  // per frame from the render thread
+  // Return the number of textures uploaded
+  std::size_t update();
+  // Number of textures not uploaded yet
+  std::size_t getPendingCount();
+  // Wait for all the textures to be decoded and uploaded
+  void finish();
+};
@@ -0,0 +1,271 @@
+#include <cstring>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+#include "TransformSystem.hpp"
+
+std::size_t TransformSystem::add(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
+{
+  position_x_.push_back(position.x);
+  position_y_.push_back(position.y);
+  position_z_.push_back(position.z);
+  rotation_x_.push_back(rotation.x);
+  rotation_y_.push_back(rotation.y);
+  rotation_z_.push_back(rotation.z);
+  rotation_w_.push_back(rotation.w);
+  scale_x_.push_back(scale.x);
+  scale_y_.push_back(scale.y);
+  scale_z_.push_back(scale.z);
+  dirty_.push_back(0);
+  transform_list_.emplace_back();
+
+  const std::size_t id{dirty_.size() - 1};
+  markDirty_(id);
+  return id;
+}
+
+void TransformSystem::reserve(std::size_t n_objects)
+{
+  for (auto* component : {
+    &position_x_, &position_y_, &position_z_,
+    &rotation_x_, &rotation_y_, &rotation_z_, &rotation_w_,
+    &scale_x_, &scale_y_, &scale_z_
+  })
+  {
+    component->reserve(n_objects);
+  }
+  dirty_.reserve(n_objects);
+  transform_list_.reserve(n_objects);
+}
+
+std::size_t TransformSystem::size() const
+{
+  return dirty_.size();
+}
+
+void TransformSystem::markDirty_(std::size_t id)
+{
+  if (dirty_[id] == 0)
+  {
+    dirty_[id] = 1;
+    n_dirty_++;
+  }
+}
+
+void TransformSystem::setPosition(std::size_t id, const glm::vec3& position)
+{
+  position_x_[id] = position.x;
+  position_y_[id] = position.y;
+  position_z_[id] = position.z;
+  markDirty_(id);
+}
+
+void TransformSystem::setRotation(std::size_t id, const glm::quat& rotation)
+{
+  rotation_x_[id] = rotation.x;
+  rotation_y_[id] = rotation.y;
+  rotation_z_[id] = rotation.z;
+  rotation_w_[id] = rotation.w;
+  markDirty_(id);
+}
+
+void TransformSystem::setScale(std::size_t id, const glm::vec3& scale)
+{
+  scale_x_[id] = scale.x;
+  scale_y_[id] = scale.y;
+  scale_z_[id] = scale.z;
+  markDirty_(id);
+}
+
+void TransformSystem::computeTransform_(std::size_t id)
+{
+  // rotation matrix of the quaternion, same as glm::mat3_cast
+  const float x{rotation_x_[id]};
+  const float y{rotation_y_[id]};
+  const float z{rotation_z_[id]};
+  const float w{rotation_w_[id]};
+
+  const glm::mat3 rotation_matrix{
+    1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y + w * z), 2.0f * (x * z - w * y),
+    2.0f * (x * y - w * z), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z + w * x),
+    2.0f * (x * z + w * y), 2.0f * (y * z - w * x), 1.0f - 2.0f * (x * x + y * y)
+  };
+  const glm::vec3 scale{scale_x_[id], scale_y_[id], scale_z_[id]};
+
+  InstanceTransform& transform{transform_list_[id]};
+  for (int c = 0; c < 3; c++)
+  {
+    // T * R * S: the columns of R scaled, then the translation
+    transform.model_matrix[c] = glm::vec4(rotation_matrix[c] * scale[c], 0.0f);
+    // R * S^-1
+    transform.normal_matrix[c] = rotation_matrix[c] / scale[c];
+  }
+  transform.model_matrix[3] = glm::vec4(position_x_[id], position_y_[id], position_z_[id], 1.0f);
+}
+
+void TransformSystem::computeTransforms4_(std::size_t first_id)
+{
+#if defined(__SSE__)
+  // one object per lane
+  const std::size_t i{first_id};
+  const __m128 x{_mm_loadu_ps(&rotation_x_[i])};
+  const __m128 y{_mm_loadu_ps(&rotation_y_[i])};
+  const __m128 z{_mm_loadu_ps(&rotation_z_[i])};
+  const __m128 w{_mm_loadu_ps(&rotation_w_[i])};
+  const __m128 one{_mm_set1_ps(1.0f)};
+  const __m128 two{_mm_set1_ps(2.0f)};
+  const __m128 zero{_mm_setzero_ps()};
+
+  const __m128 xx{_mm_mul_ps(x, x)};
+  const __m128 yy{_mm_mul_ps(y, y)};
+  const __m128 zz{_mm_mul_ps(z, z)};
+  const __m128 xy{_mm_mul_ps(x, y)};
+  const __m128 xz{_mm_mul_ps(x, z)};
+  const __m128 yz{_mm_mul_ps(y, z)};
+  const __m128 wx{_mm_mul_ps(w, x)};
+  const __m128 wy{_mm_mul_ps(w, y)};
+  const __m128 wz{_mm_mul_ps(w, z)};
+
+  // rotation matrix, r[column][row]
+  __m128 r[3][3]{
+    {
+      _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))),
+      _mm_mul_ps(two, _mm_add_ps(xy, wz)),
+      _mm_mul_ps(two, _mm_sub_ps(xz, wy))
+    },
+    {
+      _mm_mul_ps(two, _mm_sub_ps(xy, wz)),
+      _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))),
+      _mm_mul_ps(two, _mm_add_ps(yz, wx))
+    },
+    {
+      _mm_mul_ps(two, _mm_add_ps(xz, wy)),
+      _mm_mul_ps(two, _mm_sub_ps(yz, wx)),
+      _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy)))
+    }
+  };
+
+  const __m128 scale[3]{
+    _mm_loadu_ps(&scale_x_[i]),
+    _mm_loadu_ps(&scale_y_[i]),
+    _mm_loadu_ps(&scale_z_[i])
+  };
+
+  for (int c = 0; c < 3; c++)
+  {
+    const __m128 inverse_scale{_mm_div_ps(one, scale[c])};
+
+    // column c of the 4 model matrices, transposed from one lane per object
+    // to one register per object
+    __m128 m0{_mm_mul_ps(r[c][0], scale[c])};
+    __m128 m1{_mm_mul_ps(r[c][1], scale[c])};
+    __m128 m2{_mm_mul_ps(r[c][2], scale[c])};
+    __m128 m3{zero};
+    _MM_TRANSPOSE4_PS(m0, m1, m2, m3);
+    _mm_storeu_ps(&transform_list_[i].model_matrix[c][0], m0);
+    _mm_storeu_ps(&transform_list_[i + 1].model_matrix[c][0], m1);
+    _mm_storeu_ps(&transform_list_[i + 2].model_matrix[c][0], m2);
+    _mm_storeu_ps(&transform_list_[i + 3].model_matrix[c][0], m3);
+
+    // column c of the 4 normal matrices, only 3 floats per object:
+    // 2 with storel_pi, then the third one
+    __m128 n0{_mm_mul_ps(r[c][0], inverse_scale)};
+    __m128 n1{_mm_mul_ps(r[c][1], inverse_scale)};
+    __m128 n2{_mm_mul_ps(r[c][2], inverse_scale)};
+    __m128 n3{zero};
+    _MM_TRANSPOSE4_PS(n0, n1, n2, n3);
+    const __m128 normal_columns[4]{n0, n1, n2, n3};
+    for (std::size_t k = 0; k < 4; k++)
+    {
+      float* destination{&transform_list_[i + k].normal_matrix[c][0]};
+      _mm_storel_pi(reinterpret_cast<__m64*>(destination), normal_columns[k]);
+      _mm_store_ss(destination + 2, _mm_movehl_ps(normal_columns[k], normal_columns[k]));
+    }
+  }
+
+  // translation column
+  __m128 t0{_mm_loadu_ps(&position_x_[i])};
+  __m128 t1{_mm_loadu_ps(&position_y_[i])};
+  __m128 t2{_mm_loadu_ps(&position_z_[i])};
+  __m128 t3{one};
+  _MM_TRANSPOSE4_PS(t0, t1, t2, t3);
+  _mm_storeu_ps(&transform_list_[i].model_matrix[3][0], t0);
+  _mm_storeu_ps(&transform_list_[i + 1].model_matrix[3][0], t1);
+  _mm_storeu_ps(&transform_list_[i + 2].model_matrix[3][0], t2);
+  _mm_storeu_ps(&transform_list_[i + 3].model_matrix[3][0], t3);
+#else
+  for (std::size_t id = first_id; id < first_id + 4; id++)
+  {
+    computeTransform_(id);
+  }
+#endif
+}
+
+std::size_t TransformSystem::update()
+{
+  if (n_dirty_ == 0)
+  {
+    return 0;
+  }
+
+  const std::size_t n_objects{size()};
+  std::size_t n_computed{0};
+  std::size_t i{0};
+
+  // groups of 4 objects, computed if one of them changed
+  for (; i + 4 <= n_objects; i += 4)
+  {
+    std::uint32_t dirty_group;
+    std::memcpy(&dirty_group, &dirty_[i], sizeof(dirty_group));
+    if (dirty_group == 0)
+    {
+      continue;
+    }
+
+    computeTransforms4_(i);
+    std::memset(&dirty_[i], 0, 4);
+    n_computed += 4;
+  }
+
+  for (; i < n_objects; i++)
+  {
+    if (dirty_[i] != 0)
+    {
+      computeTransform_(i);
+      dirty_[i] = 0;
+      n_computed++;
+    }
+  }
+
+  n_dirty_ = 0;
+  return n_computed;
+}
+
+std::size_t TransformSystem::updateScalar()
+{
+  if (n_dirty_ == 0)
+  {
+    return 0;
+  }
+
+  std::size_t n_computed{0};
+  for (std::size_t i = 0; i < size(); i++)
+  {
+    if (dirty_[i] != 0)
+    {
+      computeTransform_(i);
+      dirty_[i] = 0;
+      n_computed++;
+    }
+  }
+
+  n_dirty_ = 0;
+  return n_computed;
+}
+
+const std::vector<InstanceTransform>& TransformSystem::getTransforms() const
+{
+  return transform_list_;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "glm/glm.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+#include "InstancedMesh.hpp"
+
+/**
+ * Position, rotation and scale of many objects, and their model and
+ * normal matrices (as InstanceTransform, ready for InstancedMesh or DrawBatcher)
+ *
+ * The components are stored in SoA (one array per component), so 4 objects
+ * are computed at once with SSE, one object per lane
+ * Only the objects changed since the last update() are computed again
+ *
+ * As the model matrix is T * R * S, with R a rotation (orthonormal),
+ * the normal matrix transpose(inverse(mat3(model))) is simply R * S^-1:
+ * no matrix inverse is needed
+ */
+class TransformSystem final {
+private:
+  std::vector<float> position_x_;
+  std::vector<float> position_y_;
+  std::vector<float> position_z_;
+  // unit quaternion
+  std::vector<float> rotation_x_;
+  std::vector<float> rotation_y_;
+  std::vector<float> rotation_z_;
+  std::vector<float> rotation_w_;
+  std::vector<float> scale_x_;
+  std::vector<float> scale_y_;
+  std::vector<float> scale_z_;
+  // 1 if the matrices must be computed again
+  std::vector<std::uint8_t> dirty_;
+  std::size_t n_dirty_{0};
+
+  std::vector<InstanceTransform> transform_list_;
+
+  void computeTransform_(std::size_t id);
+  // objects first_id to first_id + 3, with SSE when available
+  void computeTransforms4_(std::size_t first_id);
+  void markDirty_(std::size_t id);
+public:
+  // Add an object, returns its id
+  std::size_t add(
+    const glm::vec3& position,
+    const glm::quat& rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
+    const glm::vec3& scale = glm::vec3(1.0f)
+  );
+  void reserve(std::size_t n_objects);
+  std::size_t size() const;
+
+  void setPosition(std::size_t id, const glm::vec3& position);
+  // rotation must be normalized
+  void setRotation(std::size_t id, const glm::quat& rotation);
+  void setScale(std::size_t id, const glm::vec3& scale);
+
+  // Compute the matrices of the changed objects, returns how many were computed
+  std::size_t update();
+  // Same with one object at a time, without SIMD, to compare
+  std::size_t updateScalar();
+
+  // Model and normal matrices of all the objects, by id
+  const std::vector<InstanceTransform>& getTransforms() const;
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+// FNV-1a 64 bits hash
+// Pass the result as hash to chain several strings in one hash
+constexpr std::uint64_t hashBytes(std::string_view bytes, std::uint64_t hash = 14695981039346656037ull)
+{
+  for (char c : bytes)
+  {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ull;
+  }
+
+  return hash;
+}
+
+// Hash of a uniform name
+// It is constexpr so names known at compile time can be hashed
+// by the compiler, and it never allocates (no std::string needed)
+constexpr std::uint64_t hashUniformName(std::string_view uniform_name)
+{
+  return hashBytes(uniform_name);
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "glad/glad.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/type_ptr.hpp"
+
+#include "UniformHash.hpp"
+
+// Name of a uniform, reduced to its hash
+// Built implicitly from a literal or a std::string, so the ShaderProgram
+// setters can take it without building a temporary std::string
+// With a literal the hash is computed by the compiler:
+// shader.setVec3("light.ambient"_uniform, color);
+struct UniformName final {
+  std::uint64_t hash;
+  constexpr UniformName(const char* uniform_name) : hash{hashUniformName(uniform_name)} {}
+  constexpr UniformName(std::string_view uniform_name) : hash{hashUniformName(uniform_name)} {}
+  UniformName(const std::string& uniform_name) : hash{hashUniformName(uniform_name)} {}
+};
+
+constexpr UniformName operator""_uniform(const char* uniform_name, std::size_t length)
+{
+  return UniformName{std::string_view{uniform_name, length}};
+}
+
+// Typed handle on a uniform of a given program, resolved once with
+// ShaderProgram::getUniform<T>(name), then set with a single call
+// without any lookup: shader.set(model_matrix_uniform, model_matrix);
+// The type parameter ensures we can not upload a mat3 into a mat4, and
+// the program id that we can not use it with another program
+template <typename T>
+class UniformRef final {
+private:
+  // index of the uniform in the program slots (location and shadow value)
+  int slot_;
+  // program which resolved it
+  GLuint program_id_;
+public:
+  using value_type = T;
+  constexpr explicit UniformRef(int slot = -1, GLuint program_id = 0) : slot_{slot}, program_id_{program_id} {}
+  constexpr int slot() const { return slot_; }
+  constexpr GLuint programId() const { return program_id_; }
+  // -1 if the uniform does not exist or was optimized out by the linker
+  constexpr bool isValid() const { return slot_ != -1; }
+};
+
+// Upload a value to a uniform location of the program in use
+inline void uploadUniform(GLint location, bool value)
+{
+  glUniform1i(location, static_cast<int>(value));
+}
+
+inline void uploadUniform(GLint location, int value)
+{
+  glUniform1i(location, value);
+}
+
+inline void uploadUniform(GLint location, float value)
+{
+  glUniform1f(location, value);
+}
+
+inline void uploadUniform(GLint location, const glm::vec2& vec)
+{
+  glUniform2fv(location, 1, &vec[0]);
+}
+
+inline void uploadUniform(GLint location, const glm::vec3& vec)
+{
+  glUniform3fv(location, 1, &vec[0]);
+}
+
+inline void uploadUniform(GLint location, const glm::vec4& vec)
+{
+  glUniform4fv(location, 1, &vec[0]);
+}
+
+inline void uploadUniform(GLint location, const glm::mat3& mat)
+{
+  glUniformMatrix3fv(location, 1, GL_FALSE, glm::value_ptr(mat));
+}
+
+inline void uploadUniform(GLint location, const glm::mat4& mat)
+{
+  glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
+}
@@ -36,21 +36,10 @@ VAO::VAO(const std::vector<float>& vertices, const std::vector<unsigned int>& in
    // TODO: size dangerous if refactored: a wrong size will prevent any display
   glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
 
-  // Now we have to have to tell OpenGL how to interpret the raw data
-  glVertexAttribPointer(
-    0, // location of the vertex attribute, will be used in vertex shader with layout (location = 0)
-    3, // vertex attribue is a vec3, 3 elements
-    GL_FLOAT, // element of the vec3 is float
-    GL_FALSE, // don't normalize data
-    8 * sizeof(float), // size of a stride is 8 float elements
-    (void*)0 // offset is 0
-  );
-
-  // vertex attributes are disabled by default, so enable the one we created
-  glEnableVertexAttribArray(0);
-
-  glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
-  glEnableVertexAttribArray(1);
+  // Now we have to have to tell OpenGL how to interpret the raw data:
+  // 8 floats per vertex, positions in location 0 and textures in location 1
+  // the normals are in the buffer but are not read
+  VertexLayout<AttribFloat3, AttribUnused<AttribFloat3>, AttribFloat2>::setup(VertexStorage::Interleaved);
 
   unbind();
 }
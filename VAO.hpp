@@ -4,6 +4,8 @@
 
 #include "glad/glad.h"
 
+#include "VertexLayout.hpp"
+
 struct VAO final {
   GLuint id;
   // in C++ C array are passed by pointer
@@ -28,23 +28,9 @@ VAO2::VAO2(const std::vector<float>& vertices)
   // TODO: size dangerous if refactored: a wrong size will prevent any display
   glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
 
-  // Now we have to have to tell OpenGL how to interpret the raw data
-  // vertices
-  glVertexAttribPointer(
-    0, // location of the vertex attribute, will be used in vertex shader with layout (location = 0)
-    3, // vertex attribue is a vec3, 3 elements
-    GL_FLOAT, // element of the vec3 is float
-    GL_FALSE, // don't normalize data
-    5 * sizeof(float), // size of a stride is 8 float elements
-    (void*)0 // offset is 0
-  );
-
-  // vertex attributes are disabled by default, so enable the one we created
-  glEnableVertexAttribArray(0);
-
-  // textures
-  glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-  glEnableVertexAttribArray(1);
+  // Now we have to have to tell OpenGL how to interpret the raw data:
+  // 5 floats per vertex, positions in location 0 and textures in location 1
+  VertexLayout<AttribFloat3, AttribFloat2>::setup(VertexStorage::Interleaved);
 
   unbind();
 }
@@ -4,6 +4,8 @@
 
 #include "glad/glad.h"
 
+#include "VertexLayout.hpp"
+
 /**
  * VAO2 created to avoid breaking existing API and changes are:
  * - no EBO
@@ -0,0 +1,24 @@
+#include "VertexArray.hpp"
+
+void VertexArray::bind()
+{
+  glBindVertexArray(id);
+}
+
+void VertexArray::unbind()
+{
+  // unbind VAO by binding to the default one
+  glBindVertexArray(0);
+}
+
+void VertexArray::draw(GLenum mode)
+{
+  if (n_indices > 0)
+  {
+    glDrawElements(mode, static_cast<GLsizei>(n_indices), GL_UNSIGNED_INT, nullptr);
+  }
+  else
+  {
+    glDrawArrays(mode, 0, static_cast<GLsizei>(n_vertices));
+  }
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "glad/glad.h"
+
+#include "VertexLayout.hpp"
+
+/**
+ * VAO and its vertex buffer, with the attributes described by a VertexLayout
+ * instead of hardcoded strides:
+ *
+ * using CubeLayout = VertexLayout<AttribFloat3, AttribSnorm10, AttribHalf2>;
+ * auto cube{VertexArray::create<CubeLayout>(cube_vertices)};
+ *
+ * The source is always the float array of the examples, it is packed
+ * to the layout before the upload
+ * With indices (see weldVertices in MeshOptimizer) an EBO is created
+ * and draw() uses glDrawElements
+ */
+struct VertexArray final {
+  GLuint id{0};
+  GLuint vbo_id{0};
+  GLuint ebo_id{0};
+  std::size_t n_vertices{0};
+  std::size_t n_indices{0};
+  VertexStorage storage{VertexStorage::Interleaved};
+
+  template <typename Layout>
+  static VertexArray create(const std::vector<float>& vertices, VertexStorage storage = VertexStorage::Interleaved);
+  template <typename Layout>
+  static VertexArray create(
+    const std::vector<float>& vertices,
+    const std::vector<unsigned int>& indices,
+    VertexStorage storage = VertexStorage::Interleaved
+  );
+
+  // Another VAO reading the same vertex buffer with another layout
+  // (same attribute sizes, some of them AttribUnused), for example
+  // the light source only reading the positions of the cube
+  template <typename Layout>
+  VertexArray share() const;
+
+  void bind();
+  void unbind();
+  void draw(GLenum mode = GL_TRIANGLES);
+};
+
+template <typename Layout>
+VertexArray VertexArray::create(const std::vector<float>& vertices, VertexStorage storage)
+{
+  VertexArray vertex_array{};
+  vertex_array.n_vertices = Layout::countVertices(vertices);
+  vertex_array.storage = storage;
+
+  const std::vector<unsigned char> data{Layout::pack(vertices, storage)};
+
+  glGenVertexArrays(1, &vertex_array.id);
+  vertex_array.bind();
+
+  glGenBuffers(1, &vertex_array.vbo_id);
+  glBindBuffer(GL_ARRAY_BUFFER, vertex_array.vbo_id);
+  glBufferData(GL_ARRAY_BUFFER, data.size(), data.data(), GL_STATIC_DRAW);
+
+  Layout::setup(storage, vertex_array.n_vertices);
+
+  vertex_array.unbind();
+
+  return vertex_array;
+}
+
+template <typename Layout>
+VertexArray VertexArray::create(
+  const std::vector<float>& vertices,
+  const std::vector<unsigned int>& indices,
+  VertexStorage storage
+)
+{
+  VertexArray vertex_array{create<Layout>(vertices, storage)};
+  vertex_array.n_indices = indices.size();
+
+  // the EBO binding is part of the VAO state
+  vertex_array.bind();
+  glGenBuffers(1, &vertex_array.ebo_id);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vertex_array.ebo_id);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+  vertex_array.unbind();
+
+  return vertex_array;
+}
+
+template <typename Layout>
+VertexArray VertexArray::share() const
+{
+  VertexArray vertex_array{*this};
+
+  glGenVertexArrays(1, &vertex_array.id);
+  vertex_array.bind();
+
+  // the attributes read the buffer bound when they are declared
+  glBindBuffer(GL_ARRAY_BUFFER, vbo_id);
+  if (ebo_id != 0)
+  {
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_id);
+  }
+  Layout::setup(storage, n_vertices);
+
+  vertex_array.unbind();
+
+  return vertex_array;
+}
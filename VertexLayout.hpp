@@ -0,0 +1,176 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "glad/glad.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/packing.hpp"
+
+// Vertex attribute types
+// Each one describes how an attribute is stored in the vertex buffer
+// (number of components, GL type, size in bytes) and how it is packed
+// from the float arrays of the examples (source_floats floats per vertex)
+// They are only types: the layout is computed by the compiler
+
+// 3 floats, 12 bytes: positions, or normals when precision matters
+struct AttribFloat3 final {
+  static constexpr GLint components{3};
+  static constexpr GLenum gl_type{GL_FLOAT};
+  static constexpr GLboolean normalized{GL_FALSE};
+  static constexpr std::size_t size{3 * sizeof(float)};
+  static constexpr std::size_t source_floats{3};
+  static void pack(const float* source, unsigned char* destination)
+  {
+    std::memcpy(destination, source, size);
+  }
+};
+
+// 2 floats, 8 bytes: texture coordinates
+struct AttribFloat2 final {
+  static constexpr GLint components{2};
+  static constexpr GLenum gl_type{GL_FLOAT};
+  static constexpr GLboolean normalized{GL_FALSE};
+  static constexpr std::size_t size{2 * sizeof(float)};
+  static constexpr std::size_t source_floats{2};
+  static void pack(const float* source, unsigned char* destination)
+  {
+    std::memcpy(destination, source, size);
+  }
+};
+
+// 2 half floats, 4 bytes: texture coordinates in [0, 1] only need
+// 11 bits of mantissa (exact up to 2048 texels)
+struct AttribHalf2 final {
+  static constexpr GLint components{2};
+  static constexpr GLenum gl_type{GL_HALF_FLOAT};
+  static constexpr GLboolean normalized{GL_FALSE};
+  static constexpr std::size_t size{sizeof(std::uint32_t)};
+  static constexpr std::size_t source_floats{2};
+  static void pack(const float* source, unsigned char* destination)
+  {
+    const std::uint32_t packed{glm::packHalf2x16(glm::vec2{source[0], source[1]})};
+    std::memcpy(destination, &packed, size);
+  }
+};
+
+// unit vector in 10 bits signed normalized per component, 4 bytes
+// (the 2 bits of w are left at 0): normals, tangents
+// The shader still reads a vec3, w is dropped
+struct AttribSnorm10 final {
+  static constexpr GLint components{4};
+  static constexpr GLenum gl_type{GL_INT_2_10_10_10_REV};
+  static constexpr GLboolean normalized{GL_TRUE};
+  static constexpr std::size_t size{sizeof(std::uint32_t)};
+  static constexpr std::size_t source_floats{3};
+  static void pack(const float* source, unsigned char* destination)
+  {
+    const std::uint32_t packed{glm::packSnorm3x10_1x2(glm::vec4{source[0], source[1], source[2], 0.0f})};
+    std::memcpy(destination, &packed, size);
+  }
+};
+
+// Attribute stored in the buffer but not read by this layout:
+// it keeps its bytes (so the stride and the offsets match a layout
+// reading the same buffer) but takes no location
+// VertexLayout<AttribFloat3, AttribUnused<AttribFloat3>, AttribFloat2>
+// reads the positions in location 0 and the textures in location 1
+template <typename Attribute>
+struct AttribUnused final {
+  static constexpr GLint components{0};
+  static constexpr std::size_t size{Attribute::size};
+  static constexpr std::size_t source_floats{Attribute::source_floats};
+  static void pack(const float* source, unsigned char* destination)
+  {
+    Attribute::pack(source, destination);
+  }
+};
+
+// How the attributes of a mesh are stored in its vertex buffer
+enum class VertexStorage {
+  // one vertex after the other: pos, norm, uv, pos, norm, uv, ...
+  // one fetch brings all the attributes of a vertex
+  Interleaved,
+  // one array per attribute: pos, pos, ..., norm, norm, ..., uv, uv, ...
+  // a pass only reading the positions (depth, shadows) fetches nothing else
+  Separate
+};
+
+// Vertex layout described by the list of its attribute types:
+// using CubeLayout = VertexLayout<AttribFloat3, AttribSnorm10, AttribHalf2>;
+// Locations are given in order to the attributes used (0, 1, 2 here),
+// stride and offsets are known at compile time
+template <typename... Attributes>
+struct VertexLayout final {
+  // bytes of one vertex
+  static constexpr std::size_t stride{(Attributes::size + ... + 0)};
+  // floats of one vertex in the source array
+  static constexpr std::size_t source_stride{(Attributes::source_floats + ... + 0)};
+
+  // Number of vertices in a source float array
+  static std::size_t countVertices(const std::vector<float>& vertices)
+  {
+    return vertices.size() / source_stride;
+  }
+
+  // Convert a source float array to the content of the vertex buffer
+  static std::vector<unsigned char> pack(const std::vector<float>& vertices, VertexStorage storage)
+  {
+    const std::size_t n_vertices{countVertices(vertices)};
+    std::vector<unsigned char> data(n_vertices * stride);
+
+    std::size_t source_offset{0};
+    std::size_t offset{0};
+    forEachAttribute_([&](auto attribute) {
+      using Attribute = decltype(attribute);
+      for (std::size_t i = 0; i < n_vertices; i++)
+      {
+        const float* source{vertices.data() + i * source_stride + source_offset};
+        const std::size_t destination{storage == VertexStorage::Interleaved
+          ? i * stride + offset
+          : offset + i * Attribute::size};
+        Attribute::pack(source, data.data() + destination);
+      }
+      source_offset += Attribute::source_floats;
+      offset += storage == VertexStorage::Interleaved ? Attribute::size : Attribute::size * n_vertices;
+    });
+
+    return data;
+  }
+
+  // Declare the attributes on the bound VAO, reading the bound GL_ARRAY_BUFFER
+  // n_vertices is needed to find the arrays of a Separate storage
+  static void setup(VertexStorage storage, std::size_t n_vertices = 0)
+  {
+    GLuint location{0};
+    std::size_t offset{0};
+    forEachAttribute_([&](auto attribute) {
+      using Attribute = decltype(attribute);
+      if constexpr (Attribute::components > 0)
+      {
+        glVertexAttribPointer(
+          location,
+          Attribute::components,
+          Attribute::gl_type,
+          Attribute::normalized,
+          storage == VertexStorage::Interleaved ? stride : Attribute::size,
+          reinterpret_cast<void*>(offset)
+        );
+        // vertex attributes are disabled by default
+        glEnableVertexAttribArray(location);
+        location++;
+      }
+      offset += storage == VertexStorage::Interleaved ? Attribute::size : Attribute::size * n_vertices;
+    });
+  }
+
+private:
+  // Call function with a value of each attribute type, in order
+  template <typename Function>
+  static void forEachAttribute_(Function&& function)
+  {
+    (function(Attributes{}), ...);
+  }
+};
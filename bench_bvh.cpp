@@ -0,0 +1,164 @@
+#include <vector>
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <thread>
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "BoundingVolumeHierarchy.hpp"
+#include "FrustumCulling.hpp"
+#include "Frustum.hpp"
+
+template <typename Function>
+double time(Function function)
+{
+    auto start_time{std::chrono::steady_clock::now()};
+    function();
+    std::chrono::duration<double, std::milli> duration{std::chrono::steady_clock::now() - start_time};
+    return duration.count();
+}
+
+void report(std::size_t N_objects)
+{
+    // the same density of objects whatever N_objects: about one every 8 units^3
+    const float scene_half_size{std::cbrt(static_cast<float>(N_objects))};
+
+    std::mt19937 generator{42};
+    std::uniform_real_distribution<float> position_distribution{-scene_half_size, scene_half_size};
+    std::uniform_real_distribution<float> extent_distribution{0.25f, 1.0f};
+    std::uniform_real_distribution<float> unit_distribution{-1.0f, 1.0f};
+
+    std::vector<Aabb> box_list(N_objects);
+    for (auto& box : box_list)
+    {
+        const glm::vec3 center{position_distribution(generator), position_distribution(generator), position_distribution(generator)};
+        box = Aabb::fromCenter(center, glm::vec3(extent_distribution(generator)));
+    }
+
+    std::cout << N_objects << " objects" << std::endl;
+
+    BoundingVolumeHierarchy bvh{};
+    double build_time{time([&]() { bvh.build(box_list, 1); })};
+    std::cout << "  build (1 thread): " << build_time << " ms, "
+        << bvh.getNodeCount() << " nodes, SAH cost " << bvh.getCost() << std::endl;
+
+    const unsigned int n_threads{std::max(std::thread::hardware_concurrency(), 1u)};
+    if (n_threads > 1)
+    {
+        double parallel_build_time{time([&]() { bvh.build(box_list, n_threads); })};
+        std::cout << "  build (" << n_threads << " threads): " << parallel_build_time << " ms" << std::endl;
+    }
+
+    // every object moves a little, the tree is kept
+    for (auto& box : box_list)
+    {
+        const glm::vec3 offset{unit_distribution(generator), unit_distribution(generator), unit_distribution(generator)};
+        box.min_corner += offset;
+        box.max_corner += offset;
+    }
+    double refit_time{time([&]() { bvh.refit(box_list); })};
+    const float refit_cost{bvh.getCost()};
+    BoundingVolumeHierarchy rebuilt_bvh{};
+    rebuilt_bvh.build(box_list, n_threads);
+    std::cout << "  refit: " << refit_time << " ms, SAH cost " << refit_cost
+        << " (" << rebuilt_bvh.getCost() << " rebuilt)" << std::endl;
+
+    // a camera at the center of the scene, looking in random directions,
+    // against the SSE test of all the boxes
+    const int N_frustums{16};
+    BoundingBoxes bounding_boxes{};
+    bounding_boxes.reserve(N_objects);
+    for (const auto& box : box_list)
+    {
+        bounding_boxes.add(box.min_corner, box.max_corner);
+    }
+    const glm::mat4 projection_matrix{glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f)};
+    std::vector<Frustum> frustum_list{};
+    for (int i = 0; i < N_frustums; i++)
+    {
+        const glm::vec3 direction{glm::normalize(glm::vec3(unit_distribution(generator), unit_distribution(generator), unit_distribution(generator)))};
+        const glm::vec3 up{std::abs(direction.y) > 0.99f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f)};
+        frustum_list.push_back(extractFrustum(projection_matrix * glm::lookAt(glm::vec3(0.0f), direction, up)));
+    }
+
+    std::vector<std::uint32_t> visible_ids{};
+    std::vector<std::uint32_t> brute_force_ids{};
+    std::size_t n_visible{0};
+    std::size_t n_visited{0};
+    bool same_result{true};
+    double bvh_frustum_time{0.0};
+    double brute_force_frustum_time{0.0};
+    for (const auto& frustum : frustum_list)
+    {
+        bvh_frustum_time += time([&]() { n_visited += bvh.queryFrustum(frustum, visible_ids); });
+        brute_force_frustum_time += time([&]() { cullBoxes(frustum, bounding_boxes, brute_force_ids); });
+        n_visible += visible_ids.size();
+        std::sort(visible_ids.begin(), visible_ids.end());
+        same_result = same_result && visible_ids == brute_force_ids;
+    }
+    std::cout << "  frustum: " << bvh_frustum_time / N_frustums << " ms ("
+        << brute_force_frustum_time / N_frustums << " ms testing all the boxes), "
+        << n_visible / N_frustums << " visible, " << n_visited / N_frustums << " nodes visited"
+        << (same_result ? "" : ", ERROR: not the same objects") << std::endl;
+
+    // picking: rays from the center of the scene
+    const int N_rays{100000};
+    std::vector<Ray> ray_list(N_rays);
+    for (auto& ray : ray_list)
+    {
+        ray.origin = glm::vec3(0.0f);
+        ray.direction = glm::normalize(glm::vec3(unit_distribution(generator), unit_distribution(generator), unit_distribution(generator)));
+    }
+    std::size_t n_hits{0};
+    double ray_time{time([&]() {
+        for (const auto& ray : ray_list)
+        {
+            n_hits += bvh.queryRay(ray).isHit() ? 1 : 0;
+        }
+    })};
+    std::cout << "  ray: " << N_rays / ray_time / 1000.0 << " M rays/s, "
+        << 100.0 * n_hits / N_rays << "% hit" << std::endl;
+
+    // small boxes, like the neighbourhood of an object
+    const int N_overlaps{100000};
+    std::vector<Aabb> query_box_list(N_overlaps);
+    for (auto& box : query_box_list)
+    {
+        const glm::vec3 center{position_distribution(generator), position_distribution(generator), position_distribution(generator)};
+        box = Aabb::fromCenter(center, glm::vec3(2.0f));
+    }
+    std::vector<std::uint32_t> overlap_ids{};
+    std::size_t n_overlaps{0};
+    double overlap_time{time([&]() {
+        for (const auto& box : query_box_list)
+        {
+            bvh.queryOverlap(box, overlap_ids);
+            n_overlaps += overlap_ids.size();
+        }
+    })};
+    std::cout << "  AABB overlap: " << N_overlaps / overlap_time / 1000.0 << " M queries/s, "
+        << static_cast<double>(n_overlaps) / N_overlaps << " objects per query" << std::endl;
+}
+
+// Time the build, refit and queries of BoundingVolumeHierarchy
+// from 10k to 10M objects (the largest count can be given as argument)
+int main(int argc, char* argv[])
+{
+    std::size_t max_objects{10000000};
+    if (argc > 1)
+    {
+        max_objects = std::stoul(argv[1]);
+    }
+
+    for (std::size_t N_objects = 10000; N_objects <= max_objects; N_objects *= 10)
+    {
+        report(N_objects);
+    }
+
+    return 0;
+}
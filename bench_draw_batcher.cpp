@@ -0,0 +1,175 @@
+#include <vector>
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <math.h>
+
+#include "glad/glad.h"
+#include "GLFW/glfw3.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "GLContext.hpp"
+#include "ShaderProgram.hpp"
+#include "Texture.hpp"
+#include "FrameUniformBuffer.hpp"
+#include "GLExtensions.hpp"
+#include "VertexArray.hpp"
+#include "DrawBatcher.hpp"
+#include "MeshOptimizer.hpp"
+#include "PrimitiveMeshes.hpp"
+
+// Compare N objects using 3 different meshes drawn one by one
+// (glBindVertexArray, two glUniformMatrix and glDrawElements per object)
+// and drawn by the DrawBatcher (one glMultiDrawElementsIndirect)
+// The CPU time is measured before glFinish, the frame time after
+// usage: bench_draw_batcher [N_objects] (10000 by default)
+int main(int argc, char* argv[])
+{
+    const std::size_t N_objects{argc > 1 ? static_cast<std::size_t>(std::atol(argv[1])) : 10000};
+    const int N_frames{10};
+
+    // we only need a context: a hidden window,
+    // or offscreen with the LEARNOPENGL_HEADLESS environment variable
+    GLContextOptions context_options{GLContextOptions::fromEnvironment()};
+    context_options.visible = false;
+    GLContext context{context_options};
+    if (!context.isValid())
+    {
+        return -1;
+    }
+
+    if (!loadGLExtensions(context.getProcAddressLoader()))
+    {
+        // the features whose entry points are missing use their OpenGL 3.3 path
+        std::cout << "ERROR::GL_EXTENSIONS::NOT_LOADED: falling back to OpenGL 3.3" << std::endl;
+    }
+
+    glViewport(0, 0, 800, 600);
+    glEnable(GL_DEPTH_TEST);
+
+    std::vector<IndexedMesh> mesh_list{
+        weldVertices(makeCubeVertices(), 8),
+        weldVertices(makeSphereVertices(8, 16), 8),
+        weldVertices(makePyramidVertices(), 8)
+    };
+
+    using Layout = DrawBatcher::Layout;
+    std::vector<VertexArray> vertex_array_list{};
+    DrawBatcher draw_batcher{};
+    for (auto& mesh : mesh_list)
+    {
+        optimizeVertexCache(mesh);
+        optimizeVertexFetch(mesh);
+        vertex_array_list.push_back(VertexArray::create<Layout>(mesh.vertices, mesh.indices));
+        draw_batcher.addMesh(mesh);
+    }
+    draw_batcher.build();
+
+    auto per_draw_shader{ShaderProgram{"./shaders/lighting_map_2_vtx.glsl", "./shaders/lighting_map_3_frag.glsl"}};
+    auto batched_shader{ShaderProgram{"./shaders/lighting_map_instanced_vtx.glsl", "./shaders/lighting_map_3_frag.glsl"}};
+
+    FrameUniformBuffer frame_uniform_buffer{};
+    frame_uniform_buffer.attach(per_draw_shader);
+    frame_uniform_buffer.attach(batched_shader);
+
+    // TODO: harcoded relative path
+    Texture diffuse_map{"./textures/container2.png", GL_RGBA};
+    Texture specular_map{"./textures/container2_specular.png", GL_RGBA};
+    glActiveTexture(GL_TEXTURE0);
+    diffuse_map.bind();
+    glActiveTexture(GL_TEXTURE1);
+    specular_map.bind();
+
+    for (ShaderProgram* shader : {&per_draw_shader, &batched_shader})
+    {
+        shader->use();
+        shader->setInt("material.diffuse", 0);
+        shader->setInt("material.specular", 1);
+        shader->setFloat("material.shininess", 32.0f);
+        shader->setVec3("light.position", glm::vec3(0.0f, 50.0f, 0.0f));
+        shader->setVec3("light.ambient", glm::vec3(0.2f));
+        shader->setVec3("light.diffuse", glm::vec3(0.5f));
+        shader->setVec3("light.specular", glm::vec3(1.0f));
+    }
+
+    // square grid of objects seen from above, the mesh changes with each object
+    const std::size_t N_side{static_cast<std::size_t>(ceil(sqrt(static_cast<double>(N_objects))))};
+    const float half_size{static_cast<float>(N_side)};
+    std::vector<glm::vec3> position_list{};
+    position_list.reserve(N_objects);
+    for (std::size_t i = 0; i < N_objects; i++)
+    {
+        position_list.push_back(glm::vec3(
+            2.0f * (i % N_side) - half_size,
+            0.0f,
+            2.0f * (i / N_side) - half_size
+        ));
+    }
+
+    FrameUniforms frame_uniforms{};
+    frame_uniforms.camera_pos = glm::vec4(0.0f, 1.5f * half_size, 1.5f * half_size, 1.0f);
+    frame_uniforms.view_matrix = glm::lookAt(glm::vec3(frame_uniforms.camera_pos), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    frame_uniforms.projection_matrix = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 10.0f * half_size);
+    frame_uniform_buffer.update(frame_uniforms);
+
+    auto computeModelMatrix = [&](std::size_t i, float time) {
+        glm::mat4 model_matrix{glm::translate(glm::mat4(1.0f), position_list[i])};
+        return glm::rotate(model_matrix, time + 0.1f * i, glm::vec3(1.0f, 0.3f, 0.5f));
+    };
+
+    // run N_frames of draw_frame, and return the average CPU time
+    // and frame time in ms
+    auto measure = [&](auto draw_frame) {
+        draw_frame(0);
+        glFinish();
+        double cpu_time{0.0};
+        auto start_time{std::chrono::steady_clock::now()};
+        for (int frame = 1; frame <= N_frames; frame++)
+        {
+            auto frame_start_time{std::chrono::steady_clock::now()};
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            draw_frame(frame);
+            std::chrono::duration<double, std::milli> cpu_duration{std::chrono::steady_clock::now() - frame_start_time};
+            cpu_time += cpu_duration.count();
+            glFinish();
+        }
+        std::chrono::duration<double, std::milli> duration{std::chrono::steady_clock::now() - start_time};
+        return std::pair<double, double>{cpu_time / N_frames, duration.count() / N_frames};
+    };
+
+    auto model_matrix_uniform{per_draw_shader.getUniform<glm::mat4>("model_matrix")};
+    auto normal_matrix_uniform{per_draw_shader.getUniform<glm::mat3>("normal_matrix")};
+
+    auto per_draw_time{measure([&](int frame) {
+        per_draw_shader.use();
+        for (std::size_t i = 0; i < N_objects; i++)
+        {
+            glm::mat4 model_matrix{computeModelMatrix(i, 0.01f * frame)};
+            per_draw_shader.set(model_matrix_uniform, model_matrix);
+            per_draw_shader.set(normal_matrix_uniform, glm::transpose(glm::inverse(glm::mat3(model_matrix))));
+            auto& vertex_array{vertex_array_list[i % vertex_array_list.size()]};
+            vertex_array.bind();
+            vertex_array.draw();
+        }
+    })};
+
+    auto batched_time{measure([&](int frame) {
+        for (std::size_t i = 0; i < N_objects; i++)
+        {
+            draw_batcher.draw(i % mesh_list.size(), computeModelMatrix(i, 0.01f * frame));
+        }
+        batched_shader.use();
+        draw_batcher.flush();
+    })};
+
+    auto stats{draw_batcher.getStats()};
+
+    std::cout << N_objects << " objects, " << mesh_list.size() << " meshes, average of " << N_frames << " frames" << std::endl;
+    std::cout << "  one draw per object: CPU " << per_draw_time.first << " ms, frame " << per_draw_time.second << " ms" << std::endl;
+    std::cout << "  DrawBatcher: CPU " << batched_time.first << " ms, frame " << batched_time.second << " ms ("
+        << stats.commands << " commands in " << stats.gl_calls << " draw calls, "
+        << (DrawBatcher::isMultiDrawIndirectSupported() ? "glMultiDrawElementsIndirect" : "one call per mesh") << ")" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,235 @@
+#include <vector>
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstdlib>
+#include <math.h>
+
+#include "glad/glad.h"
+#include "GLFW/glfw3.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "GLContext.hpp"
+#include "ShaderProgram.hpp"
+#include "Texture.hpp"
+#include "FrameUniformBuffer.hpp"
+#include "VertexArray.hpp"
+#include "DrawQueue.hpp"
+#include "MeshOptimizer.hpp"
+#include "PrimitiveMeshes.hpp"
+
+// N draws, each with a random program (4), material (8 pairs of textures)
+// and mesh (3), 1 in 10 in a second, blended, pass: drawn in the order of
+// the scene, then sorted by the DrawQueue
+// The CPU time is measured before glFinish, the frame time after
+// usage: bench_draw_queue [N_draws] (50000 by default)
+int main(int argc, char* argv[])
+{
+    const std::size_t N_draws{argc > 1 ? static_cast<std::size_t>(std::atol(argv[1])) : 50000};
+    const int N_frames{10};
+
+    // we only need a context: a hidden window,
+    // or offscreen with the LEARNOPENGL_HEADLESS environment variable
+    GLContextOptions context_options{GLContextOptions::fromEnvironment()};
+    context_options.visible = false;
+    GLContext context{context_options};
+    if (!context.isValid())
+    {
+        return -1;
+    }
+
+    glViewport(0, 0, 800, 600);
+    glEnable(GL_DEPTH_TEST);
+
+    std::vector<IndexedMesh> mesh_list{
+        weldVertices(makeCubeVertices(), 8),
+        weldVertices(makeSphereVertices(8, 16), 8),
+        weldVertices(makePyramidVertices(), 8)
+    };
+
+    using Layout = VertexLayout<AttribFloat3, AttribSnorm10, AttribHalf2>;
+    DrawQueue draw_queue{};
+    draw_queue.reserve(N_draws);
+    std::vector<std::uint32_t> mesh_id_list{};
+    for (auto& mesh : mesh_list)
+    {
+        optimizeVertexCache(mesh);
+        optimizeVertexFetch(mesh);
+        mesh_id_list.push_back(draw_queue.addMesh(VertexArray::create<Layout>(mesh.vertices, mesh.indices)));
+    }
+
+    // the same shaders, but 4 programs: a program change each time
+    // two draws of a different program follow each other
+    // TODO: harcoded relative path
+    std::vector<ShaderProgram> program_list{};
+    program_list.reserve(4);
+    FrameUniformBuffer frame_uniform_buffer{};
+    std::vector<std::uint32_t> program_id_list{};
+    for (int i = 0; i < 4; i++)
+    {
+        program_list.emplace_back("./shaders/lighting_map_2_vtx.glsl", "./shaders/lighting_map_3_frag.glsl");
+        ShaderProgram& shader{program_list.back()};
+        frame_uniform_buffer.attach(shader);
+        shader.use();
+        shader.setInt("material.diffuse", 0);
+        shader.setInt("material.specular", 1);
+        shader.setFloat("material.shininess", 8.0f * (i + 1));
+        shader.setVec3("light.position", glm::vec3(0.0f, 50.0f, 0.0f));
+        shader.setVec3("light.ambient", glm::vec3(0.2f));
+        shader.setVec3("light.diffuse", glm::vec3(0.5f));
+        shader.setVec3("light.specular", glm::vec3(1.0f));
+        program_id_list.push_back(draw_queue.addProgram(shader));
+    }
+
+    std::vector<Texture> diffuse_list{
+        Texture{"./textures/container2.png", GL_RGBA},
+        Texture{"./textures/container.jpg", GL_RGB},
+        Texture{"./textures/awesomeface.png", GL_RGBA},
+        Texture{"./textures/container2_specular.png", GL_RGBA}
+    };
+    std::vector<Texture> specular_list{
+        Texture{"./textures/container2_specular.png", GL_RGBA},
+        Texture{"./textures/container2.png", GL_RGBA}
+    };
+    std::vector<std::uint32_t> material_id_list{};
+    for (auto& diffuse_map : diffuse_list)
+    {
+        for (auto& specular_map : specular_list)
+        {
+            material_id_list.push_back(draw_queue.addMaterial(DrawMaterial{{diffuse_map.id, specular_map.id}}));
+        }
+    }
+
+    // the second pass is blended over the first one
+    draw_queue.setPassCallback([](std::uint32_t pass) {
+        if (pass == 1)
+        {
+            glEnable(GL_BLEND);
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            glDepthMask(GL_FALSE);
+        }
+        else
+        {
+            glDisable(GL_BLEND);
+            glDepthMask(GL_TRUE);
+        }
+    });
+
+    // square grid of objects seen from above, each with a random state
+    struct Object {
+        glm::vec3 position;
+        std::uint32_t pass;
+        std::uint32_t program;
+        std::uint32_t material;
+        std::uint32_t mesh;
+    };
+    const std::size_t N_side{static_cast<std::size_t>(ceil(sqrt(static_cast<double>(N_draws))))};
+    const float half_size{static_cast<float>(N_side)};
+    std::mt19937 generator{42};
+    std::vector<Object> object_list{};
+    object_list.reserve(N_draws);
+    for (std::size_t i = 0; i < N_draws; i++)
+    {
+        object_list.push_back(Object{
+            glm::vec3(2.0f * (i % N_side) - half_size, 0.0f, 2.0f * (i / N_side) - half_size),
+            generator() % 10 == 0 ? 1u : 0u,
+            program_id_list[generator() % program_id_list.size()],
+            material_id_list[generator() % material_id_list.size()],
+            mesh_id_list[generator() % mesh_id_list.size()]
+        });
+    }
+
+    FrameUniforms frame_uniforms{};
+    frame_uniforms.camera_pos = glm::vec4(0.0f, 1.5f * half_size, 1.5f * half_size, 1.0f);
+    frame_uniforms.view_matrix = glm::lookAt(glm::vec3(frame_uniforms.camera_pos), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    const float far_distance{10.0f * half_size};
+    frame_uniforms.projection_matrix = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, far_distance);
+    frame_uniform_buffer.update(frame_uniforms);
+
+    // Queue the draws of a frame: the depth is the distance to the camera,
+    // front to back in the first pass, back to front in the blended one
+    // (within each program, material and mesh: depth is the last field of the key)
+    auto submitFrame = [&](int frame) {
+        const glm::vec3 camera_position{frame_uniforms.camera_pos};
+        for (std::size_t i = 0; i < object_list.size(); i++)
+        {
+            const Object& object{object_list[i]};
+            glm::mat4 model_matrix{glm::translate(glm::mat4(1.0f), object.position)};
+            model_matrix = glm::rotate(model_matrix, 0.01f * frame + 0.1f * i, glm::vec3(1.0f, 0.3f, 0.5f));
+            const float depth{glm::length(object.position - camera_position) / far_distance};
+            draw_queue.submit(object.pass, object.program, object.material, object.mesh, object.pass == 1 ? 1.0f - depth : depth, model_matrix);
+        }
+    };
+
+    struct Measure {
+        double submit_time{0.0};
+        double sort_time{0.0};
+        double replay_time{0.0};
+        double frame_time{0.0};
+        DrawQueueStats stats{};
+    };
+
+    // run N_frames, and return the average times in ms
+    auto measure = [&](DrawQueue::Order order) {
+        submitFrame(0);
+        draw_queue.flush(order);
+        glFinish();
+        Measure result{};
+        using Duration = std::chrono::duration<double, std::milli>;
+        for (int frame = 1; frame <= N_frames; frame++)
+        {
+            auto frame_start_time{std::chrono::steady_clock::now()};
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            submitFrame(frame);
+            auto sort_start_time{std::chrono::steady_clock::now()};
+            if (order == DrawQueue::Order::Sorted)
+            {
+                draw_queue.sort();
+            }
+            auto replay_start_time{std::chrono::steady_clock::now()};
+            draw_queue.flush(order);
+            auto replay_end_time{std::chrono::steady_clock::now()};
+            glFinish();
+            result.submit_time += Duration{sort_start_time - frame_start_time}.count() / N_frames;
+            result.sort_time += Duration{replay_start_time - sort_start_time}.count() / N_frames;
+            result.replay_time += Duration{replay_end_time - replay_start_time}.count() / N_frames;
+            result.frame_time += Duration{std::chrono::steady_clock::now() - frame_start_time}.count() / N_frames;
+        }
+        result.stats = draw_queue.getStats();
+        return result;
+    };
+
+    auto print = [](const char* name, const Measure& result) {
+        const DrawQueueStats& stats{result.stats};
+        std::cout << "  " << name << ": submit " << result.submit_time << " ms, sort " << result.sort_time
+            << " ms, replay " << result.replay_time << " ms, frame " << result.frame_time << " ms" << std::endl;
+        std::cout << "    state changes per frame: " << stats.getStateChanges() << " (" << stats.program_changes << " programs, "
+            << stats.texture_binds << " texture binds for " << stats.material_changes << " materials, "
+            << stats.mesh_changes << " VAOs)" << std::endl;
+    };
+
+    const Measure scene_order{measure(DrawQueue::Order::Submission)};
+    const Measure sorted{measure(DrawQueue::Order::Sorted)};
+
+    // the same keys sorted by std::sort, for the sort time alone
+    std::vector<std::uint64_t> key_list{};
+    for (std::size_t i = 0; i < object_list.size(); i++)
+    {
+        const Object& object{object_list[i]};
+        key_list.push_back(makeDrawKey(object.pass, object.program, object.material, object.mesh, static_cast<float>(i) / N_draws));
+    }
+    std::shuffle(key_list.begin(), key_list.end(), generator);
+    auto std_sort_start_time{std::chrono::steady_clock::now()};
+    std::sort(key_list.begin(), key_list.end());
+    std::chrono::duration<double, std::milli> std_sort_duration{std::chrono::steady_clock::now() - std_sort_start_time};
+
+    std::cout << N_draws << " draws, " << program_id_list.size() << " programs, " << material_id_list.size() << " materials, "
+        << mesh_id_list.size() << " meshes, 2 passes, average of " << N_frames << " frames" << std::endl;
+    print("scene order", scene_order);
+    print("sorted by key", sorted);
+    std::cout << "  (std::sort of the same keys: " << std_sort_duration.count() << " ms)" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,139 @@
+#include <vector>
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <math.h>
+
+#include "glad/glad.h"
+#include "GLFW/glfw3.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "GLContext.hpp"
+#include "ShaderProgram.hpp"
+#include "FrameUniformBuffer.hpp"
+#include "VertexArray.hpp"
+#include "InstancedMesh.hpp"
+#include "MeshOptimizer.hpp"
+#include "PrimitiveMeshes.hpp"
+
+// Compare the frame time of N cubes drawn one by one (two glUniformMatrix
+// and one glDrawElements per cube, matrices computed every frame) and
+// drawn with one glDrawElementsInstanced (matrices uploaded every frame,
+// or once when the cubes do not move)
+// usage: bench_instancing [N_cubes] (100000 by default)
+int main(int argc, char* argv[])
+{
+    const std::size_t N_cubes{argc > 1 ? static_cast<std::size_t>(std::atol(argv[1])) : 100000};
+    const int N_frames{10};
+
+    // we only need a context: a hidden window,
+    // or offscreen with the LEARNOPENGL_HEADLESS environment variable
+    GLContextOptions context_options{GLContextOptions::fromEnvironment()};
+    context_options.visible = false;
+    GLContext context{context_options};
+    if (!context.isValid())
+    {
+        return -1;
+    }
+
+    glViewport(0, 0, 800, 600);
+    glEnable(GL_DEPTH_TEST);
+
+    IndexedMesh cube_mesh{weldVertices(makeCubeVertices(), 8)};
+    optimizeVertexCache(cube_mesh);
+    optimizeVertexFetch(cube_mesh);
+
+    using CubeLayout = VertexLayout<AttribFloat3, AttribSnorm10, AttribHalf2>;
+    VertexArray cube_vertex_array{VertexArray::create<CubeLayout>(cube_mesh.vertices, cube_mesh.indices)};
+    // the instanced mesh adds its attributes to the VAO it is given,
+    // the per draw loop uses its own
+    VertexArray instanced_vertex_array{VertexArray::create<CubeLayout>(cube_mesh.vertices, cube_mesh.indices)};
+    InstancedMesh cube_instances{instanced_vertex_array, 3};
+
+    auto per_draw_shader{ShaderProgram{"./shaders/lighting_map_2_vtx.glsl", "./shaders/lighting_map_3_frag.glsl"}};
+    auto instanced_shader{ShaderProgram{"./shaders/lighting_map_instanced_vtx.glsl", "./shaders/lighting_map_3_frag.glsl"}};
+
+    FrameUniformBuffer frame_uniform_buffer{};
+    frame_uniform_buffer.attach(per_draw_shader);
+    frame_uniform_buffer.attach(instanced_shader);
+
+    // square grid of cubes seen from above
+    const std::size_t N_side{static_cast<std::size_t>(ceil(sqrt(static_cast<double>(N_cubes))))};
+    const float half_size{static_cast<float>(N_side)};
+    std::vector<glm::vec3> cube_position_list{};
+    cube_position_list.reserve(N_cubes);
+    for (std::size_t i = 0; i < N_cubes; i++)
+    {
+        cube_position_list.push_back(glm::vec3(
+            2.0f * (i % N_side) - half_size,
+            0.0f,
+            2.0f * (i / N_side) - half_size
+        ));
+    }
+
+    FrameUniforms frame_uniforms{};
+    frame_uniforms.camera_pos = glm::vec4(0.0f, 1.5f * half_size, 1.5f * half_size, 1.0f);
+    frame_uniforms.view_matrix = glm::lookAt(glm::vec3(frame_uniforms.camera_pos), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    frame_uniforms.projection_matrix = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 10.0f * half_size);
+    frame_uniform_buffer.update(frame_uniforms);
+
+    auto computeModelMatrix = [&](std::size_t i, float time) {
+        glm::mat4 model_matrix{glm::translate(glm::mat4(1.0f), cube_position_list[i])};
+        return glm::rotate(model_matrix, time + 0.1f * i, glm::vec3(1.0f, 0.3f, 0.5f));
+    };
+
+    // run N_frames of draw_frame, and return the average frame time in ms
+    // glFinish waits for the GPU so its time is counted too
+    auto measure = [&](auto draw_frame) {
+        draw_frame(0);
+        glFinish();
+        auto start_time{std::chrono::steady_clock::now()};
+        for (int frame = 1; frame <= N_frames; frame++)
+        {
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            draw_frame(frame);
+            glFinish();
+        }
+        std::chrono::duration<double, std::milli> duration{std::chrono::steady_clock::now() - start_time};
+        return duration.count() / N_frames;
+    };
+
+    auto model_matrix_uniform{per_draw_shader.getUniform<glm::mat4>("model_matrix")};
+    auto normal_matrix_uniform{per_draw_shader.getUniform<glm::mat3>("normal_matrix")};
+
+    double per_draw_time{measure([&](int frame) {
+        per_draw_shader.use();
+        cube_vertex_array.bind();
+        for (std::size_t i = 0; i < N_cubes; i++)
+        {
+            glm::mat4 model_matrix{computeModelMatrix(i, 0.01f * frame)};
+            per_draw_shader.set(model_matrix_uniform, model_matrix);
+            per_draw_shader.set(normal_matrix_uniform, glm::transpose(glm::inverse(glm::mat3(model_matrix))));
+            cube_vertex_array.draw();
+        }
+    })};
+
+    std::vector<glm::mat4> model_matrix_list(N_cubes);
+    double instanced_time{measure([&](int frame) {
+        for (std::size_t i = 0; i < N_cubes; i++)
+        {
+            model_matrix_list[i] = computeModelMatrix(i, 0.01f * frame);
+        }
+        cube_instances.setInstances(model_matrix_list);
+        instanced_shader.use();
+        cube_instances.draw();
+    })};
+
+    double static_instanced_time{measure([&](int) {
+        instanced_shader.use();
+        cube_instances.draw();
+    })};
+
+    std::cout << N_cubes << " cubes, average of " << N_frames << " frames" << std::endl;
+    std::cout << "  one draw per cube: " << per_draw_time << " ms" << std::endl;
+    std::cout << "  instanced, matrices uploaded every frame: " << instanced_time << " ms" << std::endl;
+    std::cout << "  instanced, static matrices: " << static_instanced_time << " ms" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include <vector>
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <algorithm>
+
+#include "MeshOptimizer.hpp"
+#include "PrimitiveMeshes.hpp"
+
+// UV sphere with its triangles shuffled, like a mesh exported without care
+std::vector<float> makeShuffledSphere(int N_rings, int N_sectors)
+{
+    std::vector<float> vertices{makeSphereVertices(N_rings, N_sectors)};
+
+    const std::size_t triangle_floats{3 * 8};
+    std::vector<std::size_t> triangle_order(vertices.size() / triangle_floats);
+    for (std::size_t i = 0; i < triangle_order.size(); i++) {
+        triangle_order[i] = i;
+    }
+    std::mt19937 generator{42};
+    std::shuffle(triangle_order.begin(), triangle_order.end(), generator);
+
+    std::vector<float> shuffled_vertices{};
+    shuffled_vertices.reserve(vertices.size());
+    for (std::size_t triangle : triangle_order) {
+        auto first{vertices.begin() + triangle * triangle_floats};
+        shuffled_vertices.insert(shuffled_vertices.end(), first, first + triangle_floats);
+    }
+    return shuffled_vertices;
+}
+
+void report(const char* name, const std::vector<float>& vertices)
+{
+    auto start_time{std::chrono::steady_clock::now()};
+
+    IndexedMesh mesh{weldVertices(vertices, 8)};
+    float welded_acmr{computeACMR(mesh.indices)};
+    float welded_acmr_32{computeACMR(mesh.indices, 32)};
+
+    optimizeVertexCache(mesh);
+    optimizeVertexFetch(mesh);
+
+    std::chrono::duration<double, std::milli> duration{std::chrono::steady_clock::now() - start_time};
+
+    std::cout << name << ": " << mesh.countTriangles() << " triangles, "
+        << vertices.size() / 8 << " -> " << mesh.countVertices() << " vertices, "
+        << duration.count() << " ms" << std::endl;
+    std::cout << "  ACMR (FIFO 16): 3 unindexed, " << welded_acmr << " welded, "
+        << computeACMR(mesh.indices) << " optimized" << std::endl;
+    std::cout << "  ACMR (FIFO 32): 3 unindexed, " << welded_acmr_32 << " welded, "
+        << computeACMR(mesh.indices, 32) << " optimized" << std::endl;
+}
+
+// Report the vertex shader invocations per triangle (ACMR) of meshes
+// drawn with glDrawArrays, welded in an index buffer, then reordered
+// for the post-transform vertex cache
+int main()
+{
+    report("Cube", makeCubeVertices());
+    report("Sphere 32x64", makeShuffledSphere(32, 64));
+    report("Sphere 256x512", makeShuffledSphere(256, 512));
+
+    return 0;
+}
@@ -0,0 +1,265 @@
+#include <vector>
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <cstdlib>
+#include <math.h>
+
+#include "glad/glad.h"
+#include "GLFW/glfw3.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+#include "GLContext.hpp"
+#include "ShaderProgram.hpp"
+#include "Texture.hpp"
+#include "FrameUniformBuffer.hpp"
+#include "VertexArray.hpp"
+#include "Frustum.hpp"
+#include "FrustumCulling.hpp"
+#include "JobSystem.hpp"
+#include "DrawQueue.hpp"
+#include "MeshOptimizer.hpp"
+#include "PrimitiveMeshes.hpp"
+
+// Record the draws of N rotating objects with 1, 2, 4, ... threads:
+// each thread culls its chunks of objects, computes the model matrices
+// and the sort keys of the visible ones, and records the packets in its
+// own DrawCommandBuffer; the render thread merges the buffers, sorts them
+// and draws them (the only part with GL calls)
+// usage: bench_parallel_recording [N_objects] [max_threads]
+// (200000 objects, and up to one thread per core, at least 4, by default)
+int main(int argc, char* argv[])
+{
+    const std::size_t N_objects{argc > 1 ? static_cast<std::size_t>(std::atol(argv[1])) : 200000};
+    // at least 1: JobSystem{0} would take all the cores, with no buffer for them
+    const std::size_t max_threads{argc > 2 ? static_cast<std::size_t>(std::max(std::atol(argv[2]), 1L)) : std::max<std::size_t>(std::thread::hardware_concurrency(), 4)};
+    const int N_frames{20};
+    // objects per chunk: enough work to hide the cost of taking a job,
+    // enough chunks to balance the threads
+    const std::size_t grain_size{2048};
+
+    // we only need a context: a hidden window,
+    // or offscreen with the LEARNOPENGL_HEADLESS environment variable
+    GLContextOptions context_options{GLContextOptions::fromEnvironment()};
+    context_options.visible = false;
+    GLContext context{context_options};
+    if (!context.isValid())
+    {
+        return -1;
+    }
+
+    glViewport(0, 0, 800, 600);
+    glEnable(GL_DEPTH_TEST);
+
+    std::vector<IndexedMesh> mesh_list{
+        weldVertices(makeCubeVertices(), 8),
+        weldVertices(makeSphereVertices(8, 16), 8),
+        weldVertices(makePyramidVertices(), 8)
+    };
+
+    using Layout = VertexLayout<AttribFloat3, AttribSnorm10, AttribHalf2>;
+    DrawQueue draw_queue{};
+    draw_queue.reserve(N_objects);
+    for (auto& mesh : mesh_list)
+    {
+        optimizeVertexCache(mesh);
+        optimizeVertexFetch(mesh);
+        draw_queue.addMesh(VertexArray::create<Layout>(mesh.vertices, mesh.indices));
+    }
+
+    // TODO: harcoded relative path
+    std::vector<ShaderProgram> program_list{};
+    program_list.reserve(4);
+    FrameUniformBuffer frame_uniform_buffer{};
+    for (int i = 0; i < 4; i++)
+    {
+        program_list.emplace_back("./shaders/lighting_map_2_vtx.glsl", "./shaders/lighting_map_3_frag.glsl");
+        ShaderProgram& shader{program_list.back()};
+        frame_uniform_buffer.attach(shader);
+        shader.use();
+        shader.setInt("material.diffuse", 0);
+        shader.setInt("material.specular", 1);
+        shader.setFloat("material.shininess", 8.0f * (i + 1));
+        shader.setVec3("light.position", glm::vec3(0.0f, 50.0f, 0.0f));
+        shader.setVec3("light.ambient", glm::vec3(0.2f));
+        shader.setVec3("light.diffuse", glm::vec3(0.5f));
+        shader.setVec3("light.specular", glm::vec3(1.0f));
+        draw_queue.addProgram(shader);
+    }
+
+    std::vector<Texture> texture_list{
+        Texture{"./textures/container2.png", GL_RGBA},
+        Texture{"./textures/container.jpg", GL_RGB},
+        Texture{"./textures/container2_specular.png", GL_RGBA}
+    };
+    for (auto& diffuse_map : texture_list)
+    {
+        draw_queue.addMaterial(DrawMaterial{{diffuse_map.id, texture_list[2].id}});
+    }
+
+    // Objects scattered around the camera, each turning around its own axis
+    // The data read by the threads is only read: no lock
+    struct Object {
+        glm::vec3 position;
+        glm::vec3 axis;
+        float speed;
+        std::uint32_t program;
+        std::uint32_t material;
+        std::uint32_t mesh;
+    };
+    const float scene_half_size{100.0f};
+    std::mt19937 generator{42};
+    std::uniform_real_distribution<float> position_distribution{-scene_half_size, scene_half_size};
+    std::uniform_real_distribution<float> unit_distribution{-1.0f, 1.0f};
+    std::vector<Object> object_list{};
+    object_list.reserve(N_objects);
+    BoundingSpheres object_bounds{};
+    object_bounds.reserve(N_objects);
+    for (std::size_t i = 0; i < N_objects; i++)
+    {
+        const glm::vec3 position{position_distribution(generator), position_distribution(generator), position_distribution(generator)};
+        object_list.push_back(Object{
+            position,
+            glm::normalize(glm::vec3(unit_distribution(generator), unit_distribution(generator), 1.0f)),
+            unit_distribution(generator),
+            static_cast<std::uint32_t>(generator() % program_list.size()),
+            static_cast<std::uint32_t>(generator() % texture_list.size()),
+            static_cast<std::uint32_t>(generator() % mesh_list.size())
+        });
+        object_bounds.add(position, 0.5f * sqrtf(3.0f));
+    }
+
+    const float far_distance{2.0f * scene_half_size};
+    const glm::vec3 camera_position{0.0f};
+    const glm::mat4 projection_matrix{glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, far_distance)};
+    auto getViewMatrix = [&](int frame) {
+        const float angle{0.02f * frame};
+        return glm::lookAt(camera_position, glm::vec3(sinf(angle), 0.0f, -cosf(angle)), glm::vec3(0.0f, 1.0f, 0.0f));
+    };
+
+    // The visible ids of a thread, written by each of its chunks: on its own
+    // cache line, like DrawCommandBuffer, so the threads never write the same line
+    struct alignas(64) ThreadScratch {
+        std::vector<std::uint32_t> visible_ids;
+    };
+
+    // Record a frame with the threads of job_system, in one buffer per thread
+    auto recordFrame = [&](JobSystem& job_system, std::vector<DrawCommandBuffer>& command_buffer_list,
+        std::vector<ThreadScratch>& scratch_list, int frame) {
+        const Frustum frustum{extractFrustum(projection_matrix * getViewMatrix(frame))};
+        const float time{0.05f * frame};
+        for (auto& command_buffer : command_buffer_list)
+        {
+            command_buffer.clear();
+        }
+
+        job_system.parallelFor(object_list.size(), grain_size, [&](std::size_t begin, std::size_t end, std::size_t thread_index) {
+            auto& visible_ids{scratch_list[thread_index].visible_ids};
+            auto& command_buffer{command_buffer_list[thread_index]};
+            cullSpheres(frustum, object_bounds, begin, end, visible_ids);
+            for (std::uint32_t id : visible_ids)
+            {
+                const Object& object{object_list[id]};
+                const glm::quat rotation{glm::angleAxis(object.speed * time, object.axis)};
+                const glm::mat4 model_matrix{glm::translate(glm::mat4(1.0f), object.position) * glm::mat4_cast(rotation)};
+                const float depth{glm::length(object.position - camera_position) / far_distance};
+                command_buffer.record(0, object.program, object.material, object.mesh, depth, model_matrix);
+            }
+        });
+    };
+
+    // A checksum of the recorded keys (a sum: the order of the threads
+    // does not matter), the same whatever the number of threads
+    auto getChecksum = [](const std::vector<DrawCommandBuffer>& command_buffer_list) {
+        std::uint64_t checksum{0};
+        std::size_t n_packets{0};
+        for (const auto& command_buffer : command_buffer_list)
+        {
+            for (const auto& packet : command_buffer.getPackets())
+            {
+                checksum += packet.key;
+            }
+            n_packets += command_buffer.size();
+        }
+        return std::pair<std::uint64_t, std::size_t>{checksum, n_packets};
+    };
+
+    std::cout << N_objects << " objects, chunks of " << grain_size << ", average of " << N_frames << " frames, "
+        << std::thread::hardware_concurrency() << " cores" << std::endl;
+
+    using Duration = std::chrono::duration<double, std::milli>;
+    double single_thread_time{0.0};
+    std::pair<std::uint64_t, std::size_t> reference_checksum{};
+    for (std::size_t n_threads = 1; n_threads <= max_threads; n_threads *= 2)
+    {
+        JobSystem job_system{n_threads};
+        std::vector<DrawCommandBuffer> command_buffer_list(n_threads);
+        std::vector<ThreadScratch> scratch_list(n_threads);
+
+        // once to grow the buffers
+        recordFrame(job_system, command_buffer_list, scratch_list, 0);
+        double record_time{0.0};
+        double merge_time{0.0};
+        const std::size_t first_stolen_jobs{job_system.getStolenJobCount()};
+        for (int frame = 1; frame <= N_frames; frame++)
+        {
+            auto record_start_time{std::chrono::steady_clock::now()};
+            recordFrame(job_system, command_buffer_list, scratch_list, frame);
+            auto merge_start_time{std::chrono::steady_clock::now()};
+            // the render thread merges the buffers in the queue and sorts
+            // it; the draws are left out here, they do not depend on the
+            // number of threads (see below)
+            for (const auto& command_buffer : command_buffer_list)
+            {
+                draw_queue.submit(command_buffer);
+            }
+            draw_queue.sort();
+            auto merge_end_time{std::chrono::steady_clock::now()};
+            record_time += Duration{merge_start_time - record_start_time}.count() / N_frames;
+            merge_time += Duration{merge_end_time - merge_start_time}.count() / N_frames;
+            draw_queue.clear();
+        }
+
+        const auto checksum{getChecksum(command_buffer_list)};
+        if (n_threads == 1)
+        {
+            single_thread_time = record_time;
+            reference_checksum = checksum;
+        }
+        std::cout << "  " << n_threads << " threads: record " << record_time << " ms (x" << single_thread_time / record_time
+            << "), merge and sort " << merge_time << " ms, " << checksum.second << " packets, "
+            << (job_system.getStolenJobCount() - first_stolen_jobs) / N_frames << " chunks stolen per frame"
+            << (checksum == reference_checksum ? "" : " ERROR: not the same packets") << std::endl;
+    }
+
+    // The last frame recorded by all the threads, drawn by the render thread
+    {
+        JobSystem job_system{max_threads};
+        std::vector<DrawCommandBuffer> command_buffer_list(max_threads);
+        std::vector<ThreadScratch> scratch_list(max_threads);
+        recordFrame(job_system, command_buffer_list, scratch_list, N_frames);
+        for (const auto& command_buffer : command_buffer_list)
+        {
+            draw_queue.submit(command_buffer);
+        }
+
+        FrameUniforms frame_uniforms{};
+        frame_uniforms.view_matrix = getViewMatrix(N_frames);
+        frame_uniforms.projection_matrix = projection_matrix;
+        frame_uniforms.camera_pos = glm::vec4(camera_position, 1.0f);
+        frame_uniform_buffer.update(frame_uniforms);
+
+        auto replay_start_time{std::chrono::steady_clock::now()};
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        draw_queue.flush();
+        glFinish();
+        const DrawQueueStats stats{draw_queue.getStats()};
+        std::cout << "  replay on the render thread: " << stats.draws << " draws, " << stats.getStateChanges()
+            << " state changes, " << Duration{std::chrono::steady_clock::now() - replay_start_time}.count() << " ms" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,107 @@
+#include <vector>
+#include <iostream>
+#include <chrono>
+#include <filesystem>
+
+#include "glad/glad.h"
+#include "GLFW/glfw3.h"
+#include "stb_image.h"
+
+#include "MipGenerator.hpp"
+#include "Texture.hpp"
+#include "TextureContainer.hpp"
+
+// Compare the load time of a texture from its PNG (stb_image + glGenerateMipmap)
+// and from its precompiled .ltx file (mmap + one upload per level)
+int main()
+{
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    // we only need a context
+    glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+
+    GLFWwindow* window = glfwCreateWindow(800, 600, "LearnOpenGL", NULL, NULL);
+    if (window == NULL)
+    {
+        std::cout << "Failed to create GLFW window" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+    glfwMakeContextCurrent(window);
+
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        std::cout << "Failed to initialize GLAD" << std::endl;
+        return -1;
+    }
+
+    // TODO: harcoded relative path
+    const char* image_path{"./textures/container2.png"};
+    const char* container_path{"./texture_cache/container2.ltx"};
+    const std::size_t N_loads{32};
+
+    // what texture_converter does
+    std::filesystem::create_directories("./texture_cache");
+    stbi_set_flip_vertically_on_load(true);
+    int width{0};
+    int height{0};
+    int file_channels{0};
+    unsigned char *data = stbi_load(image_path, &width, &height, &file_channels, 4);
+
+    if (data == nullptr)
+    {
+        std::cout << "Failed to load image " << image_path << std::endl;
+        return -1;
+    }
+
+    auto mip_start_time{std::chrono::steady_clock::now()};
+    auto level_list{generateMipChain(data, width, height, 4)};
+    std::chrono::duration<double, std::milli> mip_duration{std::chrono::steady_clock::now() - mip_start_time};
+    stbi_image_free(data);
+    writeTextureContainer(container_path, GL_RGBA, level_list);
+
+    std::cout << "CPU mip chain of " << width << "x" << height << ": "
+        << level_list.size() << " levels in " << mip_duration.count() << " ms" << std::endl;
+
+    std::vector<Texture> texture_list;
+    texture_list.reserve(N_loads);
+
+    auto start_time{std::chrono::steady_clock::now()};
+
+    for (std::size_t i = 0; i < N_loads; i++)
+    {
+        texture_list.push_back(Texture{image_path, GL_RGBA});
+    }
+
+    glFinish();
+    std::chrono::duration<double, std::milli> duration{std::chrono::steady_clock::now() - start_time};
+    std::cout << "stbi_load + glGenerateMipmap: " << duration.count() / N_loads << " ms per texture" << std::endl;
+
+    for (auto& texture : texture_list)
+    {
+        glDeleteTextures(1, &texture.id);
+    }
+    texture_list.clear();
+
+    start_time = std::chrono::steady_clock::now();
+
+    for (std::size_t i = 0; i < N_loads; i++)
+    {
+        texture_list.push_back(loadTextureContainer(container_path));
+    }
+
+    glFinish();
+    duration = std::chrono::steady_clock::now() - start_time;
+    std::cout << "mmap .ltx: " << duration.count() / N_loads << " ms per texture" << std::endl;
+
+    for (auto& texture : texture_list)
+    {
+        glDeleteTextures(1, &texture.id);
+    }
+
+    glfwTerminate();
+
+    return 0;
+}
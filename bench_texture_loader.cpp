@@ -0,0 +1,99 @@
+#include <vector>
+#include <iostream>
+#include <chrono>
+#include <thread>
+
+#include "glad/glad.h"
+#include "GLFW/glfw3.h"
+
+#include "Texture.hpp"
+#include "TextureLoader.hpp"
+
+// Load the same images many times with 1 to N decoding threads, and
+// compare with the synchronous Texture constructor
+int main()
+{
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    // we only need a context
+    glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+
+    GLFWwindow* window = glfwCreateWindow(800, 600, "LearnOpenGL", NULL, NULL);
+    if (window == NULL)
+    {
+        std::cout << "Failed to create GLFW window" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+    glfwMakeContextCurrent(window);
+
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        std::cout << "Failed to initialize GLAD" << std::endl;
+        return -1;
+    }
+
+    // TODO: harcoded relative path
+    const std::vector<std::pair<const char*, GLuint>> image_list{
+        {"./textures/container.jpg", GL_RGB},
+        {"./textures/awesomeface.png", GL_RGBA},
+        {"./textures/container2.png", GL_RGBA},
+        {"./textures/container2_specular.png", GL_RGBA}
+    };
+    const std::size_t N_textures{64};
+
+    std::vector<Texture> texture_list;
+    texture_list.reserve(N_textures);
+
+    auto start_time{std::chrono::steady_clock::now()};
+
+    for (std::size_t i = 0; i < N_textures; i++)
+    {
+        auto& image{image_list[i % image_list.size()]};
+        texture_list.push_back(Texture{image.first, image.second});
+    }
+
+    glFinish();
+    std::chrono::duration<double, std::milli> duration{std::chrono::steady_clock::now() - start_time};
+    std::cout << "Texture constructor: " << N_textures << " textures in " << duration.count() << " ms" << std::endl;
+
+    for (auto& texture : texture_list)
+    {
+        glDeleteTextures(1, &texture.id);
+    }
+
+    const std::size_t N_max_threads{std::max(1u, std::thread::hardware_concurrency())};
+
+    for (std::size_t n_threads = 1; n_threads <= N_max_threads; n_threads++)
+    {
+        texture_list.clear();
+
+        auto start_time{std::chrono::steady_clock::now()};
+
+        TextureLoader texture_loader{n_threads};
+
+        for (std::size_t i = 0; i < N_textures; i++)
+        {
+            auto& image{image_list[i % image_list.size()]};
+            texture_list.push_back(texture_loader.load(image.first, image.second));
+        }
+
+        texture_loader.finish();
+        glFinish();
+
+        std::chrono::duration<double, std::milli> duration{std::chrono::steady_clock::now() - start_time};
+        std::cout << "TextureLoader with " << n_threads << " threads: " << N_textures
+            << " textures in " << duration.count() << " ms" << std::endl;
+
+        for (auto& texture : texture_list)
+        {
+            glDeleteTextures(1, &texture.id);
+        }
+    }
+
+    glfwTerminate();
+
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include <vector>
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <algorithm>
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+#include "TransformSystem.hpp"
+
+// Time the model and normal matrices of 1M objects:
+// - with glm, as lighting_map3 did per cube (translate * rotate * scale, transpose(inverse()))
+// - with TransformSystem, one object at a time, then 4 at a time with SSE
+// - with TransformSystem when only 1% of the objects moved, then none
+int main()
+{
+    const std::size_t N_objects{1000000};
+
+    std::mt19937 generator{42};
+    std::uniform_real_distribution<float> position_distribution{-100.0f, 100.0f};
+    std::uniform_real_distribution<float> unit_distribution{-1.0f, 1.0f};
+    std::uniform_real_distribution<float> scale_distribution{0.5f, 2.0f};
+
+    TransformSystem transform_system{};
+    transform_system.reserve(N_objects);
+    std::vector<glm::vec3> position_list(N_objects);
+    std::vector<glm::quat> rotation_list(N_objects);
+    std::vector<glm::vec3> scale_list(N_objects);
+
+    for (std::size_t i = 0; i < N_objects; i++)
+    {
+        position_list[i] = glm::vec3(position_distribution(generator), position_distribution(generator), position_distribution(generator));
+        rotation_list[i] = glm::normalize(glm::quat(unit_distribution(generator), unit_distribution(generator), unit_distribution(generator), unit_distribution(generator)));
+        scale_list[i] = glm::vec3(scale_distribution(generator), scale_distribution(generator), scale_distribution(generator));
+        transform_system.add(position_list[i], rotation_list[i], scale_list[i]);
+    }
+
+    auto time = [](auto function) {
+        auto start_time{std::chrono::steady_clock::now()};
+        function();
+        std::chrono::duration<double, std::milli> duration{std::chrono::steady_clock::now() - start_time};
+        return duration.count();
+    };
+
+    std::vector<InstanceTransform> glm_transform_list(N_objects);
+    double glm_time{time([&]() {
+        for (std::size_t i = 0; i < N_objects; i++)
+        {
+            glm::mat4 model_matrix{glm::translate(glm::mat4(1.0f), position_list[i])};
+            model_matrix = model_matrix * glm::mat4_cast(rotation_list[i]);
+            model_matrix = glm::scale(model_matrix, scale_list[i]);
+            glm_transform_list[i].model_matrix = model_matrix;
+            glm_transform_list[i].normal_matrix = glm::mat3(glm::transpose(glm::inverse(model_matrix)));
+        }
+    })};
+
+    std::size_t n_computed{0};
+    double scalar_time{time([&]() { n_computed = transform_system.updateScalar(); })};
+
+    // mark everything as changed again
+    for (std::size_t i = 0; i < N_objects; i++)
+    {
+        transform_system.setPosition(i, position_list[i]);
+    }
+    double simd_time{time([&]() { n_computed = transform_system.update(); })};
+
+    // both must give the same matrices as glm
+    float max_error{0.0f};
+    const auto& transform_list{transform_system.getTransforms()};
+    for (std::size_t i = 0; i < N_objects; i++)
+    {
+        for (int c = 0; c < 4; c++)
+        {
+            for (int r = 0; r < 4; r++)
+            {
+                max_error = std::max(max_error, std::abs(transform_list[i].model_matrix[c][r] - glm_transform_list[i].model_matrix[c][r]));
+            }
+        }
+        for (int c = 0; c < 3; c++)
+        {
+            for (int r = 0; r < 3; r++)
+            {
+                max_error = std::max(max_error, std::abs(transform_list[i].normal_matrix[c][r] - glm_transform_list[i].normal_matrix[c][r]));
+            }
+        }
+    }
+
+    // 1% of the objects move
+    std::uniform_int_distribution<std::size_t> id_distribution{0, N_objects - 1};
+    for (std::size_t i = 0; i < N_objects / 100; i++)
+    {
+        std::size_t id{id_distribution(generator)};
+        transform_system.setPosition(id, position_list[id] + glm::vec3(1.0f));
+    }
+    std::size_t n_computed_moved{0};
+    double moved_time{time([&]() { n_computed_moved = transform_system.update(); })};
+
+    std::size_t n_computed_static{0};
+    double static_time{time([&]() { n_computed_static = transform_system.update(); })};
+
+    std::cout << N_objects << " objects" << std::endl;
+    std::cout << "  glm translate * rotate * scale, transpose(inverse()): " << glm_time << " ms" << std::endl;
+    std::cout << "  TransformSystem scalar: " << scalar_time << " ms" << std::endl;
+    std::cout << "  TransformSystem SSE: " << simd_time << " ms (" << n_computed
+        << " computed, max difference with glm " << max_error << ")" << std::endl;
+    std::cout << "  TransformSystem SSE, 1% moved: " << moved_time << " ms (" << n_computed_moved << " computed)" << std::endl;
+    std::cout << "  TransformSystem SSE, nothing moved: " << static_time << " ms (" << n_computed_static << " computed)" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <new>
+
+#include "glad/glad.h"
+#include "GLFW/glfw3.h"
+#include "glm/glm.hpp"
+
+#include "GLContext.hpp"
+#include "ShaderProgram.hpp"
+#include "UniformRef.hpp"
+
+// Every allocation of the program goes through these operators: while
+// is_counting is set, they count them
+static bool is_counting{false};
+static std::size_t n_allocations{0};
+
+void* operator new(std::size_t size)
+{
+    if (is_counting)
+    {
+        n_allocations++;
+    }
+    void* pointer{std::malloc(size == 0 ? 1 : size)};
+    if (pointer == nullptr)
+    {
+        throw std::bad_alloc{};
+    }
+    return pointer;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+// Set the uniforms of a program in a loop, with each kind of name the
+// setters take (UniformRef, literal, _uniform, std::string built before
+// the loop), and count the heap allocations: there must be none
+// (the GL driver allocates with malloc, it is not counted)
+// usage: bench_uniform_allocations [N_iterations] (1000 by default)
+// returns 1 if anything was allocated
+int main(int argc, char* argv[])
+{
+    const int N_iterations{argc > 1 ? std::atoi(argv[1]) : 1000};
+
+    // we only need a context: a hidden window,
+    // or offscreen with the LEARNOPENGL_HEADLESS environment variable
+    GLContextOptions context_options{GLContextOptions::fromEnvironment()};
+    context_options.visible = false;
+    GLContext context{context_options};
+    if (!context.isValid())
+    {
+        return -1;
+    }
+
+    // TODO: harcoded relative path
+    auto shader{ShaderProgram{"./shaders/lighting_map_1_vtx.glsl", "./shaders/lighting_map_2_frag.glsl"}};
+    shader.use();
+    const auto model_matrix_uniform{shader.getUniform<glm::mat4>("model_matrix")};
+    const auto normal_matrix_uniform{shader.getUniform<glm::mat3>("normal_matrix"_uniform)};
+    const std::string camera_pos_name{"camera_pos"};
+
+    is_counting = true;
+    for (int i = 0; i < N_iterations; i++)
+    {
+        const float value{static_cast<float>(i)};
+        shader.set(model_matrix_uniform, glm::mat4(value));
+        shader.set(normal_matrix_uniform, glm::mat3(value));
+        shader.setVec3("light.position", glm::vec3(value));
+        shader.setVec3("light.ambient"_uniform, glm::vec3(value));
+        shader.setVec3(camera_pos_name, glm::vec3(value));
+        shader.setFloat("material.shininess", value);
+        shader.setInt("material.diffuse", i % 2);
+        // a name which is not in the program
+        shader.setFloat("not_a_uniform", value);
+    }
+    is_counting = false;
+
+    std::cout << N_iterations << " iterations of 8 uniform sets: " << n_allocations << " allocations" << std::endl;
+    if (n_allocations != 0)
+    {
+        std::cout << "ERROR::BENCH::UNIFORM_SETS_ALLOCATE" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
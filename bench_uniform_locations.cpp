@@ -0,0 +1,142 @@
+#include <vector>
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <functional>
+#include <cstdlib>
+#include <math.h>
+
+#include "glad/glad.h"
+#include "GLFW/glfw3.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/type_ptr.hpp"
+
+#include "GLContext.hpp"
+#include "GLCallCounter.hpp"
+#include "ShaderProgram.hpp"
+#include "VertexArray.hpp"
+#include "MeshOptimizer.hpp"
+#include "PrimitiveMeshes.hpp"
+
+// The uniforms of the lighting_map3 render loop (10 cubes, 4 uniforms per
+// cube, 4 per frame), set in two ways:
+// - before: as ShaderProgram did, a glGetUniformLocation (string lookup in
+//   the driver) before each glUniform*
+// - after: the ShaderProgram setters, the locations being read once at
+//   link time (and the unchanged values not uploaded again)
+// The GL calls of each frame are counted by GLCallCounter
+// usage: bench_uniform_locations [N_frames] (100 by default)
+int main(int argc, char* argv[])
+{
+    const int N_frames{argc > 1 ? std::atoi(argv[1]) : 100};
+
+    // we only need a context: a hidden window,
+    // or offscreen with the LEARNOPENGL_HEADLESS environment variable
+    GLContextOptions context_options{GLContextOptions::fromEnvironment()};
+    context_options.visible = false;
+    GLContext context{context_options};
+    if (!context.isValid())
+    {
+        return -1;
+    }
+
+    GLCallCounter::install();
+
+    glViewport(0, 0, 800, 600);
+    glEnable(GL_DEPTH_TEST);
+
+    IndexedMesh cube_mesh{weldVertices(makeCubeVertices(), 8)};
+    using CubeLayout = VertexLayout<AttribFloat3, AttribSnorm10, AttribHalf2>;
+    VertexArray cube_vertex_array{VertexArray::create<CubeLayout>(cube_mesh.vertices, cube_mesh.indices)};
+
+    // TODO: harcoded relative path
+    auto shader{ShaderProgram{"./shaders/lighting_map_1_vtx.glsl", "./shaders/lighting_map_2_frag.glsl"}};
+    shader.use();
+    shader.setInt("material.diffuse", 0);
+    shader.setInt("material.specular", 1);
+    shader.setFloat("material.shininess", 32.0f);
+    shader.setMat4("projection_matrix", glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f));
+
+    std::vector<glm::vec3> cube_position_list{
+        glm::vec3( 0.0f,  0.0f,  0.0f),
+        glm::vec3( 2.0f,  5.0f, -15.0f),
+        glm::vec3(-1.5f, -2.2f, -2.5f),
+        glm::vec3(-3.8f, -2.0f, -12.3f),
+        glm::vec3( 2.4f, -0.4f, -3.5f),
+        glm::vec3(-1.7f,  3.0f, -7.5f),
+        glm::vec3( 1.3f, -2.0f, -2.5f),
+        glm::vec3( 1.5f,  2.0f, -2.5f),
+        glm::vec3( 1.5f,  0.2f, -1.5f),
+        glm::vec3(-1.3f,  1.0f, -1.5f)
+    };
+
+    // the uniform calls of ShaderProgram before the location cache
+    auto getLocation = [&](const std::string& uniform_name) {
+        return glGetUniformLocation(shader.id, uniform_name.c_str());
+    };
+    struct UniformSetter {
+        std::function<void(const std::string&, const glm::mat4&)> setMat4;
+        std::function<void(const std::string&, const glm::mat3&)> setMat3;
+        std::function<void(const std::string&, const glm::vec3&)> setVec3;
+    };
+    UniformSetter lookup_setter{
+        [&](const std::string& name, const glm::mat4& mat) { glUniformMatrix4fv(getLocation(name), 1, GL_FALSE, glm::value_ptr(mat)); },
+        [&](const std::string& name, const glm::mat3& mat) { glUniformMatrix3fv(getLocation(name), 1, GL_FALSE, glm::value_ptr(mat)); },
+        [&](const std::string& name, const glm::vec3& vec) { glUniform3fv(getLocation(name), 1, &vec[0]); }
+    };
+    UniformSetter cached_setter{
+        [&](const std::string& name, const glm::mat4& mat) { shader.setMat4(name, mat); },
+        [&](const std::string& name, const glm::mat3& mat) { shader.setMat3(name, mat); },
+        [&](const std::string& name, const glm::vec3& vec) { shader.setVec3(name, vec); }
+    };
+
+    // the render loop of lighting_map3, returns the mean CPU time of a frame
+    auto measure = [&](UniformSetter& setter) {
+        double cpu_time{0.0};
+        for (int frame = 0; frame < N_frames; frame++)
+        {
+            auto frame_start_time{std::chrono::steady_clock::now()};
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            const float time{0.01f * frame};
+            const glm::vec3 camera_position{0.0f, 0.0f, 3.0f};
+            const glm::vec3 light_color{sinf(2.0f * time), sinf(0.7f * time), sinf(1.3f * time)};
+            setter.setMat4("view_matrix", glm::lookAt(camera_position, glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+            setter.setVec3("light.ambient", 0.2f * light_color);
+            setter.setVec3("light.diffuse", 0.5f * light_color);
+            setter.setVec3("light.specular", light_color);
+
+            cube_vertex_array.bind();
+            for (std::size_t i = 0; i < cube_position_list.size(); i++)
+            {
+                glm::mat4 model_matrix{glm::translate(glm::mat4(1.0f), cube_position_list[i])};
+                model_matrix = glm::rotate(model_matrix, time + glm::radians(20.0f * i), glm::vec3(1.0f, 0.3f, 0.5f));
+                setter.setMat4("model_matrix", model_matrix);
+                setter.setMat3("normal_matrix", glm::transpose(glm::inverse(glm::mat3(model_matrix))));
+                setter.setVec3("light.position", glm::vec3(0.9f, 0.9f, 0.0f));
+                setter.setVec3("camera_pos", camera_position);
+                cube_vertex_array.draw();
+            }
+            std::chrono::duration<double, std::milli> cpu_duration{std::chrono::steady_clock::now() - frame_start_time};
+            cpu_time += cpu_duration.count();
+            glFinish();
+            GLCallCounter::endFrame();
+        }
+        return cpu_time / N_frames;
+    };
+
+    auto print = [](const char* name, double cpu_time) {
+        const auto counts{GLCallCounter::getLastFrameCounts()};
+        std::cout << "  " << name << ": " << counts[static_cast<std::size_t>(GLCallCategory::Query)] << " glGetUniformLocation, "
+            << counts[static_cast<std::size_t>(GLCallCategory::UniformUpload)] << " glUniform* per frame, CPU "
+            << cpu_time << " ms per frame" << std::endl;
+    };
+
+    std::cout << cube_position_list.size() << " cubes, average of " << N_frames << " frames" << std::endl;
+    const double lookup_time{measure(lookup_setter)};
+    print("glGetUniformLocation before each set", lookup_time);
+    const double cached_time{measure(cached_setter)};
+    print("locations cached at link time", cached_time);
+
+    return 0;
+}
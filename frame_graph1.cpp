@@ -0,0 +1,354 @@
+#include <vector>
+#include <iostream>
+#include <cstring>
+#include <math.h>
+
+#include "glad/glad.h"
+#include "GLFW/glfw3.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/type_ptr.hpp"
+
+#include "GLContext.hpp"
+#include "ShaderProgram.hpp"
+#include "Texture.hpp"
+#include "Camera.hpp"
+#include "FrameUniformBuffer.hpp"
+#include "VertexArray.hpp"
+#include "InstancedMesh.hpp"
+#include "MeshOptimizer.hpp"
+#include "PrimitiveMeshes.hpp"
+#include "TransformSystem.hpp"
+#include "FrameGraph.hpp"
+#include "CameraPath.hpp"
+#include "FrameBenchmark.hpp"
+#include "GLCallCounter.hpp"
+
+// Global variables
+// delta_time
+float delta_time = 0.0f;	// Time between current frame and last frame
+float last_frame_time = 0.0f; // Time of last frame
+
+// Camera global object
+Camera camera{};
+
+void processInput(GLContext& context)
+{
+    if (context.isKeyPressed(GLFW_KEY_ESCAPE))
+    {
+        context.close();
+    }
+    if (context.isKeyPressed(GLFW_KEY_W))
+    {
+        camera.updatePosition(Camera::Movement::Front, delta_time);
+    }
+    if (context.isKeyPressed(GLFW_KEY_S))
+    {
+        camera.updatePosition(Camera::Movement::Back, delta_time);
+    }
+    if (context.isKeyPressed(GLFW_KEY_A))
+    {
+        camera.updatePosition(Camera::Movement::Left, delta_time);
+    }
+    if (context.isKeyPressed(GLFW_KEY_D))
+    {
+        camera.updatePosition(Camera::Movement::Right, delta_time);
+    }
+}
+
+void mouseCallback(GLFWwindow* window, double x_pos, double y_pos) {
+    camera.updateOrientation(x_pos, y_pos);
+}
+
+int main(int argc, char* argv[])
+{
+    // a window, or offscreen with --headless N_frames
+    GLContext context{GLContextOptions::fromCommandLine(argc, argv)};
+    if (!context.isValid())
+    {
+        return -1;
+    }
+
+    // --count-gl-calls: every GL call is counted, by function and by
+    // category, and the histograms are printed at the end (see GLCallCounter)
+    if (GLCallCounter::isRequested(argc, argv))
+    {
+        GLCallCounter::install();
+    }
+
+    // --show-shadow-map: the screen shows the shadow map instead of the scene
+    bool show_shadow_map{false};
+    for (int i = 1; i < argc; i++)
+    {
+        show_shadow_map = show_shadow_map || std::strcmp(argv[i], "--show-shadow-map") == 0;
+    }
+
+    // The framebuffer and the viewport of each pass are set by the frame
+    // graph, the window keeps its size
+    context.captureCursor();
+    context.setCursorPosCallback(mouseCallback);
+
+    // A grid of cubes on a floor (a flattened cube), lit by a light
+    // casting shadows
+    TransformSystem cube_transforms{};
+    for (int x = -3; x <= 3; x++)
+    {
+        for (int z = -3; z <= 3; z++)
+        {
+            const glm::vec3 position{1.8f * x, 0.5f * ((x + z + 6) % 3), 1.8f * z};
+            const glm::quat rotation{glm::angleAxis(glm::radians(15.0f * (x * 7 + z)), glm::vec3(0.0f, 1.0f, 0.0f))};
+            cube_transforms.add(position, rotation);
+        }
+    }
+    cube_transforms.add(glm::vec3(0.0f, -0.6f, 0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(16.0f, 0.2f, 16.0f));
+    cube_transforms.update();
+
+    IndexedMesh cube_mesh{weldVertices(makeCubeVertices(), 8)};
+    optimizeVertexCache(cube_mesh);
+    optimizeVertexFetch(cube_mesh);
+    using CubeLayout = VertexLayout<AttribFloat3, AttribSnorm10, AttribHalf2>;
+    VertexArray cube_vertex_array{VertexArray::create<CubeLayout>(cube_mesh.vertices, cube_mesh.indices)};
+    // the light source only reads the positions of the cube VBO
+    using LightSourceLayout = VertexLayout<AttribFloat3, AttribUnused<AttribSnorm10>, AttribUnused<AttribHalf2>>;
+    VertexArray light_source_vertex_array{cube_vertex_array.share<LightSourceLayout>()};
+    InstancedMesh cube_instances{cube_vertex_array, 3};
+    cube_instances.setInstances(cube_transforms.getTransforms());
+
+    // the full screen passes draw a triangle without vertices, but a VAO
+    // has to be bound
+    GLuint fullscreen_vao_id{0};
+    glGenVertexArrays(1, &fullscreen_vao_id);
+
+    // TODO: harcoded relative path
+    auto scene_shader{ShaderProgram{"./shaders/lighting_map_instanced_vtx.glsl", "./shaders/shadow_map_1_frag.glsl"}};
+    auto shadow_depth_shader{ShaderProgram{"./shaders/shadow_depth_1_vtx.glsl", "./shaders/shadow_depth_1_frag.glsl"}};
+    auto light_source_shader{ShaderProgram{"./shaders/lighting_cube_2_vtx.glsl", "./shaders/lighting_source_1_frag.glsl"}};
+    auto blur_shader{ShaderProgram{"./shaders/fullscreen_1_vtx.glsl", "./shaders/blur_1_frag.glsl"}};
+    auto composite_shader{ShaderProgram{"./shaders/fullscreen_1_vtx.glsl", "./shaders/composite_1_frag.glsl"}};
+    auto depth_view_shader{ShaderProgram{"./shaders/fullscreen_1_vtx.glsl", "./shaders/depth_view_1_frag.glsl"}};
+
+    FrameUniformBuffer frame_uniform_buffer{};
+    frame_uniform_buffer.attach(scene_shader);
+    frame_uniform_buffer.attach(light_source_shader);
+
+    // texture units: 0 and 1 for the material, 2 for the shadow map,
+    // 3 and 4 for the full screen passes
+    Texture diffuse_map{"./textures/container2.png", GL_RGBA};
+    Texture specular_map{"./textures/container2_specular.png", GL_RGBA};
+
+    // The light looks at the center of the scene, with an orthographic
+    // projection covering it (a directional light, like the sun)
+    const glm::vec3 light_position{5.0f, 8.0f, 4.0f};
+    const glm::mat4 light_matrix{
+        glm::ortho(-12.0f, 12.0f, -12.0f, 12.0f, 1.0f, 25.0f)
+        * glm::lookAt(light_position, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f))
+    };
+
+    scene_shader.use();
+    scene_shader.setInt("material.diffuse", 0);
+    scene_shader.setInt("material.specular", 1);
+    scene_shader.setInt("shadow_map", 2);
+    scene_shader.setFloat("material.shininess", 32.0f);
+    scene_shader.setVec3("light.position", light_position);
+    scene_shader.setVec3("light.ambient", glm::vec3(0.2f));
+    scene_shader.setVec3("light.diffuse", glm::vec3(0.6f));
+    scene_shader.setVec3("light.specular", glm::vec3(1.0f));
+    scene_shader.setMat4("light_matrix", light_matrix);
+    shadow_depth_shader.use();
+    shadow_depth_shader.setMat4("light_matrix", light_matrix);
+    light_source_shader.use();
+    light_source_shader.setVec3("light_color", glm::vec3(1.0f));
+    light_source_shader.setMat4("model_matrix", glm::scale(glm::translate(glm::mat4(1.0f), light_position), glm::vec3(0.3f)));
+    blur_shader.use();
+    blur_shader.setInt("source", 3);
+    auto texel_step_uniform{blur_shader.getUniform<glm::vec2>("texel_step")};
+    auto threshold_uniform{blur_shader.getUniform<float>("threshold")};
+    composite_shader.use();
+    composite_shader.setInt("scene", 3);
+    composite_shader.setInt("glow", 4);
+    auto glow_strength_uniform{composite_shader.getUniform<float>("glow_strength")};
+    depth_view_shader.use();
+    depth_view_shader.setInt("depth_map", 3);
+
+    camera.setPerspective(45.0f, 800.0f / 600.0f, 0.1f, 100.0f);
+
+    // With --benchmark N_frames, the camera turns around the scene, at
+    // the same time step in each run, and the frames are measured
+    // (see FrameBenchmark)
+    CameraPath benchmark_path{{
+        {0.0f, glm::vec3(0.0f, 6.0f, 14.0f), -90.0f, -25.0f},
+        {4.0f, glm::vec3(14.0f, 6.0f, 0.0f), -180.0f, -25.0f},
+        {8.0f, glm::vec3(0.0f, 6.0f, -14.0f), -270.0f, -25.0f},
+        {12.0f, glm::vec3(-14.0f, 6.0f, 0.0f), -360.0f, -25.0f},
+        {16.0f, glm::vec3(0.0f, 6.0f, 14.0f), -450.0f, -25.0f}
+    }};
+    FrameBenchmark benchmark{FrameBenchmarkOptions::fromCommandLine(argc, argv, "frame_graph1"), benchmark_path};
+    benchmark_path.apply(0.0f, camera);
+
+    // The passes of the frame, in the order they come to mind: each one
+    // only says what it reads and what it writes, the frame graph culls,
+    // orders, allocates the targets and binds the framebuffers
+    // (see FrameGraph)
+    FrameGraph frame_graph{};
+    const int width{context.getWidth()};
+    const int height{context.getHeight()};
+    auto screen{frame_graph.importFramebuffer("screen", context.getDefaultFramebuffer(), width, height)};
+    auto shadow_map{frame_graph.createRenderTarget("shadow map", {1024, 1024, GL_DEPTH_COMPONENT24})};
+    auto scene_color{frame_graph.createRenderTarget("scene color", {width, height, GL_RGBA8})};
+    auto scene_depth{frame_graph.createRenderTarget("scene depth", {width, height, GL_DEPTH_COMPONENT24})};
+    auto shadow_map_view{frame_graph.createRenderTarget("shadow map view", {width, height, GL_RGBA8})};
+    // the glow is blurred twice at half resolution: 4 targets, but only
+    // 2 live at the same time
+    const RenderTargetDesc glow_desc{width / 2, height / 2, GL_RGBA8};
+    RenderTargetHandle glow_list[4]{
+        frame_graph.createRenderTarget("glow 1", glow_desc),
+        frame_graph.createRenderTarget("glow 2", glow_desc),
+        frame_graph.createRenderTarget("glow 3", glow_desc),
+        frame_graph.createRenderTarget("glow 4", glow_desc)
+    };
+
+    auto drawFullscreen = [&]() {
+        glBindVertexArray(fullscreen_vao_id);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        benchmark.countDraws();
+    };
+
+    frame_graph.addPass("shadow map", [&](const FrameGraph&) {
+        glEnable(GL_DEPTH_TEST);
+        shadow_depth_shader.use();
+        cube_instances.draw();
+        benchmark.countDraws();
+    }).writeDepth(shadow_map, 1.0f);
+
+    frame_graph.addPass("scene", [&](const FrameGraph& graph) {
+        glActiveTexture(GL_TEXTURE2);
+        glBindTexture(GL_TEXTURE_2D, graph.getTexture(shadow_map));
+        scene_shader.use();
+        cube_instances.draw();
+        benchmark.countDraws();
+    }).read(shadow_map)
+        .writeColor(scene_color, glm::vec4(0.05f, 0.07f, 0.1f, 1.0f))
+        .writeDepth(scene_depth, 1.0f);
+
+    // debug view, only drawn when someone reads it
+    frame_graph.addPass("shadow map view", [&](const FrameGraph& graph) {
+        glDisable(GL_DEPTH_TEST);
+        glActiveTexture(GL_TEXTURE3);
+        glBindTexture(GL_TEXTURE_2D, graph.getTexture(shadow_map));
+        depth_view_shader.use();
+        drawFullscreen();
+    }).read(shadow_map)
+        .writeColor(shadow_map_view);
+
+    // declared after the debug view, but drawn right after the scene:
+    // same framebuffer
+    frame_graph.addPass("light source", [&](const FrameGraph&) {
+        glEnable(GL_DEPTH_TEST);
+        light_source_shader.use();
+        light_source_vertex_array.bind();
+        light_source_vertex_array.draw();
+        benchmark.countDraws();
+    }).writeColor(scene_color)
+        .writeDepth(scene_depth);
+
+    for (int i = 0; i < 2; i++)
+    {
+        const RenderTargetHandle source{i == 0 ? scene_color : glow_list[2 * i - 1]};
+        const RenderTargetHandle horizontal{glow_list[2 * i]};
+        const RenderTargetHandle vertical{glow_list[2 * i + 1]};
+        // the first blur only keeps the brightest parts of the scene
+        const float threshold{i == 0 ? 0.6f : 0.0f};
+        const glm::vec2 source_texel{i == 0 ? glm::vec2(1.0f / width, 1.0f / height) : glm::vec2(2.0f / width, 2.0f / height)};
+
+        frame_graph.addPass("glow horizontal " + std::to_string(i + 1), [&, source, threshold, source_texel](const FrameGraph& graph) {
+            glDisable(GL_DEPTH_TEST);
+            glActiveTexture(GL_TEXTURE3);
+            glBindTexture(GL_TEXTURE_2D, graph.getTexture(source));
+            blur_shader.use();
+            blur_shader.set(texel_step_uniform, glm::vec2(source_texel.x, 0.0f));
+            blur_shader.set(threshold_uniform, threshold);
+            drawFullscreen();
+        }).read(source)
+            .writeColor(horizontal);
+
+        frame_graph.addPass("glow vertical " + std::to_string(i + 1), [&, horizontal](const FrameGraph& graph) {
+            glActiveTexture(GL_TEXTURE3);
+            glBindTexture(GL_TEXTURE_2D, graph.getTexture(horizontal));
+            blur_shader.use();
+            blur_shader.set(texel_step_uniform, glm::vec2(0.0f, 2.0f / height));
+            blur_shader.set(threshold_uniform, 0.0f);
+            drawFullscreen();
+        }).read(horizontal)
+            .writeColor(vertical);
+    }
+
+    // The only pass writing the screen: what it reads decides which
+    // passes are needed
+    const RenderTargetHandle shown{show_shadow_map ? shadow_map_view : scene_color};
+    auto composite_pass{frame_graph.addPass("composite", [&](const FrameGraph& graph) {
+        glDisable(GL_DEPTH_TEST);
+        glActiveTexture(GL_TEXTURE3);
+        glBindTexture(GL_TEXTURE_2D, graph.getTexture(shown));
+        glActiveTexture(GL_TEXTURE4);
+        glBindTexture(GL_TEXTURE_2D, graph.getTexture(glow_list[3]));
+        composite_shader.use();
+        composite_shader.set(glow_strength_uniform, show_shadow_map ? 0.0f : 1.5f);
+        drawFullscreen();
+    })};
+    composite_pass.read(shown).writeColor(screen);
+    if (!show_shadow_map)
+    {
+        composite_pass.read(glow_list[3]);
+    }
+
+    if (!frame_graph.compile())
+    {
+        return -1;
+    }
+    frame_graph.print();
+
+    // the material stays bound for the whole loop (after compile(), which
+    // creates the textures of the render targets)
+    glActiveTexture(GL_TEXTURE0);
+    diffuse_map.bind();
+    glActiveTexture(GL_TEXTURE1);
+    specular_map.bind();
+
+    FrameUniforms frame_uniforms{};
+
+    // Render loop
+    while(!context.shouldClose() && !benchmark.isFinished())
+    {
+        benchmark.beginFrame(camera);
+
+        // delta_time
+        // (the time of the path when benchmarking, so the frames are the same)
+        float current_frame_time = benchmark.isEnabled() ? benchmark.getTime() : context.getTime();
+        delta_time = current_frame_time - last_frame_time;
+        last_frame_time = current_frame_time;
+
+        if (!benchmark.isEnabled())
+        {
+            processInput(context);
+        }
+
+        frame_uniforms.view_matrix = camera.getUpdatedViewMatrix();
+        frame_uniforms.projection_matrix = camera.getProjectionMatrix();
+        frame_uniforms.camera_pos = glm::vec4(camera.getPosition(), 1.0f);
+        frame_uniform_buffer.update(frame_uniforms);
+
+        frame_graph.execute();
+        benchmark.countStateChanges(frame_graph.getStats().n_framebuffer_binds);
+        benchmark.endFrame(ShaderProgram::takeFrameStats());
+
+        context.endFrame();
+        GLCallCounter::endFrame();
+    }
+
+    benchmark.report();
+    GLCallCounter::report();
+
+    glDeleteVertexArrays(1, &fullscreen_vao_id);
+
+    return 0;
+}
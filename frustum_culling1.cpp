@@ -0,0 +1,237 @@
+#include <vector>
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <math.h>
+
+#include "glad/glad.h"
+#include "GLFW/glfw3.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/type_ptr.hpp"
+
+#include "GLContext.hpp"
+#include "ShaderProgram.hpp"
+#include "Texture.hpp"
+#include "Camera.hpp"
+#include "FrameUniformBuffer.hpp"
+#include "VertexArray.hpp"
+#include "InstancedMesh.hpp"
+#include "MeshOptimizer.hpp"
+#include "PrimitiveMeshes.hpp"
+#include "TransformSystem.hpp"
+#include "FrustumCulling.hpp"
+#include "CameraPath.hpp"
+#include "FrameBenchmark.hpp"
+#include "GLCallCounter.hpp"
+
+// Global variables
+// delta_time
+float delta_time = 0.0f;	// Time between current frame and last frame
+float last_frame_time = 0.0f; // Time of last frame
+
+// Camera global object
+Camera camera{};
+
+void framebufferSizeCallback(GLFWwindow* window, int width, int height)
+{
+    glViewport(0, 0, width, height);
+}
+
+void processInput(GLContext& context)
+{
+    if (context.isKeyPressed(GLFW_KEY_ESCAPE))
+    {
+        context.close();
+    }
+    if (context.isKeyPressed(GLFW_KEY_W))
+    {
+        camera.updatePosition(Camera::Movement::Front, delta_time);
+    }
+    if (context.isKeyPressed(GLFW_KEY_S))
+    {
+        camera.updatePosition(Camera::Movement::Back, delta_time);
+    }
+    if (context.isKeyPressed(GLFW_KEY_A))
+    {
+        camera.updatePosition(Camera::Movement::Left, delta_time);
+    }
+    if (context.isKeyPressed(GLFW_KEY_D))
+    {
+        camera.updatePosition(Camera::Movement::Right, delta_time);
+    }
+}
+
+void mouseCallback(GLFWwindow* window, double x_pos, double y_pos) {
+    camera.updateOrientation(x_pos, y_pos);
+}
+
+int main(int argc, char* argv[])
+{
+    // a window, or offscreen with --headless N_frames
+    GLContext context{GLContextOptions::fromCommandLine(argc, argv)};
+    if (!context.isValid())
+    {
+        return -1;
+    }
+
+    // --count-gl-calls: every GL call is counted, by function and by
+    // category, and the histograms are printed at the end (see GLCallCounter)
+    if (GLCallCounter::isRequested(argc, argv))
+    {
+        GLCallCounter::install();
+    }
+
+    glViewport(0, 0, 800, 600);
+
+    context.setFramebufferSizeCallback(framebufferSizeCallback);
+    context.captureCursor();
+    context.setCursorPosCallback(mouseCallback);
+
+    glEnable(GL_DEPTH_TEST);
+
+    // 1M cubes scattered around the camera, with a random orientation
+    // Only the ones in the frustum of the camera are sent to the GPU
+    const std::size_t N_cubes{1000000};
+    const float scene_half_size{200.0f};
+
+    std::mt19937 generator{42};
+    std::uniform_real_distribution<float> position_distribution{-scene_half_size, scene_half_size};
+    std::uniform_real_distribution<float> unit_distribution{-1.0f, 1.0f};
+
+    TransformSystem cube_transforms{};
+    cube_transforms.reserve(N_cubes);
+    // a unit cube fits in a sphere of radius sqrt(3) / 2, whatever its rotation
+    BoundingSpheres cube_bounds{};
+    cube_bounds.reserve(N_cubes);
+
+    for (std::size_t i = 0; i < N_cubes; i++)
+    {
+        const glm::vec3 position{position_distribution(generator), position_distribution(generator), position_distribution(generator)};
+        const glm::quat rotation{glm::normalize(glm::quat(unit_distribution(generator), unit_distribution(generator), unit_distribution(generator), unit_distribution(generator)))};
+        cube_transforms.add(position, rotation);
+        cube_bounds.add(position, 0.5f * sqrtf(3.0f));
+    }
+    // the cubes do not move, their matrices are computed once
+    cube_transforms.update();
+
+    IndexedMesh cube_mesh{weldVertices(makeCubeVertices(), 8)};
+    optimizeVertexCache(cube_mesh);
+    optimizeVertexFetch(cube_mesh);
+    using CubeLayout = VertexLayout<AttribFloat3, AttribSnorm10, AttribHalf2>;
+    InstancedMesh cube_instances{VertexArray::create<CubeLayout>(cube_mesh.vertices, cube_mesh.indices), 3};
+
+    // TODO: harcoded relative path
+    auto cube_shader{ShaderProgram{"./shaders/lighting_map_instanced_vtx.glsl", "./shaders/lighting_map_3_frag.glsl"}};
+
+    FrameUniformBuffer frame_uniform_buffer{};
+    frame_uniform_buffer.attach(cube_shader);
+
+    Texture diffuse_map{"./textures/container2.png", GL_RGBA};
+    Texture specular_map{"./textures/container2_specular.png", GL_RGBA};
+    glActiveTexture(GL_TEXTURE0);
+    diffuse_map.bind();
+    glActiveTexture(GL_TEXTURE1);
+    specular_map.bind();
+
+    cube_shader.use();
+    cube_shader.setInt("material.diffuse", 0);
+    cube_shader.setInt("material.specular", 1);
+    cube_shader.setFloat("material.shininess", 32.0f);
+    cube_shader.setVec3("light.ambient", glm::vec3(0.2f));
+    cube_shader.setVec3("light.diffuse", glm::vec3(0.5f));
+    cube_shader.setVec3("light.specular", glm::vec3(1.0f));
+    auto light_position_uniform{cube_shader.getUniform<glm::vec3>("light.position")};
+
+    // the frustum of the camera is built with this projection
+    camera.setPerspective(45.0f, 800.0f / 600.0f, 0.1f, 100.0f);
+
+    FrameUniforms frame_uniforms{};
+    std::uint64_t culled_camera_version{0};
+    std::vector<std::uint32_t> visible_ids{};
+    std::vector<InstanceTransform> visible_transforms{};
+    CullingStats culling_stats{};
+    double culling_time{0.0};
+
+    // With --benchmark N_frames, the camera turns around on itself while
+    // moving on a small circle, at the same time step in each run, and the
+    // frames are measured (see FrameBenchmark)
+    CameraPath benchmark_path{{
+        {0.0f, glm::vec3(0.0f, 0.0f, 3.0f), -90.0f, 0.0f},
+        {4.0f, glm::vec3(1.5f, 0.0f, 1.5f), -180.0f, 20.0f},
+        {8.0f, glm::vec3(0.0f, 0.0f, 0.0f), -270.0f, -20.0f},
+        {12.0f, glm::vec3(-1.5f, 0.0f, 1.5f), -360.0f, 10.0f},
+        {16.0f, glm::vec3(0.0f, 0.0f, 3.0f), -450.0f, 0.0f}
+    }};
+    FrameBenchmark benchmark{FrameBenchmarkOptions::fromCommandLine(argc, argv, "frustum_culling1"), benchmark_path};
+
+    // Render loop
+    while(!context.shouldClose() && !benchmark.isFinished())
+    {
+        benchmark.beginFrame(camera);
+
+        // delta_time
+        // (the time of the path when benchmarking, so the frames are the same)
+        float current_frame_time = benchmark.isEnabled() ? benchmark.getTime() : context.getTime();
+        delta_time = current_frame_time - last_frame_time;
+        last_frame_time = current_frame_time;
+
+        if (!benchmark.isEnabled())
+        {
+            processInput(context);
+        }
+
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        // The visible set only changes when the camera moves
+        if (camera.getVersion() != culled_camera_version)
+        {
+            auto culling_start_time{std::chrono::steady_clock::now()};
+
+            culling_stats = cullSpheres(camera.getFrustum(), cube_bounds, visible_ids);
+
+            // only the visible cubes reach the instance buffer
+            const auto& transform_list{cube_transforms.getTransforms()};
+            visible_transforms.clear();
+            for (std::uint32_t id : visible_ids)
+            {
+                visible_transforms.push_back(transform_list[id]);
+            }
+            cube_instances.setInstances(visible_transforms);
+
+            std::chrono::duration<double, std::milli> culling_duration{std::chrono::steady_clock::now() - culling_start_time};
+            culling_time = culling_duration.count();
+
+            frame_uniforms.view_matrix = camera.getUpdatedViewMatrix();
+            frame_uniforms.projection_matrix = camera.getProjectionMatrix();
+            frame_uniforms.camera_pos = glm::vec4(camera.getPosition(), 1.0f);
+            frame_uniform_buffer.update(frame_uniforms);
+
+            culled_camera_version = camera.getVersion();
+        }
+
+        cube_shader.use();
+        // the light follows the camera
+        cube_shader.set(light_position_uniform, camera.getPosition());
+        cube_instances.draw();
+        benchmark.countStateChanges();
+        benchmark.countDraws();
+        benchmark.endFrame(ShaderProgram::takeFrameStats());
+
+        // report the culling once per second
+        if (!benchmark.isEnabled() && static_cast<int>(current_frame_time) != static_cast<int>(current_frame_time - delta_time))
+        {
+            std::cout << "visible: " << culling_stats.visible << ", culled: " << culling_stats.culled
+                << ", culling and upload: " << culling_time << " ms" << std::endl;
+        }
+
+        context.endFrame();
+        GLCallCounter::endFrame();
+    }
+
+    benchmark.report();
+    GLCallCounter::report();
+
+    return 0;
+}
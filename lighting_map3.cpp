@@ -1,5 +1,6 @@
 #include <vector>
 #include <iostream>
+#include <chrono>
 #include <math.h>
 
 #include "glad/glad.h"
@@ -8,10 +9,22 @@
 #include "glm/gtc/matrix_transform.hpp"
 #include "glm/gtc/type_ptr.hpp"
 
-#include "VAO2.hpp"
+#include "GLContext.hpp"
+#include "VertexArray.hpp"
+#include "InstancedMesh.hpp"
+#include "TransformSystem.hpp"
+#include "MeshOptimizer.hpp"
 #include "ShaderProgram.hpp"
 #include "Texture.hpp"
+#include "TextureLoader.hpp"
 #include "Camera.hpp"
+#include "FrameUniformBuffer.hpp"
+#include "GLExtensions.hpp"
+#include "ProgramBinaryCache.hpp"
+#include "CameraPath.hpp"
+#include "FrameBenchmark.hpp"
+#include "GLCallCounter.hpp"
+#include "Profiler.hpp"
 
 #include <glm/gtx/string_cast.hpp>
 
@@ -28,25 +41,25 @@ void framebufferSizeCallback(GLFWwindow* window, int width, int height)
     glViewport(0, 0, width, height);
 }
 
-void processInput(GLFWwindow *window)
+void processInput(GLContext& context)
 {
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+    if (context.isKeyPressed(GLFW_KEY_ESCAPE))
     {
-        glfwSetWindowShouldClose(window, true);
+        context.close();
     }
-    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+    if (context.isKeyPressed(GLFW_KEY_W))
     {
         camera.updatePosition(Camera::Movement::Front, delta_time);
     }
-    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+    if (context.isKeyPressed(GLFW_KEY_S))
     {
         camera.updatePosition(Camera::Movement::Back, delta_time);
     }
-    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+    if (context.isKeyPressed(GLFW_KEY_A))
     {
         camera.updatePosition(Camera::Movement::Left, delta_time);
     }
-    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+    if (context.isKeyPressed(GLFW_KEY_D))
     {
         camera.updatePosition(Camera::Movement::Right, delta_time);
     }
@@ -64,32 +77,55 @@ void printNVertexAttribute()
     std::cout << "Maximum nr of vertex attributes supported: " << nVertexAttributes << std::endl;
 }
 
-int main()
+int main(int argc, char* argv[])
 {
-    glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-    //glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-
-    GLFWwindow* window = glfwCreateWindow(800, 600, "LearnOpenGL", NULL, NULL);
-    if (window == NULL)
+    // a window, or offscreen with --headless N_frames
+    GLContext context{GLContextOptions::fromCommandLine(argc, argv)};
+    if (!context.isValid())
     {
-        std::cout << "Failed to create GLFW window" << std::endl;
-        glfwTerminate();
         return -1;
     }
-    glfwMakeContextCurrent(window);
+    // entry points beyond OpenGL 3.3 (program binaries, ...)
+    if (!loadGLExtensions(context.getProcAddressLoader()))
+    {
+        // the features whose entry points are missing use their OpenGL 3.3 path
+        std::cout << "ERROR::GL_EXTENSIONS::NOT_LOADED: falling back to OpenGL 3.3" << std::endl;
+    }
 
-    // Glad: load all OpenGL function pointers
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    // --count-gl-calls: every GL call is counted, by function and by
+    // category, and the histograms are printed at the end (see GLCallCounter)
+    if (GLCallCounter::isRequested(argc, argv))
     {
-        std::cout << "Failed to initialize GLAD" << std::endl;
-        return -1;
+        GLCallCounter::install();
+    }
+
+    // let the driver use as many threads as it wants to build the programs
+    if (GLAD_GL_KHR_parallel_shader_compile)
+    {
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
     }
 
-    auto diffuse_map{Texture{"./textures/container2.png", GL_RGBA}};
-    auto specular_map{Texture{"./textures/container2_specular.png", GL_RGBA}};
+    // Linked programs are cached on disk: only the first run (or the first
+    // after a shader or driver change) compiles them
+    // TODO: harcoded relative path
+    ProgramBinaryCache program_binary_cache{"./shader_cache"};
+    ShaderProgram::setBinaryCache(&program_binary_cache);
+    auto shaders_start_time{std::chrono::steady_clock::now()};
+
+    // Submit all the programs first, they are built while we load
+    // the textures and the meshes, and checked at first use
+    // TODO: harcoded relative path
+    auto lighting_cube_shader{ShaderProgram{"./shaders/lighting_map_instanced_vtx.glsl", "./shaders/lighting_map_3_frag.glsl", ShaderProgram::Build::Deferred}};
+    auto lighting_cube_shader_id{lighting_cube_shader.id};
+
+    auto lighting_source_shader{ShaderProgram{"./shaders/lighting_cube_2_vtx.glsl", "./shaders/lighting_source_1_frag.glsl", ShaderProgram::Build::Deferred}};
+    auto lighting_source_shader_id{lighting_source_shader.id};
+
+    // The images are decoded by worker threads, and uploaded by the render
+    // loop when they are ready: the first frames can be drawn without them
+    TextureLoader texture_loader{2};
+    auto diffuse_map{texture_loader.load("./textures/container2.png", GL_RGBA)};
+    auto specular_map{texture_loader.load("./textures/container2_specular.png", GL_RGBA)};
 
     // First two parametres set the location of the lower left corner
     // of the window.
@@ -99,9 +135,9 @@ int main()
     // to coordinate on the window. eg (-0.5, 0.5) => (200, 450)
     glViewport(0, 0, 800, 600);
 
-    glfwSetFramebufferSizeCallback(window, framebufferSizeCallback);
-    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-    glfwSetCursorPosCallback(window, mouseCallback);
+    context.setFramebufferSizeCallback(framebufferSizeCallback);
+    context.captureCursor();
+    context.setCursorPosCallback(mouseCallback);
 
     // OpenGL stores all its depth inforamtion in z-buffer
     // glfw creates this buffer automatically for us (same as color buffer for the colors
@@ -114,7 +150,8 @@ int main()
     glEnable(GL_DEPTH_TEST);
 
     // vertices in normalized device coordinates (visible region of OpenGL)
-    // We don't use EBO here, because of the texture coordinates (see world_coo2 result in this case)
+    // 36 corners (6 per face), welded into an indexed mesh below: only the
+    // corners of a same face can be shared, the faces differ by normal and texture coordinates
     std::vector<float> cube_vertices{
         // positions          // normals           // texture coords
         -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f,  0.0f,
@@ -160,8 +197,6 @@ int main()
         -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f,  1.0f
     };
 
-    const auto N_cube_vertices{cube_vertices.size() / 8};
-
     std::vector<glm::vec3> cube_position_list{
         glm::vec3( 0.0f,  0.0f,  0.0f), 
         glm::vec3( 2.0f,  5.0f, -15.0f), 
@@ -175,113 +210,66 @@ int main()
         glm::vec3(-1.3f,  1.0f, -1.5f)
     };
 
-    // We do not use the custom and clumsy VAO2 class, has
-    // we will have issues with strides and so on ..
-
-    // Vertex Array Object
-    // It will allow to store VBO and Vertex Attribute that
-    // we will consequently declare
-    // in Core OpenGL, VAO are mandatory
-    GLuint cube_vao_id;
-    glGenVertexArrays(1, &cube_vao_id);
-    // once we bind it, all subsequent VBO and attributes
-    // will be store on the VAO referenced by this id
-    glBindVertexArray(cube_vao_id);
-
-    // Vertex Buffer Object
-    // will set up a memory on the graphic card
-    // VBO will store its buffer id
-    unsigned int cube_vbo;
-    glGenBuffers(1, &cube_vbo);
-    // sGL_ARRAY_BUFFER is the type for a vertex buffer object
-    glBindBuffer(GL_ARRAY_BUFFER, cube_vbo); 
-    // copy the vertex data into buffer memory for the currently
-    // bound buffer (VBO)
-    // the 4th parameters tells how we want the graphic card to manage the data
-    // GL_STATIC_DRAW means the data is set up once and could be used many times
-    // (so a memory region where read is fast could be good)
-    // another example is GL_DYNAMIC_DRAW, which means thata data can change a lot
-    // so it should be stored in a memory region where write (and read for usage) is fast
-    // TODO: size dangerous if refactored: a wrong size will prevent any display
-    glBufferData(GL_ARRAY_BUFFER, cube_vertices.size() * sizeof(float), cube_vertices.data(), GL_STATIC_DRAW);
-
-    // Now we have to have to tell OpenGL how to interpret the raw data
-    // vertices
-    glVertexAttribPointer(
-        0, // location of the vertex attribute, will be used in vertex shader with layout (location = 0)
-        3, // vertex attribute is a vec3, 3 elements
-        GL_FLOAT, // element of the vec3 is float
-        GL_FALSE, // don't normalize data
-        8 * sizeof(float), // size of a stride is 8 float elements
-        (void*)0 // offset is 0
-    );
-    // normals
-    glVertexAttribPointer(
-        1, // location of the normal attribute, will be used in vertex shader with layout (location = 1)
-        3, // normal attribute is a vec3, 3 elements
-        GL_FLOAT, // element of the vec3 is float
-        GL_FALSE, // don't normalize data
-        8 * sizeof(float), // size of a stride is 8 float elements
-        (void*)(3 * sizeof(float)) // offset
-    );
-
-    // textures
-    glVertexAttribPointer(
-        2, // location of the vertex attribute, will be used in vertex shader with layout (location = 2)
-        2, // textures attribute is a vec2, 2 elements
-        GL_FLOAT, // element of the vec3 is float
-        GL_FALSE, // don't normalize data
-        8 * sizeof(float), // size of a stride is 8 float elements
-        (void*)(6 * sizeof(float)) // offset
-    );
-
-    // vertex attributes are disabled by default, so enable the one we created
-    glEnableVertexAttribArray(0);
-    glEnableVertexAttribArray(1);
-    glEnableVertexAttribArray(2);
-
+    // The vertex buffer is packed from the float array above:
+    // positions stay in floats, normals are stored in 10 bits per component
+    // and texture coordinates in half floats, 20 bytes per vertex instead of 32
+    // Locations 0, 1, 2 are given in the order of the attributes
+    // The corners shared by two triangles of a face are welded in an index
+    // buffer (the corners of different faces differ by normal and texture)
+    // and the triangles are ordered to reuse the transformed vertices
+    IndexedMesh cube_mesh{weldVertices(cube_vertices, 8)};
+    const float welded_acmr{computeACMR(cube_mesh.indices)};
+    optimizeVertexCache(cube_mesh);
+    optimizeVertexFetch(cube_mesh);
+    // glDrawArrays transforms every vertex: ACMR of 3
+    std::cout << "Cube: " << cube_vertices.size() / 8 << " -> " << cube_mesh.countVertices() << " vertices, ACMR 3 -> "
+        << welded_acmr << " welded -> " << computeACMR(cube_mesh.indices) << " optimized" << std::endl;
+
+    using CubeLayout = VertexLayout<AttribFloat3, AttribSnorm10, AttribHalf2>;
+    VertexArray cube_vertex_array{VertexArray::create<CubeLayout>(cube_mesh.vertices, cube_mesh.indices)};
 
     // We prepare another VAO has the light source will be always the same
     // but the cube will be enhanced (textures, ...)
-    // Vertex Array Object
-    // It will allow to store VBO and Vertex Attribute that
-    // we will consequently declare
-    // in Core OpenGL, VAO are mandatory
-    GLuint light_source_vao_id;
-    glGenVertexArrays(1, &light_source_vao_id);
-    // once we bind it, all subsequent VBO and attributes
-    // will be store on the VAO referenced by this id
-    glBindVertexArray(light_source_vao_id);
-    // We re-use the cube VBO, as it has already been loaded in GPU memory
-    glBindBuffer(GL_ARRAY_BUFFER, cube_vbo);
-    // Now we have to have to tell OpenGL how to interpret the raw data
-    // vertices
-    glVertexAttribPointer(
-        0, // location of the vertex attribute, will be used in vertex shader with layout (location = 0)
-        3, // vertex attribue is a vec3, 3 elements
-        GL_FLOAT, // element of the vec3 is float
-        GL_FALSE, // don't normalize data
-        8 * sizeof(float), // size of a stride is 6 float elements
-        (void*)0 // offset is 0
-    );
-    // vertex attributes are disabled by default, so enable the one we created
-    glEnableVertexAttribArray(0);
+    // It re-uses the cube VBO, as it has already been loaded in GPU memory,
+    // but only reads the positions
+    using LightSourceLayout = VertexLayout<AttribFloat3, AttribUnused<AttribSnorm10>, AttribUnused<AttribHalf2>>;
+    VertexArray light_source_vertex_array{cube_vertex_array.share<LightSourceLayout>()};
+
+    // The cubes do not move: their model and normal matrices are computed
+    // once and stored in an instance buffer, read by the vertex shader from
+    // location 3, instead of being uploaded as uniforms before each draw
+    // TransformSystem computes them from the position and rotation of each
+    // cube (and would only compute again the cubes moved with setPosition, ...)
+    TransformSystem cube_transforms{};
+    for (std::size_t i = 0; i < cube_position_list.size(); i++) {
+        float angle{20.0f * i};
+        cube_transforms.add(
+            cube_position_list[i],
+            glm::angleAxis(glm::radians(angle), glm::normalize(glm::vec3(1.0f, 0.3f, 0.5f)))
+        );
+    }
+    cube_transforms.update();
 
-    // TODO: harcoded relative path
-    auto lighting_cube_shader{ShaderProgram{"./shaders/lighting_map_1_vtx.glsl", "./shaders/lighting_map_2_frag.glsl"}};
-    auto lighting_cube_shader_id{lighting_cube_shader.id};
+    InstancedMesh cube_instances{cube_vertex_array, 3};
+    cube_instances.setInstances(cube_transforms.getTransforms());
 
-    auto lighting_source_shader{ShaderProgram{"./shaders/lighting_cube_1_vtx.glsl", "./shaders/lighting_source_1_frag.glsl"}};
-    auto lighting_source_shader_id{lighting_source_shader.id};
+    // view, projection and camera position are the same for all the programs:
+    // they are written once per frame in a uniform buffer read by both
+    // (attaching the programs waits for the end of their build)
+    FrameUniformBuffer frame_uniform_buffer{};
+    frame_uniform_buffer.attach(lighting_cube_shader);
+    frame_uniform_buffer.attach(lighting_source_shader);
+
+    std::chrono::duration<double, std::milli> shaders_duration{std::chrono::steady_clock::now() - shaders_start_time};
+    std::cout << "Shader programs ready in " << shaders_duration.count() << " ms ("
+        << (program_binary_cache.misses == 0 ? "warm" : "cold") << " start, "
+        << program_binary_cache.hits << " from the binary cache, "
+        << program_binary_cache.misses << " compiled)" << std::endl;
 
     // Projection matrix
-    // we want a standard perspective
-    glm::mat4 projection_matrix{};
-    // glm::perspective creates a 'frustrum' that define visible space
-    // each coordinate inside this box will be mapped to a point in the clip space
-    // the others not (they will be 'clipped')
-    projection_matrix = glm::perspective(
-        glm::radians(45.0f), // field of view
+    // we want a standard perspective, the camera keeps it with the view
+    camera.setPerspective(
+        45.0f, // field of view
         800.0f / 600.0f, // aspect ratio, dividing the viewport width by its height
         0.1f, // near distance
         100.0f // far distance
@@ -306,15 +294,19 @@ int main()
     lighting_cube_shader.setInt("material.specular", 1);
     lighting_cube_shader.setFloat("material.shininess", 32.0f);
 
-    const std::string model_matrix_uniform_name{"model_matrix"};
-    const std::string view_matrix_uniform_name{"view_matrix"};
-
-    // The projection matrix value does not change per frame, so we can set its value here
-    lighting_cube_shader.setMat4("projection_matrix", projection_matrix);
+    // Resolve once the uniforms set in the render loop, so setting them
+    // does not need any name lookup (nor std::string construction)
+    auto light_ambient_uniform{lighting_cube_shader.getUniform<glm::vec3>("light.ambient")};
+    auto light_diffuse_uniform{lighting_cube_shader.getUniform<glm::vec3>("light.diffuse")};
+    auto light_specular_uniform{lighting_cube_shader.getUniform<glm::vec3>("light.specular")};
+    auto light_position_uniform{lighting_cube_shader.getUniform<glm::vec3>("light.position")};
+    auto source_model_matrix_uniform{lighting_source_shader.getUniform<glm::mat4>("model_matrix")};
+    auto source_light_color_uniform{lighting_source_shader.getUniform<glm::vec3>("light_color")};
 
-    // activate the light source shader and set the uniforms
-    lighting_source_shader.use();
-    lighting_source_shader.setMat4("projection_matrix", projection_matrix);
+    FrameUniforms frame_uniforms{};
+    // version of the camera written in the frame uniform buffer
+    // (0 is never a camera version, so the first frame uploads)
+    std::uint64_t uploaded_camera_version{0};
 
     // constant part of light source
     glm::mat4 light_source_model_matrix{glm::mat4(1.0f)};
@@ -322,15 +314,43 @@ int main()
     light_source_model_matrix = glm::translate(light_source_model_matrix, light_source_position);
     light_source_model_matrix = glm::scale(light_source_model_matrix, glm::vec3(0.2f));
 
+    // With --benchmark N_frames, the camera turns around the cubes and
+    // looks at them from below then from above, at the same time step in
+    // each run, and the frames are measured (see FrameBenchmark)
+    CameraPath benchmark_path{{
+        {0.0f, glm::vec3(0.0f, 0.0f, 3.0f), -90.0f, 0.0f},
+        {4.0f, glm::vec3(6.0f, -2.0f, -4.0f), -180.0f, 10.0f},
+        {8.0f, glm::vec3(0.0f, 3.0f, -14.0f), -270.0f, -10.0f},
+        {12.0f, glm::vec3(-6.0f, 1.0f, -4.0f), -360.0f, -5.0f},
+        {16.0f, glm::vec3(0.0f, 0.0f, 3.0f), -450.0f, 0.0f}
+    }};
+    FrameBenchmark benchmark{FrameBenchmarkOptions::fromCommandLine(argc, argv, "lighting_map3"), benchmark_path};
+
+    // With --profile trace.json, the CPU and GPU times of the passes below
+    // are written in a Chrome trace (see Profiler)
+    Profiler profiler{ProfilerOptions::fromCommandLine(argc, argv)};
+
     // Render loop
-    while(!glfwWindowShouldClose(window))
+    while(!context.shouldClose() && !benchmark.isFinished())
     {
+        benchmark.beginFrame(camera);
+
         // delta_time
-        float current_frame_time = glfwGetTime();
+        // (the time of the path when benchmarking, so the frames are the same)
+        float current_frame_time = benchmark.isEnabled() ? benchmark.getTime() : context.getTime();
         delta_time = current_frame_time - last_frame_time;
         last_frame_time = current_frame_time;
 
-        processInput(window);
+        if (!benchmark.isEnabled())
+        {
+            processInput(context);
+        }
+
+        // upload the textures decoded since the last frame
+        {
+            PROFILE_SCOPE("texture uploads");
+            texture_loader.update();
+        }
 
         // rendering commands here
         // state-setting function
@@ -340,92 +360,91 @@ int main()
         // clear the previous frame z-buffer
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        // View matrix
-        // transform from world coordinate to 'camera' coordinates
-        auto& view_matrix = camera.getUpdatedViewMatrix();
-
-        // We will use the world coordinates for all the lighting
-        // calculations, including specular lighting.
-        // Most of the people use the view coordinates, because the camera
-        // position there is always (0, 0, 0)
-        auto& camera_position = camera.getPosition();
-
-        // send the view_matrix to the shaders with the camera position updated
-        lighting_cube_shader.use();
-        lighting_cube_shader.setMat4(view_matrix_uniform_name, view_matrix);
-        lighting_source_shader.use();
-        lighting_source_shader.setMat4(view_matrix_uniform_name, view_matrix);
-
-        glm::vec3 light_color;
-        light_color.x = sin(glfwGetTime() * 2.0f);
-        light_color.y = sin(glfwGetTime() * 0.7f);
-        light_color.z = sin(glfwGetTime() * 1.3f);
-
-        lighting_source_shader.use();
-        lighting_source_shader.setVec3("light_color", light_color);
-        lighting_source_shader.setMat4(model_matrix_uniform_name, light_source_model_matrix);
-
-        // render the light source
-        glBindVertexArray(light_source_vao_id);
-        glDrawArrays(
-            GL_TRIANGLES,  // we want to draw triangles
-            0,
-            N_cube_vertices  // we want this number of vertices in total
-        );
+        {
+            PROFILE_SCOPE("frame uniforms");
+            // The view and the camera position only change when the camera
+            // moves: the frame uniform buffer is not written again otherwise
+            if (camera.getVersion() != uploaded_camera_version)
+            {
+                // View matrix
+                // transform from world coordinate to 'camera' coordinates
+                auto& view_matrix = camera.getUpdatedViewMatrix();
+
+                // We will use the world coordinates for all the lighting
+                // calculations, including specular lighting.
+                // Most of the people use the view coordinates, because the camera
+                // position there is always (0, 0, 0)
+                auto& camera_position = camera.getPosition();
+
+                // send the view_matrix and the camera position to all the shaders at once
+                frame_uniforms.view_matrix = view_matrix;
+                frame_uniforms.projection_matrix = camera.getProjectionMatrix();
+                frame_uniforms.camera_pos = glm::vec4(camera_position, 1.0f);
+                frame_uniform_buffer.update(frame_uniforms);
+                uploaded_camera_version = camera.getVersion();
+            }
+        }
+
+        // the light source then the cubes, nested in the scene in the profile
+        {
+            PROFILE_SCOPE("scene");
+
+            glm::vec3 light_color;
+            light_color.x = sin(current_frame_time * 2.0f);
+            light_color.y = sin(current_frame_time * 0.7f);
+            light_color.z = sin(current_frame_time * 1.3f);
+
+            {
+                PROFILE_SCOPE("light source");
+                lighting_source_shader.use();
+                lighting_source_shader.set(source_light_color_uniform, light_color);
+                lighting_source_shader.set(source_model_matrix_uniform, light_source_model_matrix);
+
+                // render the light source
+                light_source_vertex_array.bind();
+                light_source_vertex_array.draw();
+                benchmark.countStateChanges();
+                benchmark.countDraws();
+            }
+
+            {
+                PROFILE_SCOPE("cubes");
+                lighting_cube_shader.use();
+                lighting_cube_shader.set(light_ambient_uniform, (0.2f * light_color));
+                // darken diffuse light a bit
+                lighting_cube_shader.set(light_diffuse_uniform, (0.5f * light_color));
+                // lighting_cube_shader.setVec3("light.specular", glm::vec3(1.0f, 1.0f, 1.0f));
+                lighting_cube_shader.set(light_specular_uniform, light_color);
+
+                lighting_cube_shader.set(light_position_uniform, light_source_position);
+
+                // render all the cubes at once, each instance reads its
+                // model and normal matrices from the instance buffer
+                cube_instances.draw();
+                benchmark.countStateChanges();
+                benchmark.countDraws();
+            }
+        }
 
-        lighting_cube_shader.use();
-        lighting_cube_shader.setVec3("light.ambient", (0.2f * light_color));
-        // darken diffuse light a bit
-        lighting_cube_shader.setVec3("light.diffuse", (0.5f * light_color));
-        // lighting_cube_shader.setVec3("light.specular", glm::vec3(1.0f, 1.0f, 1.0f));
-        lighting_cube_shader.setVec3("light.specular", light_color);
-
-        std::size_t Ncube{cube_position_list.size()};
-
-        for (std::size_t i = 0; i < Ncube; i++) {
-            // Model matrix
-            // Used to transform local (object coordinates) to world coordinates
-            // always start with identity
-            glm::mat4 cube_model_matrix{glm::mat4(1.0f)};
-            cube_model_matrix = glm::translate(cube_model_matrix, cube_position_list[i]);
-            float angle{20.0f * i}; 
-            cube_model_matrix = glm::rotate(cube_model_matrix, glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
-
-            // Normal matrix
-            // special matrix for normal vectors
-            // it allow the normal to stay perpendicular
-            // if the model is not scaled in a uniform maner
-            // as inversion is pretty costly, and to avoid to
-            // be computed for every vertex it should not be in
-            // the shaders
-            glm::mat3 cube_normal_matrix = glm::mat3(glm::transpose(glm::inverse(cube_model_matrix)));
-
-            // std::cout << glm::to_string(cube_model_matrix) << std::endl;
-            // std::cout << glm::to_string(cube_normal_matrix) << std::endl;
-            // std::cout << glm::to_string(camera_position) << std::endl;
-
-            // set the model in the shaders
-            lighting_cube_shader.use();
-            lighting_cube_shader.setMat4(model_matrix_uniform_name, cube_model_matrix);
-            lighting_cube_shader.setMat3("normal_matrix", cube_normal_matrix);
-            lighting_cube_shader.setVec3("light.position", light_source_position);
-            lighting_cube_shader.setVec3("camera_pos", camera_position);
-
-            // render the cube
-            glBindVertexArray(cube_vao_id);
-            glDrawArrays(
-                GL_TRIANGLES,  // we want to draw triangles
-                0,
-                N_cube_vertices  // we want this number of vertices in total
-            );
+        // ShaderProgram skips glUseProgram and glUniform* calls when
+        // nothing changed, report how many were skipped once per second
+        auto shader_stats{ShaderProgram::takeFrameStats()};
+        benchmark.endFrame(shader_stats);
+        if (!benchmark.isEnabled() && static_cast<int>(current_frame_time) != static_cast<int>(current_frame_time - delta_time))
+        {
+            std::cout << "glUseProgram: " << shader_stats.use_calls << " issued, "
+                << shader_stats.use_elided << " elided | glUniform: "
+                << shader_stats.uniform_calls << " issued, "
+                << shader_stats.uniform_elided << " elided" << std::endl;
         }
 
-        // swap buffer and poll IO events
-        glfwSwapBuffers(window);
-        glfwPollEvents();    
+        PROFILE_END_FRAME();
+        context.endFrame();
+        GLCallCounter::endFrame();
     }
 
-    glfwTerminate();
+    benchmark.report();
+    GLCallCounter::report();
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,296 @@
+#include <vector>
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <math.h>
+
+#include "glad/glad.h"
+#include "GLFW/glfw3.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/type_ptr.hpp"
+
+#include "GLContext.hpp"
+#include "ShaderProgram.hpp"
+#include "Texture.hpp"
+#include "Camera.hpp"
+#include "FrameUniformBuffer.hpp"
+#include "VertexArray.hpp"
+#include "InstancedMesh.hpp"
+#include "MeshOptimizer.hpp"
+#include "PrimitiveMeshes.hpp"
+#include "TransformSystem.hpp"
+#include "FrustumCulling.hpp"
+#include "BoundingVolumeHierarchy.hpp"
+#include "OcclusionBuffer.hpp"
+#include "CameraPath.hpp"
+#include "FrameBenchmark.hpp"
+#include "GLCallCounter.hpp"
+
+// Global variables
+// delta_time
+float delta_time = 0.0f;	// Time between current frame and last frame
+float last_frame_time = 0.0f; // Time of last frame
+
+// Camera global object
+Camera camera{};
+
+void framebufferSizeCallback(GLFWwindow* window, int width, int height)
+{
+    glViewport(0, 0, width, height);
+}
+
+void processInput(GLContext& context)
+{
+    if (context.isKeyPressed(GLFW_KEY_ESCAPE))
+    {
+        context.close();
+    }
+    if (context.isKeyPressed(GLFW_KEY_W))
+    {
+        camera.updatePosition(Camera::Movement::Front, delta_time);
+    }
+    if (context.isKeyPressed(GLFW_KEY_S))
+    {
+        camera.updatePosition(Camera::Movement::Back, delta_time);
+    }
+    if (context.isKeyPressed(GLFW_KEY_A))
+    {
+        camera.updatePosition(Camera::Movement::Left, delta_time);
+    }
+    if (context.isKeyPressed(GLFW_KEY_D))
+    {
+        camera.updatePosition(Camera::Movement::Right, delta_time);
+    }
+}
+
+void mouseCallback(GLFWwindow* window, double x_pos, double y_pos) {
+    camera.updateOrientation(x_pos, y_pos);
+}
+
+int main(int argc, char* argv[])
+{
+    // a window, or offscreen with --headless N_frames
+    GLContext context{GLContextOptions::fromCommandLine(argc, argv)};
+    if (!context.isValid())
+    {
+        return -1;
+    }
+
+    // --count-gl-calls: every GL call is counted, by function and by
+    // category, and the histograms are printed at the end (see GLCallCounter)
+    if (GLCallCounter::isRequested(argc, argv))
+    {
+        GLCallCounter::install();
+    }
+
+    glViewport(0, 0, 800, 600);
+
+    context.setFramebufferSizeCallback(framebufferSizeCallback);
+    context.captureCursor();
+    context.setCursorPosCallback(mouseCallback);
+
+    glEnable(GL_DEPTH_TEST);
+
+    // 200k cubes packed around the camera: from any point of view,
+    // most of the cubes in the frustum are hidden by the nearest ones
+    const std::size_t N_cubes{200000};
+    const float scene_half_size{50.0f};
+    // the N_occluders nearest cubes in the frustum are the occluders
+    const std::size_t N_occluders{512};
+
+    std::mt19937 generator{42};
+    std::uniform_real_distribution<float> position_distribution{-scene_half_size, scene_half_size};
+    std::uniform_real_distribution<float> unit_distribution{-1.0f, 1.0f};
+
+    TransformSystem cube_transforms{};
+    cube_transforms.reserve(N_cubes);
+    // a unit cube fits in a sphere of radius sqrt(3) / 2, whatever its rotation,
+    // and in the box of the same half extent
+    const float cube_radius{0.5f * sqrtf(3.0f)};
+    BoundingSpheres cube_spheres{};
+    cube_spheres.reserve(N_cubes);
+    std::vector<Aabb> cube_boxes{};
+    cube_boxes.reserve(N_cubes);
+    std::vector<glm::vec3> cube_position_list{};
+    cube_position_list.reserve(N_cubes);
+
+    while (cube_position_list.size() < N_cubes)
+    {
+        const glm::vec3 position{position_distribution(generator), position_distribution(generator), position_distribution(generator)};
+        // keep some room around the camera
+        if (glm::length(position - camera.getPosition()) < 4.0f)
+        {
+            continue;
+        }
+        const glm::quat rotation{glm::normalize(glm::quat(unit_distribution(generator), unit_distribution(generator), unit_distribution(generator), unit_distribution(generator)))};
+        cube_transforms.add(position, rotation);
+        cube_spheres.add(position, cube_radius);
+        cube_boxes.push_back(Aabb::fromCenter(position, glm::vec3(cube_radius)));
+        cube_position_list.push_back(position);
+    }
+    // the cubes do not move, their matrices are computed once
+    cube_transforms.update();
+
+    // the occluders are rasterized with the cube of the examples
+    const OccluderMesh cube_occluder{makeOccluderMesh(makeCubeVertices(), 8)};
+    OcclusionBuffer occlusion_buffer{256, 192};
+
+    IndexedMesh cube_mesh{weldVertices(makeCubeVertices(), 8)};
+    optimizeVertexCache(cube_mesh);
+    optimizeVertexFetch(cube_mesh);
+    using CubeLayout = VertexLayout<AttribFloat3, AttribSnorm10, AttribHalf2>;
+    InstancedMesh cube_instances{VertexArray::create<CubeLayout>(cube_mesh.vertices, cube_mesh.indices), 3};
+
+    // TODO: harcoded relative path
+    auto cube_shader{ShaderProgram{"./shaders/lighting_map_instanced_vtx.glsl", "./shaders/lighting_map_3_frag.glsl"}};
+
+    FrameUniformBuffer frame_uniform_buffer{};
+    frame_uniform_buffer.attach(cube_shader);
+
+    Texture diffuse_map{"./textures/container2.png", GL_RGBA};
+    Texture specular_map{"./textures/container2_specular.png", GL_RGBA};
+    glActiveTexture(GL_TEXTURE0);
+    diffuse_map.bind();
+    glActiveTexture(GL_TEXTURE1);
+    specular_map.bind();
+
+    cube_shader.use();
+    cube_shader.setInt("material.diffuse", 0);
+    cube_shader.setInt("material.specular", 1);
+    cube_shader.setFloat("material.shininess", 32.0f);
+    cube_shader.setVec3("light.ambient", glm::vec3(0.2f));
+    cube_shader.setVec3("light.diffuse", glm::vec3(0.5f));
+    cube_shader.setVec3("light.specular", glm::vec3(1.0f));
+    auto light_position_uniform{cube_shader.getUniform<glm::vec3>("light.position")};
+
+    // the frustum of the camera is built with this projection
+    camera.setPerspective(45.0f, 800.0f / 600.0f, 0.1f, 100.0f);
+
+    FrameUniforms frame_uniforms{};
+    std::uint64_t culled_camera_version{0};
+    std::vector<std::uint32_t> frustum_visible_ids{};
+    std::vector<InstanceTransform> visible_transforms{};
+    CullingStats frustum_stats{};
+    std::size_t n_occluded{0};
+    double rasterizer_time{0.0};
+    double test_time{0.0};
+
+    // With --benchmark N_frames, the camera turns around on itself while
+    // moving on a small circle, at the same time step in each run, and the
+    // frames are measured (see FrameBenchmark)
+    CameraPath benchmark_path{{
+        {0.0f, glm::vec3(0.0f, 0.0f, 3.0f), -90.0f, 0.0f},
+        {4.0f, glm::vec3(1.5f, 0.0f, 1.5f), -180.0f, 20.0f},
+        {8.0f, glm::vec3(0.0f, 0.0f, 0.0f), -270.0f, -20.0f},
+        {12.0f, glm::vec3(-1.5f, 0.0f, 1.5f), -360.0f, 10.0f},
+        {16.0f, glm::vec3(0.0f, 0.0f, 3.0f), -450.0f, 0.0f}
+    }};
+    FrameBenchmark benchmark{FrameBenchmarkOptions::fromCommandLine(argc, argv, "occlusion_culling1"), benchmark_path};
+
+    // Render loop
+    while(!context.shouldClose() && !benchmark.isFinished())
+    {
+        benchmark.beginFrame(camera);
+
+        // delta_time
+        // (the time of the path when benchmarking, so the frames are the same)
+        float current_frame_time = benchmark.isEnabled() ? benchmark.getTime() : context.getTime();
+        delta_time = current_frame_time - last_frame_time;
+        last_frame_time = current_frame_time;
+
+        if (!benchmark.isEnabled())
+        {
+            processInput(context);
+        }
+
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        // The visible set only changes when the camera moves
+        if (camera.getVersion() != culled_camera_version)
+        {
+            frustum_stats = cullSpheres(camera.getFrustum(), cube_spheres, frustum_visible_ids);
+
+            // occluders: the nearest cubes in the frustum, they hide the most
+            const glm::vec3 camera_position{camera.getPosition()};
+            const std::size_t n_occluders{std::min(N_occluders, frustum_visible_ids.size())};
+            std::nth_element(
+                frustum_visible_ids.begin(),
+                frustum_visible_ids.begin() + n_occluders,
+                frustum_visible_ids.end(),
+                [&](std::uint32_t a, std::uint32_t b) {
+                    const glm::vec3 to_a{cube_position_list[a] - camera_position};
+                    const glm::vec3 to_b{cube_position_list[b] - camera_position};
+                    return glm::dot(to_a, to_a) < glm::dot(to_b, to_b);
+                }
+            );
+
+            const auto& transform_list{cube_transforms.getTransforms()};
+            auto rasterizer_start_time{std::chrono::steady_clock::now()};
+            occlusion_buffer.clear(camera.getViewProjectionMatrix());
+            for (std::size_t i = 0; i < n_occluders; i++)
+            {
+                occlusion_buffer.addOccluder(cube_occluder, transform_list[frustum_visible_ids[i]].model_matrix);
+            }
+            occlusion_buffer.buildHiZ();
+            std::chrono::duration<double, std::milli> rasterizer_duration{std::chrono::steady_clock::now() - rasterizer_start_time};
+            rasterizer_time = rasterizer_duration.count();
+
+            // the occluders are drawn, the other cubes only if they are not hidden
+            auto test_start_time{std::chrono::steady_clock::now()};
+            visible_transforms.clear();
+            n_occluded = 0;
+            for (std::size_t i = 0; i < frustum_visible_ids.size(); i++)
+            {
+                const std::uint32_t id{frustum_visible_ids[i]};
+                if (i < n_occluders || occlusion_buffer.isVisible(cube_boxes[id]))
+                {
+                    visible_transforms.push_back(transform_list[id]);
+                }
+                else
+                {
+                    n_occluded++;
+                }
+            }
+            std::chrono::duration<double, std::milli> test_duration{std::chrono::steady_clock::now() - test_start_time};
+            test_time = test_duration.count();
+
+            cube_instances.setInstances(visible_transforms);
+
+            frame_uniforms.view_matrix = camera.getUpdatedViewMatrix();
+            frame_uniforms.projection_matrix = camera.getProjectionMatrix();
+            frame_uniforms.camera_pos = glm::vec4(camera.getPosition(), 1.0f);
+            frame_uniform_buffer.update(frame_uniforms);
+
+            culled_camera_version = camera.getVersion();
+        }
+
+        cube_shader.use();
+        // the light follows the camera
+        cube_shader.set(light_position_uniform, camera.getPosition());
+        cube_instances.draw();
+        benchmark.countStateChanges();
+        benchmark.countDraws();
+        benchmark.endFrame(ShaderProgram::takeFrameStats());
+
+        // report the culling once per second
+        if (!benchmark.isEnabled() && static_cast<int>(current_frame_time) != static_cast<int>(current_frame_time - delta_time))
+        {
+            std::cout << "in frustum: " << frustum_stats.visible
+                << ", occluded: " << n_occluded << " (" << 100.0 * n_occluded / std::max<std::size_t>(frustum_stats.visible, 1) << "%)"
+                << ", drawn: " << visible_transforms.size() << std::endl;
+            std::cout << "  rasterizer: " << rasterizer_time << " ms (" << occlusion_buffer.getTriangleCount() << " triangles)"
+                << ", occlusion tests: " << test_time << " ms" << std::endl;
+        }
+
+        context.endFrame();
+        GLCallCounter::endFrame();
+    }
+
+    benchmark.report();
+    GLCallCounter::report();
+
+    return 0;
+}
@@ -0,0 +1,31 @@
+#version 330 core
+
+in vec2 text_coord;
+
+out vec4 frag_color;
+
+uniform sampler2D source;
+// one texel of the source along the blur direction:
+// (1 / width, 0) horizontally, (0, 1 / height) vertically
+uniform vec2 texel_step;
+// only what is brighter than this glows (0 to keep everything)
+uniform float threshold;
+
+// 9 taps gaussian, the weights add up to 1
+const float weights[5] = float[](0.227027, 0.1945946, 0.1216216, 0.054054, 0.016216);
+
+vec3 bright(vec2 coord)
+{
+  return max(texture(source, coord).rgb - vec3(threshold), vec3(0.0));
+}
+
+void main()
+{
+  vec3 color = bright(text_coord) * weights[0];
+  for (int i = 1; i < 5; i++)
+  {
+    color += bright(text_coord + i * texel_step) * weights[i];
+    color += bright(text_coord - i * texel_step) * weights[i];
+  }
+  frag_color = vec4(color, 1.0);
+};
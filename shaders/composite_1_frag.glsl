@@ -0,0 +1,19 @@
+#version 330 core
+
+in vec2 text_coord;
+
+out vec4 frag_color;
+
+uniform sampler2D scene;
+uniform sampler2D glow;
+uniform float glow_strength;
+
+void main()
+{
+  vec3 color = texture(scene, text_coord).rgb + glow_strength * texture(glow, text_coord).rgb;
+  // darker corners: 1 at the center, about 0.5 in the corners
+  vec2 from_center = text_coord - vec2(0.5);
+  float vignette = 1.0 - dot(from_center, from_center);
+  vignette *= vignette;
+  frag_color = vec4(color * vignette, 1.0);
+};
@@ -0,0 +1,15 @@
+#version 330 core
+
+in vec2 text_coord;
+
+out vec4 frag_color;
+
+// a depth texture is read as a float in the red channel
+uniform sampler2D depth_map;
+
+void main()
+{
+  float depth = texture(depth_map, text_coord).r;
+  // the near objects are white, the far plane black
+  frag_color = vec4(vec3(1.0 - depth), 1.0);
+};
@@ -0,0 +1,13 @@
+#version 330 core
+
+// One triangle covering the screen, without any vertex buffer:
+// the positions come from gl_VertexID (0, 1, 2), drawn with
+// glDrawArrays(GL_TRIANGLES, 0, 3) and an empty VAO bound
+out vec2 text_coord;
+
+void main()
+{
+  // (0, 0), (2, 0), (0, 2): the part outside of the screen is clipped
+  text_coord = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+  gl_Position = vec4(text_coord * 2.0 - 1.0, 0.0, 1.0);
+};
@@ -0,0 +1,31 @@
+#version 330 core
+
+layout (location = 0) in vec3 a_pos;
+layout (location = 1) in vec3 a_norm;
+layout (location = 2) in vec2 a_text_coord;
+// per instance attributes (see InstancedMesh)
+// a matrix takes one location per column: 3 to 6, then 7 to 9
+layout (location = 3) in mat4 a_model_matrix;
+layout (location = 7) in mat3 a_normal_matrix;
+
+// per frame data, written once in a uniform buffer and shared
+// by all the programs (see FrameUniformBuffer)
+layout (std140) uniform FrameUniforms {
+  mat4 view_matrix;
+  mat4 projection_matrix;
+  vec4 camera_pos;
+};
+
+out vec3 normal;
+out vec3 frag_pos;
+out vec2 text_coord;
+
+void main()
+{
+  text_coord = a_text_coord;
+  // we use the world coordinates for all the lightning calculations
+  vec4 world_pos = a_model_matrix * vec4(a_pos, 1.0);
+  frag_pos = vec3(world_pos);
+  gl_Position = projection_matrix * view_matrix * world_pos;
+  normal = a_normal_matrix * a_norm;
+};
@@ -0,0 +1,14 @@
+#version 330 core
+
+layout (location = 0) in vec3 a_pos;
+// per instance model matrix (see InstancedMesh), the normal matrix
+// at location 7 is not needed for the depth
+layout (location = 3) in mat4 a_model_matrix;
+
+// projection * view of the light: the scene as seen from the light
+uniform mat4 light_matrix;
+
+void main()
+{
+  gl_Position = light_matrix * a_model_matrix * vec4(a_pos, 1.0);
+};
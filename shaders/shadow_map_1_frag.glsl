@@ -0,0 +1,84 @@
+#version 330 core
+
+in vec3 normal;
+in vec3 frag_pos;
+in vec2 text_coord;
+
+out vec4 frag_color;
+
+// per frame data, the same block as in the vertex shader
+layout (std140) uniform FrameUniforms {
+  mat4 view_matrix;
+  mat4 projection_matrix;
+  vec4 camera_pos;
+};
+
+struct Light {
+  vec3 position;
+  vec3 ambient;
+  vec3 diffuse;
+  vec3 specular;
+};
+
+uniform Light light;
+
+struct Material {
+  sampler2D diffuse;
+  sampler2D specular;
+  float shininess;
+};
+
+uniform Material material;
+
+// depth of the scene seen from the light (see shadow_depth_1_vtx.glsl)
+uniform sampler2D shadow_map;
+uniform mat4 light_matrix;
+
+// 0 in the light, 1 in the shadow
+float computeShadow(vec3 norm, vec3 light_dir)
+{
+  // the position of the fragment in the shadow map: [-1, 1] -> [0, 1]
+  vec4 light_space_pos = light_matrix * vec4(frag_pos, 1.0);
+  vec3 shadow_coord = light_space_pos.xyz / light_space_pos.w * 0.5 + 0.5;
+  // beyond the far plane of the light: never in the shadow
+  if (shadow_coord.z > 1.0)
+  {
+    return 0.0;
+  }
+
+  // a surface facing away from the light needs a larger bias to
+  // not shadow itself (shadow acne)
+  float bias = max(0.005 * (1.0 - dot(norm, light_dir)), 0.0005);
+  // 3x3 samples around the fragment (percentage closer filtering):
+  // softer edges instead of the texels of the shadow map
+  vec2 texel_size = 1.0 / vec2(textureSize(shadow_map, 0));
+  float shadow = 0.0;
+  for (int x = -1; x <= 1; x++)
+  {
+    for (int y = -1; y <= 1; y++)
+    {
+      float closest_depth = texture(shadow_map, shadow_coord.xy + vec2(x, y) * texel_size).r;
+      shadow += shadow_coord.z - bias > closest_depth ? 1.0 : 0.0;
+    }
+  }
+  return shadow / 9.0;
+}
+
+void main()
+{
+  vec3 ambient = light.ambient * vec3(texture(material.diffuse, text_coord));
+
+  vec3 norm = normalize(normal);
+  vec3 light_dir = normalize(light.position - frag_pos);
+  float diff = max(dot(norm, light_dir), 0.);
+  vec3 diffuse = light.diffuse * (diff * vec3(texture(material.diffuse, text_coord)));
+
+  vec3 view_dir = normalize(camera_pos.xyz - frag_pos);
+  vec3 reflection_dir = reflect(-light_dir, norm);
+  float spec = pow(max(dot(view_dir, reflection_dir), 0.), material.shininess);
+  vec3 specular = light.specular * (spec * vec3(texture(material.specular, text_coord)));
+
+  // the ambient light reaches the shadows too
+  float shadow = computeShadow(norm, light_dir);
+  frag_color = vec4(ambient + (1.0 - shadow) * (diffuse + specular), 1.0);
+};
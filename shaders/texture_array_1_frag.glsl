@@ -0,0 +1,18 @@
+#version 330 core
+
+out vec4 frag_color;
+
+in vec2 text_coord;
+
+// all the materials are packed in the layers of one texture array
+// (see TextureArrayPacker)
+uniform sampler2DArray material_maps;
+// where the material is in its layer: uv offset (xy) and scale (zw)
+uniform vec4 material_rect;
+uniform float material_layer;
+
+void main()
+{
+  vec2 layer_coord = material_rect.xy + text_coord * material_rect.zw;
+  frag_color = texture(material_maps, vec3(layer_coord, material_layer));
+};
@@ -0,0 +1,23 @@
+#version 330 core
+
+layout (location = 0) in vec3 a_pos;
+layout (location = 1) in vec2 a_text_coord;
+
+// per frame data, written once in a uniform buffer and shared
+// by all the programs (see FrameUniformBuffer)
+layout (std140) uniform FrameUniforms {
+  mat4 view_matrix;
+  mat4 projection_matrix;
+  vec4 camera_pos;
+};
+
+uniform mat4 model_matrix;
+
+out vec2 text_coord;
+
+void main()
+{
+  // we read the multiplication from right to left
+  gl_Position = projection_matrix * view_matrix * model_matrix * vec4(a_pos, 1.0);
+  text_coord = a_text_coord;
+};
@@ -0,0 +1,288 @@
+#include <vector>
+#include <iostream>
+#include <math.h>
+
+#include "glad/glad.h"
+#include "GLFW/glfw3.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/type_ptr.hpp"
+
+#include "GLContext.hpp"
+#include "VAO2.hpp"
+#include "ShaderProgram.hpp"
+#include "Camera.hpp"
+#include "FrameUniformBuffer.hpp"
+#include "TextureArrayPacker.hpp"
+#include "CameraPath.hpp"
+#include "FrameBenchmark.hpp"
+#include "GLCallCounter.hpp"
+
+// Global variables
+// delta_time
+float delta_time = 0.0f;	// Time between current frame and last frame
+float last_frame_time = 0.0f; // Time of last frame
+
+// Camera global object
+Camera camera{};
+
+void framebufferSizeCallback(GLFWwindow* window, int width, int height)
+{
+    glViewport(0, 0, width, height);
+}
+
+void processInput(GLContext& context)
+{
+    if (context.isKeyPressed(GLFW_KEY_ESCAPE))
+    {
+        context.close();
+    }
+    if (context.isKeyPressed(GLFW_KEY_W))
+    {
+        camera.updatePosition(Camera::Movement::Front, delta_time);
+    }
+    if (context.isKeyPressed(GLFW_KEY_S))
+    {
+        camera.updatePosition(Camera::Movement::Back, delta_time);
+    }
+    if (context.isKeyPressed(GLFW_KEY_A))
+    {
+        camera.updatePosition(Camera::Movement::Left, delta_time);
+    }
+    if (context.isKeyPressed(GLFW_KEY_D))
+    {
+        camera.updatePosition(Camera::Movement::Right, delta_time);
+    }
+}
+
+void mouseCallback(GLFWwindow* window, double x_pos, double y_pos) {
+    camera.updateOrientation(x_pos, y_pos);
+}
+
+void printNVertexAttribute()
+{
+    int nVertexAttributes{0};
+    glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &nVertexAttributes);
+    std::cout << "Maximum nr of vertex attributes supported: " << nVertexAttributes << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    // a window, or offscreen with --headless N_frames
+    GLContext context{GLContextOptions::fromCommandLine(argc, argv)};
+    if (!context.isValid())
+    {
+        return -1;
+    }
+
+    // --count-gl-calls: every GL call is counted, by function and by
+    // category, and the histograms are printed at the end (see GLCallCounter)
+    if (GLCallCounter::isRequested(argc, argv))
+    {
+        GLCallCounter::install();
+    }
+
+    glViewport(0, 0, 800, 600);
+
+    context.setFramebufferSizeCallback(framebufferSizeCallback);
+    context.captureCursor();
+    context.setCursorPosCallback(mouseCallback);
+
+    glEnable(GL_DEPTH_TEST);
+
+    // A grid of cubes, each one with its own material
+    const int N_columns{16};
+    const int N_rows{12};
+    const int N_cubes{N_columns * N_rows};
+
+    // All the materials are packed in a single texture array:
+    // the real textures, and small generated ones to have many materials
+    TextureArrayPacker texture_array_packer{1024, 1024};
+    std::vector<std::size_t> material_list;
+
+    // TODO: harcoded relative path
+    material_list.push_back(texture_array_packer.add("./textures/container.jpg"));
+    material_list.push_back(texture_array_packer.add("./textures/awesomeface.png"));
+    material_list.push_back(texture_array_packer.add("./textures/container2.png"));
+    material_list.push_back(texture_array_packer.add("./textures/container2_specular.png"));
+
+    for (int i = static_cast<int>(material_list.size()); i < N_cubes; i++)
+    {
+        // checkerboard of 2 colors, 16 to 64 pixels wide
+        const int size{16 + (i * 7) % 49};
+        const int N_squares{2 + i % 6};
+        const glm::u8vec4 color_a(37 * i % 256, 91 * i % 256, 53 * i % 256, 255);
+        const glm::u8vec4 color_b(255 - color_a.r, 255 - color_a.g, 255 - color_a.b, 255);
+
+        std::vector<unsigned char> image(size * size * 4);
+
+        for (int y = 0; y < size; y++)
+        {
+            for (int x = 0; x < size; x++)
+            {
+                const bool is_a{((x * N_squares / size) + (y * N_squares / size)) % 2 == 0};
+                const glm::u8vec4 color{is_a ? color_a : color_b};
+                std::copy(&color[0], &color[0] + 4, image.data() + (y * size + x) * 4);
+            }
+        }
+
+        material_list.push_back(texture_array_packer.add(image.data(), size, size));
+    }
+
+    auto material_maps{texture_array_packer.build()};
+
+    std::cout << material_list.size() << " materials packed in " << material_maps.n_layers
+        << " layers: 1 texture bind per frame instead of " << N_cubes << std::endl;
+
+    // vertices in normalized device coordinates (visible region of OpenGL)
+    // We don't use EBO here, because of the texture coordinates (see world_coo2 result in this case)
+    std::vector<float> vertices{
+        // positions          // texture coords
+        -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+        0.5f, -0.5f, -0.5f,  1.0f, 0.0f,
+        0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+        0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+        -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+        -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+
+        -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+        0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+        0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+        0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+        -0.5f,  0.5f,  0.5f,  0.0f, 1.0f,
+        -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+
+        -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+        -0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+        -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+        -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+        -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+        -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+        0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+        0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+        0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+        0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+        0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+        0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+        -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+        0.5f, -0.5f, -0.5f,  1.0f, 1.0f,
+        0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+        0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+        -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+        -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+
+        -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+        0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+        0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+        0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+        -0.5f,  0.5f,  0.5f,  0.0f, 0.0f,
+        -0.5f,  0.5f, -0.5f,  0.0f, 1.0f
+    };
+
+    auto Nvertices{vertices.size() / 5};
+
+    auto vao{VAO2{vertices}};
+
+    // TODO: harcoded relative path
+    auto main_shader{ShaderProgram{"./shaders/texture_array_1_vtx.glsl", "./shaders/texture_array_1_frag.glsl"}};
+
+    FrameUniformBuffer frame_uniform_buffer{};
+    frame_uniform_buffer.attach(main_shader);
+
+    FrameUniforms frame_uniforms{};
+    frame_uniforms.projection_matrix = glm::perspective(
+        glm::radians(45.0f), // field of view
+        800.0f / 600.0f, // aspect ratio, dividing the viewport width by its height
+        0.1f, // near distance
+        100.0f // far distance
+    );
+
+    main_shader.use();
+    // the texture array is the only texture, on texture unit 0
+    main_shader.setInt("material_maps", 0);
+
+    auto model_matrix_uniform{main_shader.getUniform<glm::mat4>("model_matrix")};
+    auto material_rect_uniform{main_shader.getUniform<glm::vec4>("material_rect")};
+    auto material_layer_uniform{main_shader.getUniform<float>("material_layer")};
+
+    // With --benchmark N_frames, the camera moves in front of the wall of
+    // cubes, at the same time step in each run, and the frames are measured
+    // (see FrameBenchmark)
+    CameraPath benchmark_path{{
+        {0.0f, glm::vec3(0.0f, 0.0f, 3.0f), -90.0f, 0.0f},
+        {4.0f, glm::vec3(-6.0f, 3.0f, -8.0f), -70.0f, -10.0f},
+        {8.0f, glm::vec3(6.0f, -3.0f, -10.0f), -110.0f, 10.0f},
+        {12.0f, glm::vec3(0.0f, 0.0f, 3.0f), -90.0f, 0.0f}
+    }};
+    FrameBenchmark benchmark{FrameBenchmarkOptions::fromCommandLine(argc, argv, "texture_array1"), benchmark_path};
+
+    // Render loop
+    while(!context.shouldClose() && !benchmark.isFinished())
+    {
+        benchmark.beginFrame(camera);
+
+        // delta_time
+        // (the time of the path when benchmarking, so the frames are the same)
+        float current_frame_time = benchmark.isEnabled() ? benchmark.getTime() : context.getTime();
+        delta_time = current_frame_time - last_frame_time;
+        last_frame_time = current_frame_time;
+
+        if (!benchmark.isEnabled())
+        {
+            processInput(context);
+        }
+
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        frame_uniforms.view_matrix = camera.getUpdatedViewMatrix();
+        frame_uniforms.camera_pos = glm::vec4(camera.getPosition(), 1.0f);
+        frame_uniform_buffer.update(frame_uniforms);
+
+        main_shader.use();
+        vao.bind();
+
+        // the only texture bind of the frame
+        glActiveTexture(GL_TEXTURE0);
+        material_maps.bind();
+        benchmark.countStateChanges(2);
+
+        for (int i = 0; i < N_cubes; i++)
+        {
+            const int column{i % N_columns};
+            const int row{i / N_columns};
+
+            glm::mat4 model_matrix{glm::mat4(1.0f)};
+            model_matrix = glm::translate(model_matrix, glm::vec3(
+                (column - N_columns / 2) * 1.5f + 0.75f,
+                (row - N_rows / 2) * 1.5f + 0.75f,
+                -20.0f
+            ));
+            model_matrix = glm::rotate(model_matrix, current_frame_time + i, glm::vec3(1.0f, 0.3f, 0.5f));
+
+            // select the material in the texture array, no bind needed
+            const auto& material_region{texture_array_packer.getRegion(material_list[i])};
+            main_shader.set(model_matrix_uniform, model_matrix);
+            main_shader.set(material_rect_uniform, material_region.getRect());
+            main_shader.set(material_layer_uniform, static_cast<float>(material_region.layer));
+
+            glDrawArrays(
+                GL_TRIANGLES,  // we want to draw triangles
+                0,
+                Nvertices  // we want this number of vertices in total
+            );
+        }
+        benchmark.countDraws(N_cubes);
+        benchmark.endFrame(ShaderProgram::takeFrameStats());
+
+        context.endFrame();
+        GLCallCounter::endFrame();
+    }
+
+    benchmark.report();
+    GLCallCounter::report();
+
+    return 0;
+}
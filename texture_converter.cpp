@@ -0,0 +1,57 @@
+#include <iostream>
+#include <string>
+
+#include "glad/glad.h"
+#include "stb_image.h"
+
+#include "MipGenerator.hpp"
+#include "TextureContainer.hpp"
+
+// Offline tool: convert an image (PNG, JPG, ...) into a .ltx precompiled
+// texture with its mipmap chain, to be loaded with loadTextureContainer
+// usage: texture_converter <image> <rgb|rgba> <output.ltx>
+int main(int argc, char* argv[])
+{
+    if (argc != 4)
+    {
+        std::cout << "usage: " << argv[0] << " <image> <rgb|rgba> <output.ltx>" << std::endl;
+        return -1;
+    }
+
+    const std::string format_name{argv[2]};
+    if (format_name != "rgb" && format_name != "rgba")
+    {
+        std::cout << "usage: " << argv[0] << " <image> <rgb|rgba> <output.ltx>" << std::endl;
+        return -1;
+    }
+    const GLuint image_format{format_name == "rgba" ? static_cast<GLuint>(GL_RGBA) : static_cast<GLuint>(GL_RGB)};
+    const int n_channels{image_format == GL_RGBA ? 4 : 3};
+
+    // same orientation as the Texture class: OpenGL y axis starts on the bottom
+    stbi_set_flip_vertically_on_load(true);
+
+    int width{0};
+    int height{0};
+    int file_channels{0};
+    unsigned char *data = stbi_load(argv[1], &width, &height, &file_channels, n_channels);
+
+    if (data == nullptr)
+    {
+        std::cout << "Failed to load image " << argv[1] << std::endl;
+        return -1;
+    }
+
+    auto level_list{generateMipChain(data, width, height, n_channels)};
+    stbi_image_free(data);
+
+    if (!writeTextureContainer(argv[3], image_format, level_list))
+    {
+        std::cout << "Failed to write " << argv[3] << std::endl;
+        return -1;
+    }
+
+    std::cout << argv[1] << " -> " << argv[3] << ": " << width << "x" << height
+        << ", " << level_list.size() << " levels" << std::endl;
+
+    return 0;
+}